@@ -2,4 +2,6 @@ mkdir build
 cd build
 cmake -G "Ninja" -DCMAKE_BUILD_TYPE=Release ..
 cmake --build .
+./MeshCooker
+./AssetBaker
 read -p "Press enter to continue"
\ No newline at end of file
@@ -8,19 +8,21 @@
 
 #version 460 core
 
+#include "uniformBlocks.glsl"
+
 in vec3 fWorldPosition;
 in vec3 fPosition;
 in mat3 modelMat3;
 in vec4 fragPosLightSpace;
 
 uniform sampler2D ringDiffuse;
-uniform sampler2D shadowMap;
-uniform float farPlane;
-uniform float bias; // For shadows
+uniform sampler2DArray shadowMap; // One layer per scene component, see light.shadowLayer
+uniform float bias; // For shadows, in units of distance from the sun
 uniform float earthSizeCoefficient;
 uniform bool isUseToneMapping;
 uniform bool isNearbyPlanetaryRing;
 uniform bool isUseSphereIntersect;
+uniform int eclipseCaster; // Index of the parent body in light.eclipseCasters, -1 if it is not one
 
 uniform vec3 ringParentPlanetCenter; // Center of parent planet with planetary ring in eye space
 uniform float ringParentPlanetRadiusSquared;
@@ -235,14 +237,14 @@ float CalculateShadow(vec4 fragPosLightSpace) {
     projCoords = projCoords * 0.5 + 0.5;
 
     // Get closest depth value from light's perspective (using [0,1] range fragPosLight as coords)
-    float closestDepth = texture(shadowMap, projCoords.xy).r;
+    float closestDepth = texture(shadowMap, vec3(projCoords.xy, light.shadowLayer)).r;
 
     // Get depth of current fragment from light's perspective
     float currentDepth = projCoords.z;
     vec3 lightDir = normalize(lightPos - fWorldPosition);
 
     // Check whether current frag pos is in shadow
-    float shadow = currentDepth - bias > closestDepth ? 1.0 : 0.0;
+    float shadow = currentDepth - ShadowDepthBias(bias) > closestDepth ? 1.0 : 0.0;
 
     if (isNearbyPlanetaryRing) {
         if (isUseSphereIntersect && intersectSphere(normalize(lightPos - modelMat3 * fPosition)))
@@ -258,7 +260,7 @@ float CalculateShadow(vec4 fragPosLightSpace) {
         if (intersectDisk(correctRingNormal, ringCenter, ringInnerOuterRadiuses.y, fWorldPosition, lightDir, intersectSquared)) {
             if (intersectSquared > ringInnerOuterRadiuses.x) {
                 // If some planet obscures the ring
-                if (shadow > 0.0 && length(lightPos - ringCenter) - (closestDepth - bias) * farPlane > ringInnerOuterRadiuses.y) {
+                if (shadow > 0.0 && length(lightPos - ringCenter) - ShadowDepthToDistance(closestDepth) + bias > ringInnerOuterRadiuses.y) {
                     return shadow;
                 }
 
@@ -284,11 +286,13 @@ float criticalLengthFactor() {
 }
 
 void main() {
-    float shadow = CalculateShadow(fragPosLightSpace);
+    float shadow = light.shadowLayer < 0 ? 0.0 : CalculateShadow(fragPosLightSpace);
 
     if (shadow > 0.0)
         discard;
 
+    float eclipseLight = EclipseLight(fWorldPosition, eclipseCaster);
+
     vec3 eye = camPosition;
     float eyeLength = length(eye);
     float eyeCriticalLengthFactor = criticalLengthFactor();
@@ -310,7 +314,7 @@ void main() {
 
     vec3 I = colorInScatter(eye, dir, e, l);
 
-    fragColor = vec4(I /** (1.0 - shadow)*/, 1.0);
+    fragColor = vec4(I * eclipseLight, 1.0);
 
     if (isUseToneMapping)
         fragColor.rgb = acesFilm(fragColor.rgb);
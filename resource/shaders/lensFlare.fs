@@ -1,11 +1,12 @@
 #version 460 core
 
+#include "uniformBlocks.glsl"
+
 uniform sampler2D lensTexture;
 uniform vec3 color;
 
 uniform bool isPlanetaryRingInView;
 
-uniform vec3 cameraPosition;
 uniform vec3 ringCenter; // Center of disk in eye space
 uniform vec3 ringNormal; // Disk plane normal in eye space
 uniform vec2 ringInnerOuterRadiuses; // x = Inner, y = Outer
@@ -55,7 +56,7 @@ void main() {
 
         float intersectSquared;
 
-        if (intersectDisk(correctRingNormal, ringCenter, ringInnerOuterRadiuses.y, cameraPosition, normalize(fCenter - cameraPosition), intersectSquared)) {
+        if (intersectDisk(correctRingNormal, ringCenter, ringInnerOuterRadiuses.y, frame.cameraPosition, normalize(fCenter - frame.cameraPosition), intersectSquared)) {
             if (intersectSquared > ringInnerOuterRadiuses.x) {
                 float u = (intersectSquared - ringInnerOuterRadiuses.x) / (ringInnerOuterRadiuses.y - ringInnerOuterRadiuses.x);
                 vec4 ringColor = texture(ringDiffuse, vec2(u, 0));
@@ -1,11 +1,11 @@
 #version 460 core
 
+#include "uniformBlocks.glsl"
+
 layout (location = 0) in vec2 aPos;
 layout (location = 1) in vec2 aTexCoords;
 layout (location = 2) in float aOffset;
 
-uniform mat4 projection;
-uniform mat4 view;
 uniform vec3 center;
 uniform vec2 dims;
 uniform float intensity;
@@ -21,7 +21,7 @@ void main() {
     fUV = aTexCoords;
     // Fixed size billboard
     // Get the screen-space position of the center
-    gl_Position = projection * view * vec4(center, 1.0);
+    gl_Position = frame.projection * frame.view * vec4(center, 1.0);
     gl_Position /= gl_Position.w;
     vec2 centerPos = gl_Position.xy;
     vec2 offsetVec = vec2(0.0) - centerPos;
@@ -0,0 +1,30 @@
+// Tiling gradient noise baked into a 3D texture at startup (see NoiseVolume), four independent fields in rgba.
+// Positions are in lattice cells like for snoise, the texture repeats every noisePeriod cells.
+// The 4D noise of the procedural version is replaced by a drift of the 3D position along W_AXIS
+const vec3 W_AXIS = vec3(0.48, 0.64, 0.6);
+
+uniform sampler3D noiseVolume;
+uniform float noisePeriod;
+uniform float noiseTime; // Seconds, advanced at a fixed rate and not every frame (see starNoiseUpdateRate in Application.h)
+uniform bool isBakedNoise;
+
+vec4 VolumeNoise4(vec3 position) {
+    return texture(noiseVolume, position / noisePeriod);
+}
+
+vec4 VolumeNoise4(vec3 position, float w) {
+    return VolumeNoise4(position + w * W_AXIS);
+}
+
+float VolumeFbm(vec3 position, int octaves, float frequency, float persistence) {
+    float total = 0.0;
+    float maxAmplitude = 0.0;
+    float amplitude = 1.0;
+    for (int i = 0; i < octaves; i++) {
+        total += VolumeNoise4(position * frequency).r * amplitude;
+        frequency *= 2.0;
+        maxAmplitude += amplitude;
+        amplitude *= persistence;
+    }
+    return total / maxAmplitude;
+}
\ No newline at end of file
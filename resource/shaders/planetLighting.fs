@@ -1,47 +1,72 @@
 #version 460 core
 
+#include "uniformBlocks.glsl"
+#include "shadowSampling.glsl"
+
 in VS_OUT {
     vec3 FragPos;
+#ifdef IMPOSTOR
+    flat vec4 Sphere;
+    flat mat3 Rotation;
+#else
     vec2 TexCoords;
     vec3 TangentLightPos;
     vec3 TangentViewPos;
     vec3 TangentFragPos;
     vec4 FragPosLightSpace;
+#endif
+    flat uint MaterialIndex;
+    flat int EclipseCaster;
+#ifdef INSTANCED
+    flat uvec3 SurfaceLayers;
+    flat uint LightIndex;
+#endif
 } fs_in;
 
+// Surface point of the fragment, interpolated over the mesh or ray traced on the impostor
+vec3 fragPos;
+vec2 texCoords;
+vec3 tangentLightPos;
+vec3 tangentViewPos;
+vec3 tangentFragPos;
+vec4 fragPosLightSpace;
+
+#ifdef IMPOSTOR
+const float PI = 3.14159265359;
+
+uniform vec3 sphereUvMapping; // x = u sign, y = u offset, z = v sign (see SphereUvMapping)
+
+vec2 texCoordsDx, texCoordsDy; // Implicit derivatives would pick the smallest mip level along the seam of the computed u
+#define SAMPLE(map, coords) textureGrad(map, coords, texCoordsDx, texCoordsDy)
+#else
+#define SAMPLE(map, coords) texture(map, coords)
+#endif
+
+#ifdef INSTANCED
+uniform sampler2DArray mainDiffuseTexture;
+uniform sampler2DArray normalMap;
+uniform sampler2DArray specularMap;
+#define SAMPLE_SURFACE(map, layer) SAMPLE(map, vec3(texCoords, float(fs_in.SurfaceLayers.layer)))
+#else
 uniform sampler2D mainDiffuseTexture;
-uniform sampler2D cloudTexture;
-uniform sampler2D nightTexture;
 uniform sampler2D normalMap;
 uniform sampler2D specularMap;
-uniform sampler2D ringDiffuse;
-uniform sampler2D shadowMap;
-
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 starGlowTint;
+#define SAMPLE_SURFACE(map, layer) SAMPLE(map, texCoords)
+#endif
+uniform sampler2D cloudTexture;
+uniform sampler2D nightTexture;
+uniform sampler2D ringDiffuse; // Of the ring in light, if it has one
+uniform sampler2DArray shadowMap; // One layer per scene component, see light.shadowLayer. Raw depth, PCF uses shadowMapCompare
 
-uniform float farPlane;
-uniform float ambientFactor;
-uniform float bias; // For shadows
+uniform float bias; // For shadows, in units of distance from the sun
 uniform float yRotation; // For fake cloud shadows
 
-uniform bool hasNightTexture;
-uniform bool hasSpecularMap;
-uniform bool hasSpecular;
-uniform bool hasClouds;
-uniform bool isNearbyPlanetaryRing;
-uniform bool isUseSphereIntersect; // To avoid the ring shadow while behind a planet (parent planet with rings)
-
-uniform vec3 parentPlanetCenter; // Center of parent planet with planetary ring in eye space
-uniform float parentPlanetRadiusSquared;
-
-uniform vec3 ringCenter; // Center of disk in eye space
-uniform vec3 ringNormal; // Disk plane normal in eye space
-uniform vec2 ringInnerOuterRadiuses; // x = Inner, y = Outer
-
 out vec4 fragColor;
 
+bool hasMaterialFlag(uint flag) {
+    return (materials[fs_in.MaterialIndex].flags & flag) != 0u;
+}
+
 void swap(out float left, out float right) {
     float temp = left;
     left = right;
@@ -74,10 +99,10 @@ bool intersectSphere(vec3 dir) {
     float t0, t1;
 
     // Analytic solution
-    vec3 L = fs_in.FragPos - parentPlanetCenter;
+    vec3 L = fragPos - light.parentPlanetCenter;
     float a = dot(dir, dir);
     float b = 2 * dot(dir, L);
-    float c = dot(L, L) - parentPlanetRadiusSquared;
+    float c = dot(L, L) - light.parentPlanetRadiusSquared;
 
     if (!solveQuadratic(a, b, c, t0, t1))
         return false;
@@ -121,44 +146,6 @@ bool intersectDisk(vec3 n, vec3 p0, float radius, vec3 l0, vec3 l, out float int
     return false;
 }
 
-// https://www.youtube.com/watch?v=yn5UJzMqxj0
-float SampleShadowMap(vec2 coords, float compare) {
-    return step(compare, texture(shadowMap, coords).r);
-}
-
-float SampleShadowMapLinear(vec2 coords, float compare, vec2 texelSize) {
-    vec2 pixelPos = coords / texelSize + vec2(0.5);
-    vec2 fracPart = fract(pixelPos);
-    vec2 startTexel = (pixelPos - fracPart) * texelSize;
-
-    float blTexel = SampleShadowMap(startTexel, compare);
-    float brTexel = SampleShadowMap(startTexel + vec2(texelSize.x, 0.0), compare);
-    float tlTexel = SampleShadowMap(startTexel + vec2(0.0, texelSize.y), compare);
-    float trTexel = SampleShadowMap(startTexel + texelSize, compare);
-
-    float mixA = mix(blTexel, tlTexel, fracPart.y);
-    float mixB = mix(brTexel, trTexel, fracPart.y);
-
-    return mix(mixA, mixB, fracPart.x);
-}
-
-void ApplyPCF(out float shadow, vec3 projCoords, float currentDepth) {
-    const float NUM_SAMPLES = 3.0; // Change this (lower to increase fps or higher to increase softening)
-    const float SAMPLES_START = (NUM_SAMPLES - 1.0) / 2.0;
-    const float NUM_SAMPLES_SQUARED = NUM_SAMPLES * NUM_SAMPLES;
-
-    shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
-
-    for(float y = -SAMPLES_START; y <= SAMPLES_START; y += 1.0) {
-        for(float x = -SAMPLES_START; x <= SAMPLES_START; x += 1.0) {
-            shadow += SampleShadowMapLinear(projCoords.xy + vec2(x, y) * texelSize, currentDepth - bias, texelSize);
-        }
-    }
-
-    shadow /= NUM_SAMPLES_SQUARED;
-}
-
 float CalculateShadow(vec4 fragPosLightSpace) {
     // Perform perspective divide
     vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
@@ -167,79 +154,135 @@ float CalculateShadow(vec4 fragPosLightSpace) {
     projCoords = projCoords * 0.5 + 0.5;
 
     // Get closest depth value from light's perspective (using [0,1] range fragPosLight as coords)
-    float closestDepth = texture(shadowMap, projCoords.xy).r;
+    float closestDepth = texture(shadowMap, vec3(projCoords.xy, light.shadowLayer)).r;
 
     // Get depth of current fragment from light's perspective
     float currentDepth = projCoords.z;
-    vec3 lightDir = lightPos - fs_in.FragPos;
+    vec3 lightDir = frame.lightPosition - fragPos;
     vec3 lightDirNorm = normalize(lightDir);
 
-    float shadow = currentDepth - bias > closestDepth ? 1.0 : 0.0;
+    float shadow = currentDepth - ShadowDepthBias(bias) > closestDepth ? 1.0 : 0.0;
 
-    if (isNearbyPlanetaryRing) {
-        if (isUseSphereIntersect && intersectSphere(normalize(lightPos - fs_in.FragPos))) // Behind the parent planet with rings (to avoid shadow from the ring)
+    if (light.hasRing) {
+        if (hasMaterialFlag(MATERIAL_USE_SPHERE_INTERSECT) && intersectSphere(normalize(frame.lightPosition - fragPos))) // Behind the parent planet with rings (to avoid shadow from the ring)
             return 0.0;
 
         float intersectSquared;
-        float NdotL = dot(ringNormal, lightDirNorm);
-        vec3 correctRingNormal = ringNormal;
+        float NdotL = dot(light.ringNormal, lightDirNorm);
+        vec3 correctRingNormal = light.ringNormal;
 
         if (NdotL < 0.0)
-            correctRingNormal = -ringNormal;
+            correctRingNormal = -light.ringNormal;
 
-        if (intersectDisk(correctRingNormal, ringCenter, ringInnerOuterRadiuses.y, fs_in.FragPos, lightDirNorm, intersectSquared)) {
-            if (intersectSquared > ringInnerOuterRadiuses.x) {
+        if (intersectDisk(correctRingNormal, light.ringCenter, light.ringOuterRadius, fragPos, lightDirNorm, intersectSquared)) {
+            if (intersectSquared > light.ringInnerRadius) {
                 // If some planet obscures the ring
-                if (shadow > 0.0 && length(lightPos - ringCenter) - closestDepth * farPlane > ringInnerOuterRadiuses.y) {
+                if (shadow > 0.0 && length(frame.lightPosition - light.ringCenter) - ShadowDepthToDistance(closestDepth) > light.ringOuterRadius) {
                     // PCF won't work, because physically in the place where the penumbra from the PCF should be, there will be a shadow from the ring, and not from the planet
                     // ApplyPCF(shadow, projCoords, currentDepth);
                     return 1.0 - shadow;
                 }
 
                 // Very high quality shadow from the ring with alpha blending
-                float u = (intersectSquared - ringInnerOuterRadiuses.x) / (ringInnerOuterRadiuses.y - ringInnerOuterRadiuses.x);
+                float u = (intersectSquared - light.ringInnerRadius) / (light.ringOuterRadius - light.ringInnerRadius);
                 vec4 ringColor = texture(ringDiffuse, vec2(u, 0));
                 return 1.0 - (ringColor.r + ringColor.g + ringColor.b) * ringColor.a;
             }
         }
     }
 
-    ApplyPCF(shadow, projCoords, currentDepth);
-    return shadow;
+    return SampleShadowPCF(projCoords.xy, currentDepth - ShadowDepthBias(bias), 1.5);
 }
 
+#ifdef IMPOSTOR
+// Ray traces the sphere of the impostor and fills the surface point as the vertex shader does for meshes. Returns false for a miss
+bool ComputeImpostorSurface() {
+    vec3 center = fs_in.Sphere.xyz;
+    vec3 rayDir = normalize(fs_in.FragPos - frame.cameraPosition);
+    vec3 centerToCamera = frame.cameraPosition - center;
+    float b = dot(centerToCamera, rayDir);
+    float h = b * b - dot(centerToCamera, centerToCamera) + fs_in.Sphere.w * fs_in.Sphere.w;
+
+    // The derivatives below need all pixels of the quad, so a miss is discarded only after them
+    fragPos = frame.cameraPosition + rayDir * (-b - sqrt(max(h, 0.0)));
+    vec3 N = normalize(fragPos - center);
+    vec3 direction = transpose(fs_in.Rotation) * N; // In model space
+    float longitude = atan(-direction.z, direction.x);
+    float latitude = asin(clamp(direction.y, -1.0, 1.0));
+
+    float u = sphereUvMapping.x * longitude / (2.0 * PI) + sphereUvMapping.y;
+    texCoords = vec2(fract(u), 0.5 - sphereUvMapping.z * latitude / PI);
+
+    // Gradients of u are taken from whichever of u and u shifted by a half has no seam between the pixels
+    float shiftedU = fract(u + 0.5) - 0.5;
+    bool isNearSeam = fwidth(texCoords.x) > fwidth(shiftedU);
+    texCoordsDx = vec2(isNearSeam ? dFdx(shiftedU) : dFdx(texCoords.x), dFdx(texCoords.y));
+    texCoordsDy = vec2(isNearSeam ? dFdy(shiftedU) : dFdy(texCoords.x), dFdy(texCoords.y));
+
+    vec3 T = fs_in.Rotation * (sphereUvMapping.x * vec3(-sin(longitude), 0.0, -cos(longitude)));
+    vec3 B = cross(N, T);
+    mat3 TBN = transpose(mat3(T, B, N));
+
+    tangentLightPos = TBN * frame.lightPosition;
+    tangentViewPos = TBN * frame.cameraPosition;
+    tangentFragPos = TBN * fragPos;
+    fragPosLightSpace = light.lightSpaceMatrix * vec4(fragPos, 1.0);
+
+    // Log z-buffer, as for meshes [логарифмический z-буфер]
+    float viewDepth = -(frame.view * vec4(fragPos, 1.0)).z;
+    gl_FragDepth = log2(max(1e-6, viewDepth + 1.0)) * frame.zCoef * 0.5;
+    return h >= 0.0;
+}
+#endif
+
 void main() {
+#ifdef INSTANCED
+    light = lights[fs_in.LightIndex];
+#endif
+#ifdef IMPOSTOR
+    if (!ComputeImpostorSurface())
+        discard;
+#else
+    fragPos = fs_in.FragPos;
+    texCoords = fs_in.TexCoords;
+    tangentLightPos = fs_in.TangentLightPos;
+    tangentViewPos = fs_in.TangentViewPos;
+    tangentFragPos = fs_in.TangentFragPos;
+    fragPosLightSpace = fs_in.FragPosLightSpace;
+#endif
+
     vec3 diffuseColor, specular;
 
-    diffuseColor = texture(mainDiffuseTexture, fs_in.TexCoords).rgb;
+    diffuseColor = SAMPLE_SURFACE(mainDiffuseTexture, x).rgb;
 
-    vec3 normal = texture(normalMap, fs_in.TexCoords).rgb;
+    vec3 normal = SAMPLE_SURFACE(normalMap, y).rgb;
     normal = normalize(normal * 2.0 - 1.0);
 
-    vec3 lightDir = normalize(fs_in.TangentLightPos - fs_in.TangentFragPos);
+    vec3 lightDir = normalize(tangentLightPos - tangentFragPos);
 
     float NdotL = dot(normal, lightDir);
 
-    if (hasClouds) {
-        vec2 cloudTexCoord = fs_in.TexCoords - vec2(yRotation / 360.0, 0);
-        vec3 cloudColor = texture(cloudTexture, cloudTexCoord).rgb;
+    if (hasMaterialFlag(MATERIAL_HAS_CLOUDS)) {
+        vec2 cloudTexCoord = texCoords - vec2(yRotation / 360.0, 0);
+        vec3 cloudColor = SAMPLE(cloudTexture, cloudTexCoord).rgb;
         diffuseColor -= cloudColor * 0.5;
     }
 
-    if (hasNightTexture) {
-        vec3 nightColor = texture(nightTexture, fs_in.TexCoords).rgb;
+    if (hasMaterialFlag(MATERIAL_HAS_NIGHT_TEXTURE)) {
+        vec3 nightColor = SAMPLE(nightTexture, texCoords).rgb;
         float dayNightAlpha = smoothstep(-0.15, 0.15, NdotL);
         diffuseColor = mix(nightColor, diffuseColor, dayNightAlpha);
     }
 
-    vec3 ambient = ambientFactor * diffuseColor;
+    vec3 ambient = materials[fs_in.MaterialIndex].ambientFactor * diffuseColor;
 
     float diff = max(dot(lightDir, normal), 0.0);
     diffuseColor *= diff;
 
+    bool hasSpecular = hasMaterialFlag(MATERIAL_HAS_SPECULAR);
     float spec;
     if (hasSpecular) {
-        vec3 viewDir = normalize(fs_in.TangentViewPos - fs_in.TangentFragPos);
+        vec3 viewDir = normalize(tangentViewPos - tangentFragPos);
         vec3 reflectDir = reflect(-lightDir, normal);
         vec3 halfwayDir = normalize(lightDir + viewDir);
         spec = pow(max(dot(normal, halfwayDir), 0.0), 32.0);
@@ -247,15 +290,15 @@ void main() {
         spec = mix(0.0, spec, specularMix) * 0.675;
     }
 
-    if (hasSpecularMap) {
-        vec4 specularMapColor = texture(specularMap, fs_in.TexCoords);
-        specular = specularMapColor.rrr * specularMapColor.a * spec * starGlowTint;
+    if (hasMaterialFlag(MATERIAL_HAS_SPECULAR_MAP)) {
+        vec4 specularMapColor = SAMPLE_SURFACE(specularMap, z);
+        specular = specularMapColor.rrr * specularMapColor.a * spec * frame.starGlowTint;
     }
     else {
-        specular = spec * starGlowTint;
+        specular = spec * frame.starGlowTint;
     }
 
-    float shadow = CalculateShadow(fs_in.FragPosLightSpace);
+    float shadow = (light.shadowLayer < 0 ? 1.0 : CalculateShadow(fragPosLightSpace)) * EclipseLight(fragPos, fs_in.EclipseCaster);
 
     if (shadow < 0.05)
         ambient *= 0.1;
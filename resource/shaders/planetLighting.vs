@@ -1,5 +1,7 @@
 #version 460 core
 
+#include "uniformBlocks.glsl"
+
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
@@ -8,24 +10,63 @@ layout (location = 4) in vec3 aBitangent;
 
 out VS_OUT {
     vec3 FragPos;
+#ifdef IMPOSTOR
+    flat vec4 Sphere; // Center and radius in world space
+    flat mat3 Rotation; // From model space to world space, without the scale
+#else
     vec2 TexCoords;
     vec3 TangentLightPos;
     vec3 TangentViewPos;
     vec3 TangentFragPos;
     vec4 FragPosLightSpace;
+#endif
+    flat uint MaterialIndex;
+    flat int EclipseCaster;
+#ifdef INSTANCED
+    flat uvec3 SurfaceLayers; // Layers of the diffuse, normal and specular maps in their texture arrays
+    flat uint LightIndex;
+#endif
 } vs_out;
 
-uniform mat4 projection;
-uniform mat4 view;
+#ifndef INSTANCED
 uniform mat4 model;
-uniform mat4 lightSpaceMatrix;
-
-uniform vec3 lightPos;
-uniform vec3 viewPos;
+uniform int eclipseCaster; // Index of the body in light.eclipseCasters, -1 if it is not one
+#endif
 
-uniform float zCoef; // For log z-buffer (2.0 / log2(farPlane + 1.0))
+#ifdef IMPOSTOR
+const float SPHERE_MODEL_RADIUS = 2.0; // Radius of the earth 3d model in Blender (see SphereLodChain)
+#endif
 
 void main() {
+#ifdef INSTANCED
+    InstanceRecord instance = instances[gl_BaseInstance + gl_InstanceID];
+    light = lights[instance.lightIndex];
+    mat4 model = instance.model;
+    vs_out.MaterialIndex = instance.materialIndex;
+    vs_out.EclipseCaster = instance.eclipseCaster;
+    vs_out.SurfaceLayers = uvec3(instance.diffuseLayer, instance.normalLayer, instance.specularLayer);
+    vs_out.LightIndex = instance.lightIndex;
+#else
+    vs_out.MaterialIndex = gl_BaseInstance;
+    vs_out.EclipseCaster = eclipseCaster;
+#endif
+#ifdef IMPOSTOR
+    // The quad is turned to the camera in the plane through the center and sized to cover the cone of rays which touch the sphere
+    float scale = length(vec3(model[0]));
+    vec3 center = vec3(model[3]);
+    float radius = SPHERE_MODEL_RADIUS * scale;
+
+    vec3 toCamera = frame.cameraPosition - center;
+    float cameraDistance = length(toCamera);
+    vec3 forward = toCamera / cameraDistance;
+    vec3 right = normalize(cross(abs(forward.y) < 0.999 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0), forward));
+    vec3 up = cross(forward, right);
+    float halfSize = radius * cameraDistance / sqrt(max(cameraDistance * cameraDistance - radius * radius, 1e-6));
+
+    vs_out.FragPos = center + (right * aPos.x + up * aPos.y) * halfSize;
+    vs_out.Sphere = vec4(center, radius);
+    vs_out.Rotation = mat3(model) / scale;
+#else
     vs_out.FragPos = vec3(model * vec4(aPos, 1.0));
     vs_out.TexCoords = aTexCoords;
 
@@ -37,14 +78,15 @@ void main() {
 
     mat3 TBN = transpose(mat3(T, B, N));
 
-    vs_out.TangentLightPos = TBN * lightPos;
-    vs_out.TangentViewPos  = TBN * viewPos;
+    vs_out.TangentLightPos = TBN * frame.lightPosition;
+    vs_out.TangentViewPos  = TBN * frame.cameraPosition;
     vs_out.TangentFragPos  = TBN * vs_out.FragPos;
-    vs_out.FragPosLightSpace = lightSpaceMatrix * vec4(vs_out.FragPos, 1.0);
+    vs_out.FragPosLightSpace = light.lightSpaceMatrix * vec4(vs_out.FragPos, 1.0);
+#endif
 
-    gl_Position = projection * view * vec4(vs_out.FragPos, 1.0f);
+    gl_Position = frame.projection * frame.view * vec4(vs_out.FragPos, 1.0f);
 
     // Log z-buffer [логарифмический z-буфер]
-    gl_Position.z = log2(max(1e-6, gl_Position.w + 1.0)) * zCoef - 1.0;
+    gl_Position.z = log2(max(1e-6, gl_Position.w + 1.0)) * frame.zCoef - 1.0;
     gl_Position.z *= gl_Position.w;
 }
\ No newline at end of file
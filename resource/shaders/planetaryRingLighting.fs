@@ -1,17 +1,14 @@
 #version 460 core
 
+#include "uniformBlocks.glsl"
+#include "shadowSampling.glsl"
+
 uniform sampler2D ringTexture;
-uniform sampler2D shadowMap;
 
-uniform vec3 lightPos;
 uniform vec3 planetPos;
-uniform vec3 starGlowTint;
 
 uniform float planetRadius;
-uniform float zCoef;
-uniform float bias; // For shadows
-
-uniform vec3 camPos;
+uniform float bias; // For shadows, in units of distance from the sun
 
 in vec3 fPosition;
 in vec3 normal;
@@ -68,44 +65,6 @@ float sphereIntersectAmount(vec3 raydir, vec3 rayorig, vec3 pos, float rad) {
     return distanceToSphere - rad;
 }
 
-// https://www.youtube.com/watch?v=yn5UJzMqxj0
-float SampleShadowMap(vec2 coords, float compare) {
-    return step(compare, texture(shadowMap, coords).r);
-}
-
-float SampleShadowMapLinear(vec2 coords, float compare, vec2 texelSize) {
-    vec2 pixelPos = coords / texelSize + vec2(0.5);
-    vec2 fracPart = fract(pixelPos);
-    vec2 startTexel = (pixelPos - fracPart) * texelSize;
-
-    float blTexel = SampleShadowMap(startTexel, compare);
-    float brTexel = SampleShadowMap(startTexel + vec2(texelSize.x, 0.0), compare);
-    float tlTexel = SampleShadowMap(startTexel + vec2(0.0, texelSize.y), compare);
-    float trTexel = SampleShadowMap(startTexel + texelSize, compare);
-
-    float mixA = mix(blTexel, tlTexel, fracPart.y);
-    float mixB = mix(brTexel, trTexel, fracPart.y);
-
-    return mix(mixA, mixB, fracPart.x);
-}
-
-void ApplyPCF(out float shadow, vec3 projCoords, float currentDepth) {
-    const float NUM_SAMPLES = 3.0; // Change this (lower to increase fps or higher to increase softening)
-    const float SAMPLES_START = (NUM_SAMPLES - 1.0) / 2.0;
-    const float NUM_SAMPLES_SQUARED = NUM_SAMPLES * NUM_SAMPLES;
-
-    shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
-
-    for(float y = -SAMPLES_START; y <= SAMPLES_START; y += 1.0) {
-        for(float x = -SAMPLES_START; x <= SAMPLES_START; x += 1.0) {
-            shadow += SampleShadowMapLinear(projCoords.xy + vec2(x, y) * texelSize, currentDepth - bias, texelSize);
-        }
-    }
-
-    shadow /= NUM_SAMPLES_SQUARED;
-}
-
 float CalculateShadow(vec4 fragPosLightSpace) {
     // Perform perspective divide
     vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
@@ -113,22 +72,11 @@ float CalculateShadow(vec4 fragPosLightSpace) {
     // Transform to [0,1] range
     projCoords = projCoords * 0.5 + 0.5;
 
-    // Get closest depth value from light's perspective (using [0,1] range fragPosLight as coords)
-    float closestDepth = texture(shadowMap, projCoords.xy).r;
-
-    // Get depth of current fragment from light's perspective
-    float currentDepth = projCoords.z;
-    vec3 lightDir = normalize(lightPos - fWorldPosition);
-
-    // Check whether current frag pos is in shadow
-    float shadow;
-
-    ApplyPCF(shadow, projCoords, currentDepth);
-    return shadow;
+    return SampleShadowPCF(projCoords.xy, projCoords.z - ShadowDepthBias(bias), 1.5);
 }
 
 void main() {
-    gl_FragDepth = log2(fLogZ) * zCoef * 0.5;
+    gl_FragDepth = log2(fLogZ) * frame.zCoef * 0.5;
 
     vec4 ringColor = texture(ringTexture, texCoords);
 
@@ -136,7 +84,7 @@ void main() {
         discard;
 
     const float smoothingAmount = 0.0001;
-    float shadow = clamp(-sphereIntersectAmount(normalize(fWorldPosition - lightPos), fWorldPosition, planetPos, planetRadius) / smoothingAmount, 0.0, 1.0);
+    float shadow = clamp(-sphereIntersectAmount(normalize(fWorldPosition - frame.lightPosition), fWorldPosition, planetPos, planetRadius) / smoothingAmount, 0.0, 1.0);
 
     if (shadow > 0.0) { // The ring is obscured by the parent planet
         ringColor.rgb *= 1.0 - shadow;
@@ -144,9 +92,9 @@ void main() {
         return;
     }
 
-    float NdotL = dot(normal, normalize(lightPos - planetPos));
+    float NdotL = dot(normal, normalize(frame.lightPosition - planetPos));
 
-    shadow = CalculateShadow(fragPosLightSpace);
+    shadow = (light.shadowLayer < 0 ? 1.0 : CalculateShadow(fragPosLightSpace)) * EclipseLight(fWorldPosition, -1);
     ringColor.rgb *= shadow;
 
     if (NdotL < 0 && shadow != 0.0) {
@@ -162,7 +110,7 @@ void main() {
         const float g2 = g * g;
         const float k = 1.5 / 806.202 * ((1.0 - g2) / (2.0 + g2));
         float backLit0 = 12.0 * k * (1.0 + Cos0 * Cos0) * pow(1.0 + g2 - 2.0 * g * Cos0, -1.5);
-        ringColor.rgb *= backLit0 * starGlowTint * starGlowTint; // Star glow tint^2
+        ringColor.rgb *= backLit0 * frame.starGlowTint * frame.starGlowTint; // Star glow tint^2
     }
 
     fragColor = ringColor;
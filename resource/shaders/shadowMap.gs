@@ -0,0 +1,18 @@
+#version 460 core
+
+// Routes the triangles of the layered shadow pass to their layers, when the driver cannot set gl_Layer in the vertex shader
+
+layout (triangles) in;
+layout (triangle_strip, max_vertices = 3) out;
+
+flat in int Layer[];
+
+void main() {
+    for (int i = 0; i < 3; i++) {
+        gl_Layer = Layer[0];
+        gl_Position = gl_in[i].gl_Position;
+        EmitVertex();
+    }
+
+    EndPrimitive();
+}
\ No newline at end of file
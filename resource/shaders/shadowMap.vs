@@ -1,10 +1,33 @@
 #version 460 core
 
+#ifdef VERTEX_LAYER
+#extension GL_ARB_shader_viewport_layer_array : require
+#endif
+
+#include "uniformBlocks.glsl"
+
 layout (location = 0) in vec3 aPos;
 
-uniform mat4 lightSpaceMatrix;
+#ifdef INSTANCED
+// Casters of all refreshed components are drawn in one pass, each into the layer of its component. For shadow casters the record holds
+// the matrix from model space to the light clip space of the layer, and the layer instead of a material (see InstanceBatcher::AddShadowCaster)
+#ifndef VERTEX_LAYER
+flat out int Layer; // Set by shadowMap.gs
+#endif
+
+void main() {
+    InstanceRecord instance = instances[gl_BaseInstance + gl_InstanceID];
+    gl_Position = instance.model * vec4(aPos, 1.0);
+#ifdef VERTEX_LAYER
+    gl_Layer = int(instance.materialIndex);
+#else
+    Layer = int(instance.materialIndex);
+#endif
+}
+#else
 uniform mat4 model;
 
 void main() {
-    gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
-}
\ No newline at end of file
+    gl_Position = light.lightSpaceMatrix * model * vec4(aPos, 1.0);
+}
+#endif
\ No newline at end of file
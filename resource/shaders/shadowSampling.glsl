@@ -0,0 +1,26 @@
+// Percentage closer filtering of the shadow map array. The samples are compared by the hardware (see ShadowMapFBO::GetCompareSampler),
+// each tap is a bilinear compare of 4 texels. Include after uniformBlocks.glsl
+
+#ifndef SHADOW_TAPS
+#define SHADOW_TAPS 8 // Set by Application, lower to increase fps or higher to increase softening
+#endif
+
+uniform sampler2DArrayShadow shadowMapCompare; // The same texture as shadowMap with GL_TEXTURE_COMPARE_MODE
+
+// The taps lie on a golden angle spiral, which covers the disc evenly for any tap count like a Poisson disc.
+// The spiral is rotated per pixel, so the few taps give noise instead of banding
+float SampleShadowPCF(vec2 coords, float compare, float radiusInTexels) {
+    const float GOLDEN_ANGLE = 2.39996323;
+
+    vec2 radius = radiusInTexels / vec2(textureSize(shadowMapCompare, 0).xy);
+    float rotation = 6.28318530718 * fract(52.9829189 * fract(dot(gl_FragCoord.xy, vec2(0.06711056, 0.00583715)))); // Interleaved gradient noise
+    float lit = 0.0;
+
+    for (int i = 0; i < SHADOW_TAPS; i++) {
+        float angle = rotation + float(i) * GOLDEN_ANGLE;
+        vec2 offset = sqrt((float(i) + 0.5) / float(SHADOW_TAPS)) * vec2(cos(angle), sin(angle));
+        lit += texture(shadowMapCompare, vec4(coords + offset * radius, light.shadowLayer, compare));
+    }
+
+    return lit / float(SHADOW_TAPS);
+}
\ No newline at end of file
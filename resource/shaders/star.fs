@@ -1,5 +1,7 @@
 #version 460 core
 
+#include "noiseVolume.glsl"
+
 vec3 mod2893(vec3 x) {
     return x - floor(x * (1.0 / 289.0)) * 289.0;
 }
@@ -158,11 +160,20 @@ void main() {
     // Sunspots
     float s = 0.3;
     float frequency = 0.00001;
-    float t1 = snoise(sPosition * frequency) - s;
-    float t2 = snoise((sPosition + starRadiusInKilometers) * frequency) - s;
+    float t1, t2, n;
+    if (isBakedNoise) { // Two fields of one fetch instead of the shifted positions
+        vec2 spots = VolumeNoise4(sPosition * frequency).rg;
+        t1 = spots.x - s;
+        t2 = spots.y - s;
+        n = (VolumeFbm(position, 4, 40.0, 0.7) + 1.0) * 0.5;
+    }
+    else {
+        t1 = snoise(sPosition * frequency) - s;
+        t2 = snoise((sPosition + starRadiusInKilometers) * frequency) - s;
+        n = (noise(position, 4, 40.0, 0.7) + 1.0) * 0.5;
+    }
     float ss = (max(t1, 0.0) * max(t2, 0.0)) * 2.0;
 
-    float n = (noise(position, 4, 40.0, 0.7) + 1.0) * 0.5;
     float totalNoise = n - ss;
 
     vec3 colorByTemperature = texture(colorMap, vec2(uColorMap, 0)).rgb;
@@ -1,5 +1,8 @@
 #version 460 core
 
+#include "uniformBlocks.glsl"
+#include "noiseVolume.glsl"
+
 vec4 mod289(vec4 x) {
     return x - floor(x * (1.0 / 289.0)) * 289.0;
 }
@@ -189,7 +192,6 @@ float cubedNoise(vec4 position, int octaves, float frequency, float persistence)
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 uniform vec3 starShiftColor;
-uniform float deltaTime;
 uniform float maxSize;
 
 in vec3 fPosition;
@@ -207,20 +209,31 @@ void main() {
     const float irregularityMultiplier = 4;   // The higher the number, the more irregularities and bigger ones. (Might be more GPU intensive when higher, 4 seems fine for the normal PC)
 
     /* Don't edit these */
-    float t = deltaTime * 10.0 - length(fPosition);
+    float t = (isBakedNoise ? noiseTime : frame.time) * 0.002 * 10.0 - length(fPosition);
 
     // Offset normal with noise
-    float ox = snoise(vec4(fPosition, t) * frequency);
-    float oy = snoise(vec4((fPosition + (1000.0 * irregularityMultiplier)), t) * frequency);
-    float oz = snoise(vec4((fPosition + (2000.0 * irregularityMultiplier)), t) * frequency);
-    float om = snoise(vec4((fPosition + (4000.0 * irregularityMultiplier)), t) * frequency) * snoise(vec4((fPosition + (250.0 * irregularityMultiplier)), t) * frequency);
+    float ox, oy, oz, om;
+    if (isBakedNoise) { // The four fields of one fetch replace the shifted positions
+        vec4 offsetNoise = VolumeNoise4(fPosition * frequency, t * frequency);
+        ox = offsetNoise.r;
+        oy = offsetNoise.g;
+        oz = offsetNoise.b;
+        om = offsetNoise.a * VolumeNoise4((fPosition + (250.0 * irregularityMultiplier)) * frequency, t * frequency).a;
+    }
+    else {
+        ox = snoise(vec4(fPosition, t) * frequency);
+        oy = snoise(vec4((fPosition + (1000.0 * irregularityMultiplier)), t) * frequency);
+        oz = snoise(vec4((fPosition + (2000.0 * irregularityMultiplier)), t) * frequency);
+        om = snoise(vec4((fPosition + (4000.0 * irregularityMultiplier)), t) * frequency) * snoise(vec4((fPosition + (250.0 * irregularityMultiplier)), t) * frequency);
+    }
     vec3 offsetVec = vec3(ox * om, oy * om, oz * om) * smootheningMultiplier;
 
     // Get the distance vector from the center
     vec3 nDistVec = normalize(fPosition + offsetVec);
 
     // Get noise with normalized position to offset the original position
-    vec3 position = fPosition + noise(vec4(nDistVec, t), iDetail, 1.5, fDetail) * smootheningMultiplier;
+    float positionNoise = isBakedNoise ? VolumeFbm(nDistVec + t * W_AXIS, iDetail, 1.5, fDetail) : noise(vec4(nDistVec, t), iDetail, 1.5, fDetail);
+    vec3 position = fPosition + positionNoise * smootheningMultiplier;
 
     // Calculate brightness based on distance
     float dist = length(position + offsetVec) * coronaSizeMultiplier;
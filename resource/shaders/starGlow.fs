@@ -1,5 +1,7 @@
 #version 460 core
 
+#include "noiseVolume.glsl"
+
 //
 // Description : Array and textureless GLSL 2D/3D/4D simplex
 //               noise functions.
@@ -169,7 +171,7 @@ void main() {
 
     vec2 fTex = (vec2(fPosition.x, fPosition.y) + 1.0) / 2.0;
     vec2 nDistVec = normalize(vec2(fPosition.x, fPosition.y));
-    float spikeNoise = snoise(vec3(nDistVec, noiseZ) * spikeFrequency);
+    float spikeNoise = isBakedNoise ? VolumeNoise4(vec3(nDistVec, noiseZ) * spikeFrequency).r : snoise(vec3(nDistVec, noiseZ) * spikeFrequency);
     float spikeVal = spikeNoise + spikeShift;
 
     float dist = length(fPosition);
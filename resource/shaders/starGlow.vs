@@ -1,16 +1,14 @@
 #version 460 core
 
-layout (location = 0) in vec2 aPos;
+#include "uniformBlocks.glsl"
 
-uniform mat4 projection;
-uniform mat4 view;
+layout (location = 0) in vec2 aPos;
 
 uniform vec3 center;
 uniform vec2 dims;
 
 uniform bool isPlanetaryRingInView;
 
-uniform vec3 cameraPosition;
 uniform vec3 ringCenter; // Center of disk in eye space
 uniform vec3 ringNormal; // Disk plane normal in eye space
 uniform vec2 ringInnerOuterRadiuses; // x = Inner, y = Outer
@@ -47,7 +45,7 @@ bool intersectDisk(vec3 n, vec3 p0, float radius, vec3 l0, vec3 l, out float int
 
 void main() {
     fPosition = aPos;
-    gl_Position = projection * view * vec4(center, 1.0f);
+    gl_Position = frame.projection * frame.view * vec4(center, 1.0f);
     gl_Position /= gl_Position.w;
 
     vec2 correctDims = dims;
@@ -61,7 +59,7 @@ void main() {
 
         float intersectSquared;
 
-        if (intersectDisk(correctRingNormal, ringCenter, ringInnerOuterRadiuses.y, cameraPosition, normalize(center - cameraPosition), intersectSquared)) {
+        if (intersectDisk(correctRingNormal, ringCenter, ringInnerOuterRadiuses.y, frame.cameraPosition, normalize(center - frame.cameraPosition), intersectSquared)) {
             if (intersectSquared > ringInnerOuterRadiuses.x) {
                 float u = (intersectSquared - ringInnerOuterRadiuses.x) / (ringInnerOuterRadiuses.y - ringInnerOuterRadiuses.x);
                 vec4 ringColor = texture(ringDiffuse, vec2(u, 0));
@@ -0,0 +1,5 @@
+#version 460 core
+
+// Only the samples are counted, color writes are disabled while the proxy is drawn
+void main() {
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#version 460 core
+
+#include "uniformBlocks.glsl"
+
+// Flat disc covering the silhouette of a sphere, built from gl_VertexID as a triangle fan without any vertex buffer.
+// The tangent points of the view cone lie on a circle at radius^2 / distance from the center towards the camera
+const float PI = 3.14159265;
+
+uniform vec3 center;
+uniform float radius;
+uniform int segments;
+
+void main() {
+    vec3 toCamera = frame.cameraPosition - center;
+    float distance = max(length(toCamera), radius * 1.001);
+    vec3 direction = toCamera / distance;
+    vec3 right = normalize(cross(abs(direction.y) < 0.99 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0), direction));
+    vec3 up = cross(direction, right);
+
+    vec3 discCenter = center + direction * (radius * radius / distance);
+    float discRadius = radius * sqrt(1.0 - (radius * radius) / (distance * distance));
+
+    vec3 position = discCenter;
+    if (gl_VertexID > 0) {
+        float angle = 2.0 * PI * float(gl_VertexID - 1) / float(segments);
+        position += (right * cos(angle) + up * sin(angle)) * discRadius;
+    }
+
+    gl_Position = frame.projection * frame.view * vec4(position, 1.0);
+
+    /// Log z-buffer [логарифмический z-буфер]
+    gl_Position.z = log2(max(1e-6, gl_Position.w + 1.0)) * frame.zCoef - 1.0;
+    gl_Position.z *= gl_Position.w;
+}
\ No newline at end of file
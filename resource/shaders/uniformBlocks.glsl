@@ -0,0 +1,133 @@
+// Uniform blocks shared by all scene shaders, they are written once per frame (see FrameUniforms and LightUniforms in Application.h)
+
+layout (std140, binding = 0) uniform FrameBlock {
+    mat4 projection;
+    mat4 view;
+    vec3 cameraPosition;
+    float zCoef; // For log z-buffer (2.0 / log2(farPlane + 1.0)) [логарифмический z-буфер]
+    vec3 lightPosition;
+    float farPlane;
+    vec3 starGlowTint;
+    float time; // Seconds since start
+} frame;
+
+// Light space of the scene component which is being rendered and the layer of the shadow map array with its casters.
+// The light frustum is fitted to the component every frame, so its depth covers only [depthNear, depthFar] of the distance from the sun
+// With eclipse shadows the spherical casters are not in the shadow map, their shadows are computed from their spheres
+const int MAX_ECLIPSE_CASTERS = 8;
+
+struct Light {
+    mat4 lightSpaceMatrix;
+    int shadowLayer; // -1 if no caster of the component is drawn into the shadow map
+    float depthNear;
+    float depthFar;
+    int eclipseCastersCount;
+    vec4 eclipseCasters[MAX_ECLIPSE_CASTERS]; // xyz = center, w = radius
+    float sunRadius;
+    bool hasRing; // The ring of the planet, which shades the bodies of the component
+    float parentPlanetRadiusSquared;
+    vec3 parentPlanetCenter;
+    float ringInnerRadius;
+    vec3 ringCenter;
+    float ringOuterRadius;
+    vec3 ringNormal;
+};
+
+#ifdef INSTANCED
+// Instances of all components are drawn with one call, so the light of each one is picked by its record (see InstanceRecord.lightIndex)
+layout (std430, binding = 2) readonly buffer LightBuffer {
+    Light lights[];
+};
+
+Light light; // Set at the start of main
+#else
+layout (std140, binding = 1) uniform LightBlock {
+    Light light;
+};
+#endif
+
+// Shadow biases are set in units of distance, the depth of the layer is normalized to its range
+float ShadowDepthBias(float distanceBias) {
+    return distanceBias / (light.depthFar - light.depthNear);
+}
+
+float ShadowDepthToDistance(float depth) {
+    return mix(light.depthNear, light.depthFar, depth);
+}
+
+// Area of the intersection of a unit disc and a disc of the given radius at the given distance
+float DiscOverlapArea(float radius, float distance) {
+    const float PI = 3.14159265359;
+
+    if (distance >= 1.0 + radius)
+        return 0.0;
+    if (distance <= abs(1.0 - radius))
+        return PI * min(radius * radius, 1.0);
+
+    float radiusSquared = radius * radius, distanceSquared = distance * distance;
+    float unitSegment = acos(clamp((distanceSquared + 1.0 - radiusSquared) / (2.0 * distance), -1.0, 1.0));
+    float casterSegment = radiusSquared * acos(clamp((distanceSquared + radiusSquared - 1.0) / (2.0 * distance * radius), -1.0, 1.0));
+    float kite = 0.5 * sqrt(max((-distance + 1.0 + radius) * (distance + 1.0 - radius) * (distance - 1.0 + radius) * (distance + 1.0 + radius), 0.0));
+    return unitSegment + casterSegment - kite;
+}
+
+// Visible fraction of the sun disc: 0 in the umbra, 1 in the light, the penumbra follows the angular sizes of the sun and the casters.
+// The shaded body itself (selfCaster, the index of its sphere or -1) is skipped for its surface, clouds and atmosphere,
+// as lighting already darkens the night side. Other casters are skipped only while the point is inside them
+float EclipseLight(vec3 position, int selfCaster) {
+    const float PI = 3.14159265359;
+
+    vec3 toSun = frame.lightPosition - position;
+    float sunDistance = length(toSun);
+    float sunAngle = asin(min(light.sunRadius / sunDistance, 1.0));
+    float eclipseLight = 1.0;
+
+    for (int i = 0; i < light.eclipseCastersCount; i++) {
+        vec3 toCaster = light.eclipseCasters[i].xyz - position;
+        float casterDistance = length(toCaster);
+        float casterRadius = light.eclipseCasters[i].w;
+
+        if (i == selfCaster || casterDistance < casterRadius || casterDistance > sunDistance || dot(toCaster, toSun) <= 0.0)
+            continue;
+
+        // atan is precise for the small angles, unlike acos of the dot product
+        float separation = atan(length(cross(toCaster, toSun)), dot(toCaster, toSun));
+        float casterAngle = asin(casterRadius / casterDistance);
+        eclipseLight *= 1.0 - DiscOverlapArea(casterAngle / sunAngle, separation / sunAngle) / PI;
+    }
+
+    return eclipseLight;
+}
+
+// Materials of the bodies, a body passes the index of its material as the base instance of its draw (see MaterialTable.h)
+const uint MATERIAL_HAS_NIGHT_TEXTURE = 1u << 0;
+const uint MATERIAL_HAS_SPECULAR_MAP = 1u << 1;
+const uint MATERIAL_HAS_SPECULAR = 1u << 2;
+const uint MATERIAL_HAS_CLOUDS = 1u << 3;
+const uint MATERIAL_USE_SPHERE_INTERSECT = 1u << 4;
+
+struct Material {
+    uint flags;
+    float ambientFactor;
+};
+
+layout (std430, binding = 0) readonly buffer MaterialBuffer {
+    Material materials[];
+};
+
+#ifdef INSTANCED
+// Bodies drawn with one instanced call, the draw of a batch starts at its first record (see InstanceBatcher.h)
+struct InstanceRecord {
+    mat4 model;
+    uint materialIndex;
+    uint diffuseLayer;
+    uint normalLayer;
+    uint specularLayer;
+    int eclipseCaster; // Of the body in light.eclipseCasters, -1 if it is not one
+    uint lightIndex; // Of the component of the body in lights
+};
+
+layout (std430, binding = 1) readonly buffer InstanceBuffer {
+    InstanceRecord instances[];
+};
+#endif
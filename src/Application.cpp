@@ -1,38 +1,66 @@
 #include "Application.h"
 #include <SDL_image.h>
 #include <random>
+#include <limits>
 #include <iomanip>
 
 using namespace std;
 
 Application::Application() : _fpsHandler(240) {
+    StartupProfiler::Instance(); // Starts the clock on the main thread
     InitSystems();
     InitScene();
+    StartupProfiler::Instance().Finish("startup_trace.json");
 }
 
 void Application::Exec() {
     while (!glfwWindowShouldClose(_mainWindow)) {
         _fpsHandler.RunFrameTimer();
 
+        if (isUniformBenchmarkRequested) {
+            isUniformBenchmarkRequested = false;
+            _uniformBenchmark.Start();
+        }
+        _uniformBenchmark.BeginFrame();
+
         const double currentFrame = glfwGetTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        _renderState.Apply(RenderState()); // glClear honours the depth mask
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         ProcessInput(_mainWindow);
+        UpdateSceneComponentsResidency();
+        UpdateTextureStreaming();
+        UpdateSunVisibility();
+        UpdateStarStatistics();
+        UpdateFrameUniforms();
+        UpdateSceneComponentsVisibility();
+        UpdateLightSpaceMatrices();
         ConfigureMainShaders();
         _skyBox->Render(*_mainSkyBoxShader); // If rendered at the end, it overlaps atmospheres with clouds
         RenderStarCorona();
         ProcessSceneComponentsRendering();
         RenderStarEffects();
+        _sunOcclusionQueries->EndFrame();
+        if (_starFragmentQueries)
+            _starFragmentQueries->EndFrame();
+        for (auto& starTimeQueries : _starTimeQueries)
+            starTimeQueries->EndFrame();
 
         if (isRenderPlanetStarDistances || isRenderSatelliteDistances)
             RenderPlanetSatelliteStarDistances();
         if (isRenderHints)
             RenderHints();
 
+        _uniformBenchmark.EndFrame();
+        _uniformRingBuffer->EndFrame();
+        _renderState.EndFrame();
+        _lastFrameDrawCalls = GeometryArena::GetDrawCallsCount();
+        _lastFrameTriangles = GeometryArena::GetTrianglesCount();
+        GeometryArena::ResetDrawCallsCount();
         glfwSwapBuffers(_mainWindow);
         glfwPollEvents();
 
@@ -41,190 +69,421 @@ void Application::Exec() {
 }
 
 void Application::ProcessSceneComponentsRendering() {
-    // The idea is to render a scene component (planet, its satellites, rings, etc.) into a shadow map,
-    // then immediately into a regular buffer, and then clear the shadow map (depth buffer) so that the planet closest
-    // to the sun does not cover all the others.
-    // Cleaning is necessary because only one shadow map is used, and without cleaning, the depth will be overlapped by objects from all over the scene
-    // Thus, by changing the lightSpaceMatrix, it can be created the impression that an omnidirectional light source is used in the scene.
+    // The idea is to render each scene component (planet, its satellites, rings, etc.) into its own layer of the shadow map array,
+    // so that the planet closest to the sun does not cover all the others.
+    // Thus, by changing the lightSpaceMatrix per layer, it can be created the impression that an omnidirectional light source is used in the scene.
     // If desired, you can use the technique with a cube depth map, but due to the lack of precision of z-buffer, shadows are killed
+    ShadowMapPass();
+    glViewport(0, 0, _displayWidth, _displayHeight);
 
+    // The opaque bodies of all components are drawn with one flush, every command binds the light block of its component.
+    // The satellites of all components are a single command, their instances pick the lights of their components
     for (const auto& renderableSceneComponent : _renderableSceneComponents) {
-        ShadowMapPass(renderableSceneComponent);
-        RenderPass(renderableSceneComponent);
+        if (renderableSceneComponent.visibility.isComponent)
+            SubmitOpaqueDraws(renderableSceneComponent);
+        else
+            AdvanceCulledComponent(renderableSceneComponent);
     }
+
+    SubmitSatellites();
+    _renderQueue.FlushOpaque();
+
+    // The occlusion query of the star runs after the bodies and before the shells, so rings do not cover the sun.
+    // This is a bit of a strange technique, but necessary due to the fact that the ring itself is a solid
+    // 3D model, and not procedurally generated particles.
+    ProcessStarRendering();
+
+    // Atmospheres, clouds and rings of all components are sorted back-to-front by the nearest drawn part of each shell
+    for (const auto& renderableSceneComponent : _renderableSceneComponents) {
+        if (renderableSceneComponent.visibility.isComponent)
+            SubmitTransparentDraws(renderableSceneComponent);
+    }
+
+    _renderQueue.FlushTransparent();
+    _renderState.Apply(RenderState()); // The passes after the scene expect the opaque state
 }
 
-void Application::ShadowMapPass(const RenderableSceneComponent& component) {
+void Application::ShadowMapPass() {
+    // The casters of all visible components are moved here, but only the layers whose casters moved noticeably
+    // since their last rendering are cleared and drawn again, all of them with one layered indirect draw
+    vector<ShadowCache::Caster> casters;
+    vector<uint16_t> dirtyLayers;
+
+    for (const auto& component : _renderableSceneComponents) {
+        if (component.visibility.isComponent && AddShadowCasters(component, casters))
+            dirtyLayers.push_back(static_cast<uint16_t>(component.shadowLayer));
+    }
+
+    _shadowCache->EndFrame();
+
+    if (dirtyLayers.empty())
+        return;
+
+    for (const uint16_t layer : dirtyLayers)
+        _shadowMapFBO->ClearLayer(layer);
+
     glBindFramebuffer(GL_FRAMEBUFFER, _shadowMapFBO->GetFBO());
-    glClear(GL_DEPTH_BUFFER_BIT);
+    _renderState.Apply(RenderState()); // The previous frame may end with depth writes off
     glViewport(0, 0, _shadowMapFBO->GetShadowMapWidth(), _shadowMapFBO->GetShadowMapHeight());
-
     _shadowMapShader->Use();
-    _shadowMapShader->SetMat4("lightSpaceMatrix", component.lightSpaceMatrix);
+    _instanceBatcher->Flush(false);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+bool Application::AddShadowCasters(const RenderableSceneComponent& component, vector<ShadowCache::Caster>& casters) {
+    // The instanced program has no model uniform, so AdjustToParent uploads nothing.
+    // The shadow map has no color attachment, so the ring is drawn without blending.
+    // With eclipse shadows the spheres are shaded analytically (see EclipseLight in uniformBlocks.glsl), so only the ring
+    // and the irregular satellites are left for the shadow map
+    const auto& visibility = component.visibility;
+    vector<const MeshHolder*> casterModels;
+    casters.clear();
+
+    const auto addCaster = [&casters, &casterModels](const MeshHolder& model, const glm::mat4& modelMatrix, size_t level, bool isSphere) {
+        if (isSphere && isEclipseShadows)
+            return;
+
+        casters.push_back({modelMatrix, level, isSphere});
+        casterModels.push_back(&model);
+    };
 
     component.planet->SetShader(*_shadowMapShader);
     component.planet->AdjustToParent(isTimeRun);
-    component.planet->Render();
+    addCaster(GetLevelModel(*component.planet, visibility.planetShadowLevel), component.planet->GetModelMatrix(), visibility.planetShadowLevel,
+              _sphereLods->IsSphere(component.planet->GetModel()));
 
-    for (const auto& satellite : component.satellites) {
+    if (component.planetaryRing) {
+        component.planetaryRing->SetShader(*_shadowMapShader);
+        component.planetaryRing->AdjustToParent();
+        addCaster(component.planetaryRing->GetModel(), component.planetaryRing->GetModelMatrix(), 0, false);
+    }
+
+    for (size_t i = 0; i < component.satellites.size(); i++) {
+        const auto& satellite = component.satellites[i];
         satellite->SetShader(*_shadowMapShader);
         satellite->AdjustToParent(isTimeRun);
-        satellite->Render();
+        addCaster(GetLevelModel(*satellite, visibility.satelliteShadowLevels[i]), satellite->GetModelMatrix(), visibility.satelliteShadowLevels[i],
+                  _sphereLods->IsSphere(satellite->GetModel()));
     }
 
-    RenderPlanetaryRing(*_shadowMapShader, component.planetaryRing.get(), component.lightSpaceMatrix);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (casters.empty())
+        return false;
+
+    // Small components cover a few pixels of the screen, so their shadows may lag behind by several frames
+    const uint32_t refreshInterval = visibility.planetLevel == _sphereLods->GetImpostorLevel() ? 8 : 1;
+    if (!_shadowCache->Update(component.shadowLayer, component.lightSpaceMatrix, casters, refreshInterval))
+        return false;
+
+    for (size_t i = 0; i < casters.size(); i++)
+        _instanceBatcher->AddShadowCaster(*casterModels[i], component.lightSpaceMatrix * casters[i].model, static_cast<uint32_t>(component.shadowLayer));
+
+    return true;
 }
 
-void Application::RenderPass(const RenderableSceneComponent& component) {
-    glViewport(0, 0, _displayWidth, _displayHeight);
-    _mainPlanetShader->Use();
+void Application::SubmitOpaqueDraws(const RenderableSceneComponent& component) {
+    if (component.visibility.isPlanet) {
+        SubmitPlanet(component);
+    } else {
+        component.planet->SetShader(*_shadowMapShader); // Has no model uniform, so only the orbit is advanced
+        component.planet->AdjustToParent(isTimeRun);
+    }
+}
 
-    ConfigureMainPlanetShader(component);
+void Application::SubmitTransparentDraws(const RenderableSceneComponent& component) {
+    // Atmospheres and rings are placed by their parents only, so the culled ones are simply not submitted
+    const auto& visibility = component.visibility;
+    for (size_t i = 0; i < component.atmospheres.size(); i++) {
+        if (visibility.atmospheres[i])
+            SubmitAtmosphere(component, component.atmospheres[i]);
+    }
 
-    component.planet->SetShader(*_mainPlanetShader);
-    component.planet->AdjustToParent(isTimeRun);
-    component.planet->Render();
+    if (component.clouds) {
+        if (visibility.isClouds) {
+            SubmitClouds(component);
+        } else {
+            _mainCloudsShader->Use(); // AdjustToParent uploads the model matrix into the bound program
+            component.clouds->AdjustToParent(isTimeRun);
+        }
+    }
 
-    for (const auto& satellite : component.satellites) {
-        satellite->SetShader(*_mainPlanetShader);
-        satellite->AdjustToParent(isTimeRun);
-        satellite->Render();
+    if (component.planetaryRing && visibility.isRing)
+        SubmitPlanetaryRing(component);
+}
+
+void Application::AdvanceCulledComponent(const RenderableSceneComponent& component) {
+    // The orbits and rotations advance on every AdjustToParent call, so the bodies of a culled component are adjusted
+    // as many times as the skipped shadow and render passes would do it, otherwise they would slow down outside the view
+    component.planet->SetShader(*_shadowMapShader);
+    for (const auto& satellite : component.satellites)
+        satellite->SetShader(*_shadowMapShader);
+
+    for (int pass = 0; pass < 2; pass++) {
+        component.planet->AdjustToParent(isTimeRun);
+
+        for (const auto& satellite : component.satellites)
+            satellite->AdjustToParent(isTimeRun);
     }
 
-    // Occlusion request will be carried out for the nearest planet, so if planet has a rings, they do not cover the sun.
-    // This is a bit of a strange technique, but necessary due to the fact that the ring itself is a solid
-    // 3D model, and not procedurally generated particles.
-    if (component.planet == _renderableSceneComponents[_nearestPlanetIndex].planet) // Render star once and update occlusion query for nearest planet
-        ProcessStarRendering();
+    if (component.clouds) {
+        _mainCloudsShader->Use();
+        component.clouds->AdjustToParent(isTimeRun);
+    }
+}
 
-    RenderAtmospheres(component.atmospheres, component.lightSpaceMatrix, component.planetaryRing.get());
-    RenderClouds(component.clouds.get(), component.lightSpaceMatrix);
-    RenderPlanetaryRing(*_mainRingShader, component.planetaryRing.get(), component.lightSpaceMatrix);
+void Application::SubmitPlanet(const RenderableSceneComponent& component) {
+    Planet* planet = component.planet.get();
+    const size_t level = component.visibility.planetLevel;
+    const bool isImpostor = level == _sphereLods->GetImpostorLevel();
+    const Shader* shader = isImpostor ? _impostorPlanetShader.get() : _mainPlanetShader.get();
+    const PlanetComponentUniforms& uniforms = isImpostor ? _impostorComponentUniforms : _planetComponentUniforms;
+    const MeshHolder& model = GetLevelModel(*planet, level);
+    const int32_t eclipseCaster = FindEclipseCaster(component, *planet);
+
+    RenderCommand command;
+    command.program = static_cast<GLuint>(shader->GetProgramId());
+    command.texture = planet->GetMaterialTexture(DiffuseSlot).GetTexture();
+    command.mesh = model.GetMeshModel();
+    command.lightBlockOffset = component.lightBlockOffset;
+    command.draw = [this, &component, planet, shader, &uniforms, &model, eclipseCaster] {
+        shader->Use();
+        ConfigurePlanetShader(*shader, uniforms, component); // The planets of other components may be drawn in between
+        shader->Set(uniforms.eclipseCaster, eclipseCaster);
+        planet->SetShader(*shader);
+        planet->AdjustToParent(isTimeRun);
+        planet->RenderModel(model);
+    };
+
+    _renderQueue.Submit(move(command));
 }
 
-void Application::RenderAtmospheres(const std::vector<RenderableAtmosphere>& renderableAtmospheres, const glm::mat4& lightSpaceMatrix, const PlanetaryRing* ring) const {
-    if (!renderableAtmospheres.empty()) {
-        glDepthMask(GL_FALSE);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_ONE, GL_ONE);
+void Application::SubmitSatellites() {
+    const bool hasSatellites = any_of(_renderableSceneComponents.cbegin(), _renderableSceneComponents.cend(), [](const RenderableSceneComponent& component) {
+        return component.visibility.isComponent && !component.satellites.empty();
+    });
 
-        _mainAtmosphereShader->Use();
-        _mainAtmosphereShader->SetMat4("lightSpaceMatrix", lightSpaceMatrix);
-
-        for (const auto& renderableAtmosphere : renderableAtmospheres) {
-            _mainAtmosphereShader->SetVec3("camPosition", camera.GetPosition() - renderableAtmosphere.atmosphere->GetPosition());
-            _mainAtmosphereShader->SetVec3("lightPos", _sun->GetPosition() - renderableAtmosphere.atmosphere->GetPosition());
-            _mainAtmosphereShader->SetVec3("mieTint", renderableAtmosphere.atmosphere->GetMieTint());
-            _mainAtmosphereShader->SetFloat("SCALE_H_FACTOR", renderableAtmosphere.hScaleFactor);
-            _mainAtmosphereShader->SetFloat("earthSizeCoefficient", renderableAtmosphere.parentEarthSizeCoefficient);
-            _mainAtmosphereShader->SetBool("isUseToneMapping", renderableAtmosphere.isUseToneMapping);
-            _mainAtmosphereShader->SetBool("isNearbyPlanetaryRing", ring != nullptr);
-
-            if (ring) {
-                _mainAtmosphereShader->SetVec3("ringParentPlanetCenter", ring->GetParent()->GetPosition());
-                _mainAtmosphereShader->SetFloat("ringParentPlanetRadiusSquared", ring->GetParent()->GetRadius() * ring->GetParent()->GetRadius());
-                _mainAtmosphereShader->SetBool("isUseSphereIntersect", ring->GetParent() != renderableAtmosphere.atmosphere->GetParent());
-
-                _mainAtmosphereShader->SetVec3("ringCenter", ring->GetPosition());
-                _mainAtmosphereShader->SetVec3("ringNormal", ring->GetRingNormal());
-                _mainAtmosphereShader->SetVec2("ringInnerOuterRadiuses", glm::vec2(ring->GetInnerRadius(), ring->GetOuterRadius()));
-                _mainAtmosphereShader->SetInt("ringDiffuse", 9);
-                glBindTextureUnit(9, ring->GetRingTexture());
-            }
+    if (!hasSatellites)
+        return;
+
+    RenderCommand command; // The instanced programs read the lights from LightBufferBinding, so no light block is bound
+    command.program = static_cast<GLuint>(_instancedPlanetShader->GetProgramId());
+    command.draw = [this] { DrawSatellitesInstanced(); };
+    _renderQueue.Submit(move(command));
+}
+
+void Application::DrawSatellitesInstanced() {
+    const size_t impostorLevel = _sphereLods->GetImpostorLevel();
 
-            // Inside the atmosphere
-            if (CalculateSpaceObjectDistance(renderableAtmosphere.atmosphere.get()) <= renderableAtmosphere.atmosphere->GetAtmosphereOuterBoundary())
-                glFrontFace(GL_CW);
+    // Meshes and impostors are different programs, so they are two flushes, each with the satellites of all visible components
+    for (const bool isImpostorBatch : {false, true}) {
+        size_t addedCount = 0;
 
-            renderableAtmosphere.atmosphere->AdjustToParent();
-            renderableAtmosphere.atmosphere->Render();
+        for (const auto& component : _renderableSceneComponents) {
+            if (!component.visibility.isComponent) // Its satellites are moved by AdvanceCulledComponent
+                continue;
 
-            glFrontFace(GL_CCW);
+            const auto& satellites = component.satellites;
+            const auto& visibility = component.visibility;
+            const auto lightIndex = static_cast<uint32_t>(component.shadowLayer); // The lights are in the order of the components, like the layers
+            const GLuint ringTexture = component.planetaryRing ? component.planetaryRing->GetRingTexture() : 0;
+
+            for (size_t i = 0; i < satellites.size(); i++) {
+                const auto& satellite = satellites[i];
+
+                if (!isImpostorBatch) {
+                    satellite->SetShader(*_instancedPlanetShader); // The instanced programs have no model uniform, so AdjustToParent uploads nothing
+                    satellite->AdjustToParent(isTimeRun);
+                }
+
+                if (!visibility.satellites[i] || (visibility.satelliteLevels[i] == impostorLevel) != isImpostorBatch)
+                    continue;
+
+                _instanceBatcher->Add(GetLevelModel(*satellite, visibility.satelliteLevels[i]), satellite->GetMaterialTexture(DiffuseSlot),
+                                      satellite->GetMaterialTexture(NormalSlot), satellite->GetMaterialTexture(SpecularSlot), satellite->GetModelMatrix(),
+                                      satellite->GetMaterialIndex(), FindEclipseCaster(component, *satellite), lightIndex, ringTexture);
+                addedCount++;
+            }
         }
 
-        glDisable(GL_BLEND);
-        glDepthMask(GL_TRUE);
+        if (addedCount > 0) {
+            (isImpostorBatch ? _instancedImpostorShader : _instancedPlanetShader)->Use();
+            _instanceBatcher->Flush();
+        }
     }
 }
 
-void Application::RenderClouds(Clouds* renderableClouds, const glm::mat4& lightSpaceMatrix) const {
-    if (renderableClouds) {
-        glDepthMask(GL_FALSE);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_COLOR);
-        glDisable(GL_CULL_FACE);
+void Application::SubmitAtmosphere(const RenderableSceneComponent& component, const RenderableAtmosphere& renderableAtmosphere) {
+    const PlanetaryRing* ring = component.planetaryRing.get();
+    const int32_t eclipseCaster = FindEclipseCaster(component, *renderableAtmosphere.atmosphere->GetParent());
+    const float outerBoundary = renderableAtmosphere.atmosphere->GetAtmosphereOuterBoundary();
+
+    RenderCommand command;
+    command.state.isBlend = true;
+    command.state.isDepthWrite = false;
+    command.state.blendSource = GL_ONE;
+    command.state.blendDestination = GL_ONE;
+    command.lightBlockOffset = component.lightBlockOffset;
+    command.cameraDistance = CalculateShellSortDistance(CalculateSpaceObjectDistance(renderableAtmosphere.atmosphere->GetParent().get()), outerBoundary);
+
+    // Inside the atmosphere
+    if (CalculateSpaceObjectDistance(renderableAtmosphere.atmosphere.get()) <= outerBoundary)
+        command.state.frontFace = GL_CW;
+
+    command.draw = [this, &renderableAtmosphere, ring, eclipseCaster] {
+        const auto& uniforms = _atmosphereUniforms;
+        _mainAtmosphereShader->Use();
 
+        _mainAtmosphereShader->Set(uniforms.camPosition, camera.GetPosition() - renderableAtmosphere.atmosphere->GetPosition());
+        _mainAtmosphereShader->Set(uniforms.lightPos, _sun->GetPosition() - renderableAtmosphere.atmosphere->GetPosition());
+        _mainAtmosphereShader->Set(uniforms.mieTint, renderableAtmosphere.atmosphere->GetMieTint());
+        _mainAtmosphereShader->Set(uniforms.hScaleFactor, renderableAtmosphere.hScaleFactor);
+        _mainAtmosphereShader->Set(uniforms.earthSizeCoefficient, renderableAtmosphere.parentEarthSizeCoefficient);
+        _mainAtmosphereShader->Set(uniforms.isUseToneMapping, renderableAtmosphere.isUseToneMapping);
+        _mainAtmosphereShader->Set(uniforms.isNearbyPlanetaryRing, ring != nullptr);
+        _mainAtmosphereShader->Set(uniforms.eclipseCaster, eclipseCaster);
+
+        if (ring) {
+            _mainAtmosphereShader->Set(uniforms.ringParentPlanetCenter, ring->GetParent()->GetPosition());
+            _mainAtmosphereShader->Set(uniforms.ringParentPlanetRadiusSquared, ring->GetParent()->GetRadius() * ring->GetParent()->GetRadius());
+            _mainAtmosphereShader->Set(uniforms.isUseSphereIntersect, ring->GetParent() != renderableAtmosphere.atmosphere->GetParent());
+
+            _mainAtmosphereShader->Set(uniforms.ringCenter, ring->GetPosition());
+            _mainAtmosphereShader->Set(uniforms.ringNormal, ring->GetRingNormal());
+            _mainAtmosphereShader->Set(uniforms.ringInnerOuterRadiuses, glm::vec2(ring->GetInnerRadius(), ring->GetOuterRadius()));
+            _mainAtmosphereShader->Set(uniforms.ringDiffuse, 9);
+            glBindTextureUnit(9, ring->GetRingTexture());
+        }
+
+        renderableAtmosphere.atmosphere->AdjustToParent();
+        renderableAtmosphere.atmosphere->Render();
+    };
+
+    _renderQueue.Submit(move(command));
+}
+
+void Application::SubmitClouds(const RenderableSceneComponent& component) {
+    Clouds* renderableClouds = component.clouds.get();
+    const int32_t eclipseCaster = FindEclipseCaster(component, *component.planet);
+
+    RenderCommand command;
+    command.state.isBlend = true;
+    command.state.isDepthWrite = false;
+    command.state.isCullFace = false;
+    command.state.blendSource = GL_SRC_ALPHA;
+    command.state.blendDestination = GL_ONE_MINUS_SRC_COLOR;
+    command.lightBlockOffset = component.lightBlockOffset;
+    command.cameraDistance = CalculateShellSortDistance(CalculateSpaceObjectDistance(renderableClouds->GetParent().get()), renderableClouds->GetRadius());
+    command.draw = [this, renderableClouds, eclipseCaster] {
         _mainCloudsShader->Use();
-        _mainCloudsShader->SetMat4("lightSpaceMatrix", lightSpaceMatrix);
+        _mainCloudsShader->Set(_cloudsEclipseCaster, eclipseCaster);
         renderableClouds->AdjustToParent(isTimeRun);
         renderableClouds->Render();
+    };
 
-        glEnable(GL_CULL_FACE);
-        glDisable(GL_BLEND);
-        glDepthMask(GL_TRUE);
-    }
+    _renderQueue.Submit(move(command));
 }
 
-void Application::RenderPlanetaryRing(const Shader& shader, PlanetaryRing* planetaryRing, const glm::mat4& lightSpaceMatrix) const {
-    if (planetaryRing) {
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-        shader.Use();
-        shader.SetMat4("lightSpaceMatrix", lightSpaceMatrix);
-        planetaryRing->SetShader(shader);
+void Application::SubmitPlanetaryRing(const RenderableSceneComponent& component) {
+    PlanetaryRing* planetaryRing = component.planetaryRing.get();
+
+    RenderCommand command;
+    command.state.isBlend = true;
+    command.state.blendSource = GL_SRC_ALPHA;
+    command.state.blendDestination = GL_ONE_MINUS_SRC_ALPHA;
+    command.lightBlockOffset = component.lightBlockOffset;
+    command.cameraDistance = CalculateSpaceObjectDistance(planetaryRing->GetParent().get()) - planetaryRing->GetOuterRadius(); // A flat disc is seen from outside
+    command.draw = [this, planetaryRing] {
+        _mainRingShader->Use();
+        planetaryRing->SetShader(*_mainRingShader);
         planetaryRing->AdjustToParent();
         planetaryRing->Render();
+    };
 
-        glDisable(GL_BLEND);
-    }
+    _renderQueue.Submit(move(command));
 }
 
-void Application::ProcessStarRendering() {
-    glDepthMask(GL_FALSE);
-    glBeginQuery(GL_SAMPLES_PASSED, _sun->GetStarOcclusionValue(0));
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    RenderStar();
-    glDisable(GL_BLEND);
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);
-    glEndQuery(GL_SAMPLES_PASSED);
+float Application::CalculateShellSortDistance(float centerDistance, float radius) {
+    // The nearest drawn part of a shell: the front side from outside, the far side from inside
+    return centerDistance > radius ? centerDistance - radius : centerDistance + radius;
+}
 
-    glBeginQuery(GL_SAMPLES_PASSED, _sun->GetStarOcclusionValue(1));
-    RenderStar();
-    glEndQuery(GL_SAMPLES_PASSED);
-    glDepthMask(GL_TRUE);
-    glDepthFunc(GL_LESS);
+void Application::ProcessStarRendering() {
+    _starTimeQueries[Surface]->Begin();
+    if (_starFragmentQueries)
+        _starFragmentQueries->Begin();
+
+    if (!isStarOcclusionProxy) { // The star surface itself is shaded in both queries
+        _renderState.SetDepthMask(GL_FALSE);
+        _sunOcclusionQueries->Begin(OcclusionSamples::Total);
+        _renderState.Disable(GL_DEPTH_TEST);
+        _renderState.Enable(GL_BLEND);
+        RenderStar();
+        _renderState.Disable(GL_BLEND);
+        _renderState.Enable(GL_DEPTH_TEST);
+        _renderState.SetDepthFunc(GL_LEQUAL);
+        _sunOcclusionQueries->End();
+
+        _sunOcclusionQueries->Begin(OcclusionSamples::Passed);
+        RenderStar();
+        _sunOcclusionQueries->End();
+        _renderState.SetDepthMask(GL_TRUE);
+        _renderState.SetDepthFunc(GL_LESS);
+    }
+    else {
+        // The samples are counted on a flat disc over the silhouette with an empty fragment shader,
+        // so the noise of star.fs runs only once, for the surface which is actually seen
+        _sun->TakeStarSystemCenter();
+        const float sunRadius = glm::length(glm::vec3(_sun->GetModelMatrix()[0])) * SphereLodChain::SPHERE_MODEL_RADIUS;
+
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        _renderState.SetDepthMask(GL_FALSE);
+        _renderState.Disable(GL_DEPTH_TEST);
+        _sunOcclusionQueries->Begin(OcclusionSamples::Total);
+        _sun->RenderOcclusionProxy(*_starOcclusionProxyShader, sunRadius);
+        _sunOcclusionQueries->End();
+
+        _renderState.Enable(GL_DEPTH_TEST);
+        _renderState.SetDepthFunc(GL_LEQUAL);
+        _sunOcclusionQueries->Begin(OcclusionSamples::Passed);
+        _sun->RenderOcclusionProxy(*_starOcclusionProxyShader, sunRadius);
+        _sunOcclusionQueries->End();
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+        RenderStar();
+        _renderState.SetDepthMask(GL_TRUE);
+        _renderState.SetDepthFunc(GL_LESS);
+    }
 
-    UpdateOcclusionQuery();
+    if (_starFragmentQueries)
+        _starFragmentQueries->End();
+    _starTimeQueries[Surface]->End();
 }
 
 void Application::RenderStarCorona() const {
-    glDepthMask(GL_FALSE);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_ONE, GL_ONE);
+    _renderState.SetDepthMask(GL_FALSE);
+    _renderState.Enable(GL_BLEND);
+    _renderState.SetBlendFunc(GL_ONE, GL_ONE);
 
+    _starTimeQueries[Corona]->Begin();
     _mainCoronaStarShader->Use();
     _sun->SetShader(*_mainCoronaStarShader);
     _sun->TakeStarSystemCenter();
     _sun->Render();
     _sun->SetShader(*_mainStarShader);
+    _starTimeQueries[Corona]->End();
 
-    glDepthMask(GL_TRUE);
-    glDisable(GL_BLEND);
+    _renderState.SetDepthMask(GL_TRUE);
+    _renderState.Disable(GL_BLEND);
 }
 
 void Application::RenderStar() const {
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE); // To allow make the alpha channel of the star at 0 when it is not visible due to some object
+    _renderState.Enable(GL_BLEND);
+    _renderState.SetBlendFunc(GL_SRC_ALPHA, GL_ONE); // To allow make the alpha channel of the star at 0 when it is not visible due to some object
 
     _mainStarShader->Use();
     _sun->TakeStarSystemCenter();
     _sun->Render();
 
-    glDisable(GL_BLEND);
+    _renderState.Disable(GL_BLEND);
 }
 
 void Application::RenderStarEffects() const {
@@ -234,37 +493,48 @@ void Application::RenderStarEffects() const {
 
     optional<RingCameraInfo> ringCameraInfo;
     if (nearestPlanetaryRing) {
-        ringCameraInfo = {camera.GetPosition(), nearestPlanetaryRing->GetPosition(), nearestPlanetaryRing->GetRingNormal(),
+        ringCameraInfo = {nearestPlanetaryRing->GetPosition(), nearestPlanetaryRing->GetRingNormal(),
                           glm::vec2(nearestPlanetaryRing->GetInnerRadius(), nearestPlanetaryRing->GetOuterRadius()),
                           nearestPlanetaryRing->GetRingTexture()};
     }
 
+    // The glow and the flares are skipped by the GPU itself when no sample of the star passed the depth test this frame,
+    // the CPU does not wait for the query. The HDR buffer is cleared inside too, it is only composited when the glow is drawn
+    const bool isConditional = _sunOcclusionQueries->IsIssued();
+    if (isConditional)
+        glBeginConditionalRender(_sunOcclusionQueries->GetPassedQuery(), GL_QUERY_WAIT);
+
     glBindFramebuffer(GL_FRAMEBUFFER, _hdr->GetHdrFBO());
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    _sun->RenderGlow(_cameraProjection, _cameraView, camera.GetFrontVector() - camera.GetRightVector(), camera.GetAspect(),
+    _renderState.Enable(GL_BLEND);
+    _renderState.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    _starTimeQueries[Glow]->Begin();
+    _sun->RenderGlow(camera.GetFrontVector() - camera.GetRightVector(), camera.GetAspect(),
                      CalculateSpaceObjectDistance(_sun.get()), ringCameraInfo, starTemperatureInKelvin);
+    _starTimeQueries[Glow]->End();
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_ONE, GL_ONE);
+    _renderState.Disable(GL_DEPTH_TEST);
+    _renderState.SetDepthMask(GL_FALSE);
+    _renderState.Enable(GL_BLEND);
+    _renderState.SetBlendFunc(GL_ONE, GL_ONE);
     _hdr->Render(starExposure, starGamma);
     float intensity = glm::min(_sun->GetCurrentGlowSize() * _sun->GetVisibility(), 1.0f);
-    _lensFlare->Render(_cameraProjection, _cameraView, _sun->GetPosition(), glm::vec3(1.0), camera.GetAspect(), 0.1, intensity, ringCameraInfo);
+    _lensFlare->Render(_sun->GetPosition(), glm::vec3(1.0), camera.GetAspect(), 0.1, intensity, ringCameraInfo);
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_BLEND);
-    glDepthMask(GL_TRUE);
-    glEnable(GL_DEPTH_TEST);
+    if (isConditional)
+        glEndConditionalRender();
+
+    _renderState.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    _renderState.Disable(GL_BLEND);
+    _renderState.SetDepthMask(GL_TRUE);
+    _renderState.Enable(GL_DEPTH_TEST);
 }
 
 void Application::RenderPlanetSatelliteStarDistances() const {
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    _renderState.Disable(GL_DEPTH_TEST);
+    _renderState.Enable(GL_BLEND);
+    _renderState.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     if (isRenderPlanetStarDistances)
         RenderSpaceObjectDistance(_sun.get());
@@ -281,8 +551,8 @@ void Application::RenderPlanetSatelliteStarDistances() const {
         }
     }
 
-    glDisable(GL_BLEND);
-    glEnable(GL_DEPTH_TEST);
+    _renderState.Disable(GL_BLEND);
+    _renderState.Enable(GL_DEPTH_TEST);
 }
 
 void Application::RenderSpaceObjectDistance(const SpaceObject* spaceObject) const {
@@ -309,12 +579,12 @@ void Application::RenderHints() const {
     static const string gpuHintString = string(reinterpret_cast<const char *>(glGetString(GL_RENDERER)));
     static constexpr glm::vec3 textColor = glm::vec3(0.98431, 0.80784, 0.69412);
 
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    _renderState.Disable(GL_DEPTH_TEST);
+    _renderState.Enable(GL_BLEND);
+    _renderState.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     _mainTextShader->Use();
-    _mainTextShader->SetMat4("projection", textProjection);
+    _mainTextShader->SetMat4("textProjection", textProjection);
     _mainTextShader->SetBool("is3D", false);
 
     deque<wstring> fpsHint;
@@ -379,6 +649,78 @@ void Application::RenderHints() const {
     vertSyncHint.emplace_back(L"Vert Sync(F1): ");
     vertSyncHint.emplace_back((isVertSyncEnabled) ? L"On" : L"Off");
 
+    deque<wstring> uniformBenchmarkHint;
+    uniformBenchmarkHint.emplace_back(L"Uniform benchmark(F2): ");
+    uniformBenchmarkHint.emplace_back(_uniformBenchmark.IsRunning() ? L"Running" : L"Off");
+
+    const auto& renderStateStatistics = _renderState.GetLastFrameStatistics();
+    deque<wstring> renderStateHint;
+    renderStateHint.emplace_back(L"GL state changes: ");
+    renderStateHint.emplace_back(to_wstring(renderStateStatistics.stateChanges) + L" (" + to_wstring(renderStateStatistics.redundantChanges) +
+                                 L" redundant skipped)");
+
+    deque<wstring> drawCallsHint;
+    drawCallsHint.emplace_back(L"Mesh draw calls: ");
+    drawCallsHint.emplace_back(to_wstring(_lastFrameDrawCalls) + L" (" + to_wstring(_lastFrameTriangles) + L" triangles)");
+
+    // Visible sphere bodies by their level of detail, the last number is impostors
+    vector<size_t> levelsCount(_sphereLods->GetImpostorLevel() + 1, 0);
+    for (const auto& component : _renderableSceneComponents) {
+        const auto& visibility = component.visibility;
+        if (!visibility.isComponent)
+            continue;
+
+        if (visibility.isPlanet)
+            levelsCount[visibility.planetLevel]++;
+
+        for (size_t i = 0; i < component.satellites.size(); i++) {
+            if (visibility.satellites[i])
+                levelsCount[visibility.satelliteLevels[i]]++;
+        }
+    }
+
+    wstring levelsStr;
+    for (size_t level = 0; level < levelsCount.size(); level++)
+        levelsStr += (level == 0 ? L"" : L" / ") + to_wstring(levelsCount[level]);
+
+    deque<wstring> sphereLevelsHint;
+    sphereLevelsHint.emplace_back(L"Sphere LODs: ");
+    sphereLevelsHint.emplace_back(levelsStr + L" (the last are impostors)");
+
+    deque<wstring> cullingHint;
+    cullingHint.emplace_back(L"Frustum culling: ");
+    cullingHint.emplace_back(to_wstring(_lastFrameCulling.testedObjects - _lastFrameCulling.culledObjects) + L" drawn, " +
+                             to_wstring(_lastFrameCulling.culledObjects) + L" culled (" + to_wstring(_lastFrameCulling.culledComponents) + L" systems)");
+
+    const auto& shadowStatistics = _shadowCache->GetLastFrameStatistics();
+    deque<wstring> shadowLayersHint;
+    shadowLayersHint.emplace_back(L"Shadow layers: ");
+    shadowLayersHint.emplace_back(to_wstring(shadowStatistics.refreshedLayers) + L" rendered, " + to_wstring(shadowStatistics.cachedLayers) + L" cached");
+
+    deque<wstring> eclipseShadowsHint;
+    eclipseShadowsHint.emplace_back(L"Eclipse shadows(F3): ");
+    eclipseShadowsHint.emplace_back((isEclipseShadows) ? L"On" : L"Off");
+
+    deque<wstring> sunOcclusionHint;
+    sunOcclusionHint.emplace_back(L"Sun occlusion: ");
+    sunOcclusionHint.emplace_back(to_wstring(static_cast<int>(_sunMeasuredVisibility * 100.0f)) + L"% visible, " +
+                                  to_wstring(_sunOcclusionQueries->GetLastLatency()) + L" frames latency");
+
+    deque<wstring> starPathHint;
+    starPathHint.emplace_back(L"Star occlusion proxy(F4): ");
+    starPathHint.emplace_back(wstring(isStarOcclusionProxy ? L"On" : L"Off") + L", " +
+                              (_starFragmentQueries ? to_wstring(_starFragmentInvocations) : wstring(L"?")) + L" fragment invocations");
+
+    auto toMilliseconds = [](uint64_t nanoseconds) {
+        wostringstream stream;
+        stream << fixed << setprecision(2) << static_cast<double>(nanoseconds) / 1e6;
+        return stream.str();
+    };
+    deque<wstring> starNoiseHint;
+    starNoiseHint.emplace_back(L"Star noise(F5): ");
+    starNoiseHint.emplace_back(wstring(isBakedStarNoise ? L"Baked" : L"Procedural") + L", GPU time corona " + toMilliseconds(_starTimes[Corona]) +
+                               L" ms, surface " + toMilliseconds(_starTimes[Surface]) + L" ms, glow " + toMilliseconds(_starTimes[Glow]) + L" ms");
+
     deque<wstring> textHints;
     textHints.emplace_back(L"Text hints(TAB)");
 
@@ -398,121 +740,374 @@ void Application::RenderHints() const {
     _textRenderer->Render(*_mainTextShader, starGammaHint, 0.01 * _displayWidth, 0.65 * _displayHeight, 0.35, textColor);
     _textRenderer->Render(*_mainTextShader, starTemperatureHint, 0.01 * _displayWidth, 0.625 * _displayHeight, 0.35, textColor);
     _textRenderer->Render(*_mainTextShader, vertSyncHint, 0.01 * _displayWidth, 0.6 * _displayHeight, 0.35, textColor);
-    _textRenderer->Render(*_mainTextShader, textHints, 0.01 * _displayWidth, 0.575 * _displayHeight, 0.35, textColor);
+    _textRenderer->Render(*_mainTextShader, uniformBenchmarkHint, 0.01 * _displayWidth, 0.575 * _displayHeight, 0.35, textColor);
+    _textRenderer->Render(*_mainTextShader, renderStateHint, 0.01 * _displayWidth, 0.55 * _displayHeight, 0.35, textColor);
+    _textRenderer->Render(*_mainTextShader, drawCallsHint, 0.01 * _displayWidth, 0.525 * _displayHeight, 0.35, textColor);
+    _textRenderer->Render(*_mainTextShader, cullingHint, 0.01 * _displayWidth, 0.5 * _displayHeight, 0.35, textColor);
+    _textRenderer->Render(*_mainTextShader, sphereLevelsHint, 0.01 * _displayWidth, 0.475 * _displayHeight, 0.35, textColor);
+    _textRenderer->Render(*_mainTextShader, shadowLayersHint, 0.01 * _displayWidth, 0.45 * _displayHeight, 0.35, textColor);
+    _textRenderer->Render(*_mainTextShader, eclipseShadowsHint, 0.01 * _displayWidth, 0.425 * _displayHeight, 0.35, textColor);
+    _textRenderer->Render(*_mainTextShader, sunOcclusionHint, 0.01 * _displayWidth, 0.4 * _displayHeight, 0.35, textColor);
+    _textRenderer->Render(*_mainTextShader, starPathHint, 0.01 * _displayWidth, 0.375 * _displayHeight, 0.35, textColor);
+    _textRenderer->Render(*_mainTextShader, starNoiseHint, 0.01 * _displayWidth, 0.35 * _displayHeight, 0.35, textColor);
+    _textRenderer->Render(*_mainTextShader, textHints, 0.01 * _displayWidth, 0.325 * _displayHeight, 0.35, textColor);
+
+    _renderState.Disable(GL_BLEND);
+    _renderState.Enable(GL_DEPTH_TEST);
+}
+
+void Application::UpdateFrameUniforms() {
+    // Camera, sun and light space data are the same for every program, so they are written once into the ring buffer
+    // and read by all shaders through the uniform blocks instead of being set into each program separately
+    _uniformRingBuffer->BeginFrame();
+
+    _cameraProjection = camera.GetProjectionMatrix();
+    _cameraView = camera.GetViewMatrix();
 
-    glDisable(GL_BLEND);
-    glEnable(GL_DEPTH_TEST);
+    FrameUniforms frameUniforms;
+    frameUniforms.projection = _cameraProjection;
+    frameUniforms.view = _cameraView;
+    frameUniforms.cameraPosition = camera.GetPosition();
+    frameUniforms.zCoef = 2.0f / glm::log2(camera.GetFar() + 1.0f); // For log z-buffer [для логарифмического z-буфера]
+    frameUniforms.lightPosition = _sun->GetPosition();
+    frameUniforms.farPlane = camera.GetFar();
+    frameUniforms.starGlowTint = _sun->GetGlowTintMult();
+    frameUniforms.time = static_cast<float>(glfwGetTime());
+    _uniformRingBuffer->Bind<FrameUniforms>(FrameBlockBinding, _uniformRingBuffer->Write(frameUniforms));
 }
 
-void Application::ConfigureMainShaders() {
-    static const double zCoef = 2.0 / glm::log2(camera.GetFar() + 1.0); // For log z-buffer [для логарифмического z-буфера]
+void Application::UpdateSceneComponentsVisibility() {
+    // The bodies are moved in their own passes, so the spheres are built from the positions of the previous frame.
+    // The margin covers the motion over one frame and the satellites of Mars, whose models are not spheres
+    constexpr float boundsMargin = 1.25f;
+
+    // Bodies and shells of all components are tested against the frustum in one batch:
+    // per component its planet, satellites, atmospheres, clouds and ring, followed by the sphere enclosing all of them
+    _boundingSpheres.clear();
+    for (const auto& component : _renderableSceneComponents) {
+        const size_t firstSphere = _boundingSpheres.size();
+        _boundingSpheres.push_back({component.planet->GetPosition(), component.planet->GetRadius() * boundsMargin});
+
+        for (const auto& satellite : component.satellites)
+            _boundingSpheres.push_back({satellite->GetPosition(), satellite->GetRadius() * boundsMargin});
+
+        for (const auto& renderableAtmosphere : component.atmospheres)
+            _boundingSpheres.push_back({renderableAtmosphere.atmosphere->GetParent()->GetPosition(), renderableAtmosphere.atmosphere->GetAtmosphereOuterBoundary() * boundsMargin});
+
+        if (component.clouds)
+            _boundingSpheres.push_back({component.clouds->GetParent()->GetPosition(), component.clouds->GetRadius() * boundsMargin});
+
+        if (component.planetaryRing)
+            _boundingSpheres.push_back({component.planet->GetPosition(), component.planetaryRing->GetOuterRadius() * boundsMargin});
+
+        BoundingSphere componentSphere{component.planet->GetPosition(), 0.0f};
+        for (size_t i = firstSphere; i < _boundingSpheres.size(); i++) {
+            const BoundingSphere& sphere = _boundingSpheres[i];
+            componentSphere.radius = std::max(componentSphere.radius, glm::length(sphere.center - componentSphere.center) + sphere.radius);
+        }
+
+        _boundingSpheres.push_back(componentSphere);
+    }
+
+    Frustum(_cameraProjection * _cameraView).TestSpheres(_boundingSpheres, _boundingSpheresVisibility);
+
+    CullingStatistics statistics;
+    size_t sphereIndex = 0;
+    const auto countVisibility = [&statistics, this](size_t sphere) {
+        const bool isVisible = _boundingSpheresVisibility[sphere] != 0;
+        statistics.testedObjects++;
+        statistics.culledObjects += !isVisible;
+        return isVisible;
+    };
+
+    for (auto& component : _renderableSceneComponents) {
+        auto& visibility = component.visibility;
+        visibility.isPlanet = countVisibility(sphereIndex++);
+
+        visibility.satellites.resize(component.satellites.size());
+        for (auto& isSatellite : visibility.satellites)
+            isSatellite = countVisibility(sphereIndex++);
+
+        visibility.atmospheres.resize(component.atmospheres.size());
+        for (auto& isAtmosphere : visibility.atmospheres)
+            isAtmosphere = countVisibility(sphereIndex++);
+
+        visibility.isClouds = component.clouds && countVisibility(sphereIndex++);
+        visibility.isRing = component.planetaryRing && countVisibility(sphereIndex++);
+
+        visibility.isComponent = _boundingSpheresVisibility[sphereIndex++] != 0;
+        statistics.culledComponents += !visibility.isComponent;
+
+        if (visibility.isComponent)
+            SelectSphereLevels(component);
+    }
+
+    _lastFrameCulling = statistics;
+}
+
+void Application::UpdateLightSpaceMatrices() {
+    _lights.clear();
+    for (auto& component : _renderableSceneComponents) {
+        if (component.visibility.isComponent)
+            FitLightFrustum(component);
+
+        _lights.push_back(MakeLightUniforms(component));
+        component.lightBlockOffset = _uniformRingBuffer->Write(_lights.back());
+    }
+
+    // The instanced programs draw the bodies of several components at once, so they read all the lights as an array
+    const auto lightsSize = static_cast<GLsizeiptr>(_lights.size() * sizeof(LightUniforms));
+    _uniformRingBuffer->BindStorage(LightBufferBinding, _uniformRingBuffer->Write(_lights.data(), lightsSize), lightsSize);
+}
+
+LightUniforms Application::MakeLightUniforms(const RenderableSceneComponent& component) const {
+    LightUniforms lightUniforms{};
+    lightUniforms.lightSpaceMatrix = component.lightSpaceMatrix;
+    lightUniforms.shadowLayer = static_cast<int32_t>(component.shadowLayer);
+    lightUniforms.depthNear = component.lightDepthRange.x;
+    lightUniforms.depthFar = component.lightDepthRange.y;
+    lightUniforms.sunRadius = glm::length(glm::vec3(_sun->GetModelMatrix()[0])) * SphereLodChain::SPHERE_MODEL_RADIUS;
+
+    if (const PlanetaryRing* ring = component.planetaryRing.get()) {
+        lightUniforms.hasRing = 1;
+        lightUniforms.parentPlanetCenter = component.planet->GetPosition();
+        lightUniforms.parentPlanetRadiusSquared = component.planet->GetRadius() * component.planet->GetRadius();
+        lightUniforms.ringCenter = ring->GetPosition();
+        lightUniforms.ringNormal = ring->GetRingNormal();
+        lightUniforms.ringInnerRadius = ring->GetInnerRadius();
+        lightUniforms.ringOuterRadius = ring->GetOuterRadius();
+    }
+
+    if (!isEclipseShadows)
+        return lightUniforms;
+
+    // The spheres are taken before the bodies are moved in this frame, their shadows lag behind by a frame.
+    // Without a ring and irregular satellites nothing is left for the shadow map of the component
+    bool hasShadowMapCasters = component.planetaryRing != nullptr;
+    const auto addEclipseCaster = [this, &lightUniforms, &hasShadowMapCasters](const SpaceObject& body, float radius) {
+        if (!_sphereLods->IsSphere(body.GetModel())) {
+            hasShadowMapCasters = true;
+            return;
+        }
+
+        if (lightUniforms.eclipseCastersCount < MAX_ECLIPSE_CASTERS)
+            lightUniforms.eclipseCasters[lightUniforms.eclipseCastersCount++] = glm::vec4(body.GetPosition(), radius);
+    };
+
+    addEclipseCaster(*component.planet, component.planet->GetRadius());
+    for (const auto& satellite : component.satellites)
+        addEclipseCaster(*satellite, satellite->GetRadius());
 
+    if (!hasShadowMapCasters)
+        lightUniforms.shadowLayer = -1;
+
+    return lightUniforms;
+}
+
+int32_t Application::FindEclipseCaster(const RenderableSceneComponent& component, const SpaceObject& body) const {
+    // The spheres are counted in the order in which MakeLightUniforms adds them
+    if (!_sphereLods->IsSphere(body.GetModel()))
+        return -1;
+
+    if (&body == component.planet.get())
+        return 0;
+
+    int32_t index = _sphereLods->IsSphere(component.planet->GetModel()) ? 1 : 0;
+    for (const auto& satellite : component.satellites) {
+        if (satellite.get() == &body)
+            break;
+        if (_sphereLods->IsSphere(satellite->GetModel()))
+            index++;
+    }
+
+    return index < MAX_ECLIPSE_CASTERS ? index : -1;
+}
+
+void Application::FitLightFrustum(RenderableSceneComponent& component) const {
+    // The light frustum covers the bodies which can shadow each other as seen from the sun: the planet with its shells and ring
+    // and the satellites whose discs overlap another disc. The others neither cast nor receive shadows, so they only widen the depth range.
+    // The bounds are snapped to a grid, so the matrix and the cached layer (see ShadowCache) stay the same while the satellites barely move
+    constexpr float boundsMargin = 1.05f; // The bodies are moved after the fit
+    constexpr float gridStepInPlanetRadii = 0.125f;
+    constexpr float texelsPerPixel = 1.0f;
+    constexpr float minLayerScale = 0.125f;
+
+    const glm::vec3 planetPosition = component.planet->GetPosition();
+    const glm::mat4 lightView = glm::lookAt(_sun->GetPosition(), planetPosition, glm::vec3(0.0, 1.0, 0.0));
+
+    float centralRadius = component.planet->GetRadius();
+    for (const auto& renderableAtmosphere : component.atmospheres)
+        centralRadius = std::max(centralRadius, renderableAtmosphere.atmosphere->GetAtmosphereOuterBoundary());
+    if (component.clouds)
+        centralRadius = std::max(centralRadius, component.clouds->GetRadius());
+    if (component.planetaryRing)
+        centralRadius = std::max(centralRadius, component.planetaryRing->GetOuterRadius());
+
+    // In the light view space, the first sphere encloses the planet with its shells and ring
+    vector<BoundingSphere> spheres = {{glm::vec3(lightView * glm::vec4(planetPosition, 1.0f)), centralRadius * boundsMargin}};
+    for (const auto& satellite : component.satellites)
+        spheres.push_back({glm::vec3(lightView * glm::vec4(satellite->GetPosition(), 1.0f)), satellite->GetRadius() * boundsMargin});
+
+    vector<uint8_t> isFitted(spheres.size(), 0);
+    isFitted[0] = 1;
+    for (size_t i = 1; i < spheres.size(); i++) {
+        for (size_t j = 0; j < spheres.size(); j++) {
+            if (i != j && glm::length(glm::vec2(spheres[i].center) - glm::vec2(spheres[j].center)) < spheres[i].radius + spheres[j].radius)
+                isFitted[i] = isFitted[j] = 1;
+        }
+    }
+
+    glm::vec2 minBounds(std::numeric_limits<float>::max()), maxBounds(std::numeric_limits<float>::lowest());
+    float nearPlane = std::numeric_limits<float>::max(), farPlane = std::numeric_limits<float>::lowest();
+    for (size_t i = 0; i < spheres.size(); i++) {
+        const BoundingSphere& sphere = spheres[i];
+        nearPlane = std::min(nearPlane, -sphere.center.z - sphere.radius); // The view looks along -z
+        farPlane = std::max(farPlane, -sphere.center.z + sphere.radius);
+
+        if (isFitted[i]) {
+            minBounds = glm::min(minBounds, glm::vec2(sphere.center) - sphere.radius);
+            maxBounds = glm::max(maxBounds, glm::vec2(sphere.center) + sphere.radius);
+        }
+    }
+
+    const float gridStep = component.planet->GetRadius() * gridStepInPlanetRadii;
+    minBounds = glm::floor(minBounds / gridStep) * gridStep;
+    maxBounds = glm::ceil(maxBounds / gridStep) * gridStep;
+    nearPlane = std::floor(nearPlane / gridStep) * gridStep;
+    farPlane = std::ceil(farPlane / gridStep) * gridStep;
+
+    // The part of the layer follows the size of the component on the screen, a distant one is drawn into a corner of its layer.
+    // The rest of the layer is not sampled, the bodies outside the fit project outside the part or beyond the border
+    const glm::vec2 boundsCenter = 0.5f * (minBounds + maxBounds);
+    const glm::vec3 fitCenter = glm::vec3(glm::inverse(lightView) * glm::vec4(boundsCenter, -0.5f * (nearPlane + farPlane), 1.0f));
+    const float fitRadius = 0.5f * std::max(maxBounds.x - minBounds.x, maxBounds.y - minBounds.y);
+    const float projectedRadius = SphereLodChain::CalculateProjectedRadius(fitRadius, glm::length(camera.GetPosition() - fitCenter), _cameraProjection,
+                                                                           _displayHeight);
+
+    float layerScale = 1.0f;
+    while (layerScale > minLayerScale && 2.0f * projectedRadius * texelsPerPixel <= 0.5f * layerScale * _shadowMapFBO->GetShadowMapWidth())
+        layerScale *= 0.5f;
+
+    const glm::mat4 layerPart = glm::translate(glm::mat4(1.0f), glm::vec3(layerScale - 1.0f, layerScale - 1.0f, 0.0f)) *
+                                glm::scale(glm::mat4(1.0f), glm::vec3(layerScale, layerScale, 1.0f));
+    component.lightSpaceMatrix = layerPart * glm::ortho(minBounds.x, maxBounds.x, minBounds.y, maxBounds.y, nearPlane, farPlane) * lightView;
+    component.lightDepthRange = glm::vec2(nearPlane, farPlane);
+}
+
+void Application::SelectSphereLevels(RenderableSceneComponent& component) const {
+    auto& visibility = component.visibility;
+    const float planetDistance = CalculateSpaceObjectDistance(component.planet.get());
+
+    // Shadows of the bodies fall on the planet and its satellites, so a caster is tessellated for the nearest of itself and the planet
+    const auto selectLevels = [this, planetDistance](const SpaceObject& body, float radius, size_t& level, size_t& shadowLevel) {
+        if (!_sphereLods->IsSphere(body.GetModel())) {
+            level = shadowLevel = 0;
+            return;
+        }
+
+        const float distance = CalculateSpaceObjectDistance(&body);
+        level = _sphereLods->SelectLevel(SphereLodChain::CalculateProjectedRadius(radius, distance, _cameraProjection, _displayHeight));
+        shadowLevel = _sphereLods->SelectMeshLevel(SphereLodChain::CalculateProjectedRadius(radius, std::min(distance, planetDistance), _cameraProjection,
+                                                                                            _displayHeight));
+    };
+
+    selectLevels(*component.planet, component.planet->GetRadius(), visibility.planetLevel, visibility.planetShadowLevel);
+
+    visibility.satelliteLevels.resize(component.satellites.size());
+    visibility.satelliteShadowLevels.resize(component.satellites.size());
+    for (size_t i = 0; i < component.satellites.size(); i++)
+        selectLevels(*component.satellites[i], component.satellites[i]->GetRadius(), visibility.satelliteLevels[i], visibility.satelliteShadowLevels[i]);
+}
+
+void Application::ConfigureMainShaders() {
     // So that zoom does not work with skybox
     static const glm::mat4 skyBoxProjection = glm::perspective(glm::radians(45.0f), camera.GetAspect(), camera.GetNear(), camera.GetFar());
 
-    _cameraProjection = camera.GetProjectionMatrix();
-    _cameraView = camera.GetViewMatrix();
-
     _mainSkyBoxShader->Use();
-    _mainSkyBoxShader->SetMat4("view", glm::mat4(glm::mat3(_cameraView)));
     _mainSkyBoxShader->SetMat4("projection", skyBoxProjection);
 
     _mainTextShader->Use();
-    _mainTextShader->SetMat4("projection", _cameraProjection);
-    _mainTextShader->SetMat4("view", _cameraView);
     _mainTextShader->SetInt("text", 0);
 
     _mainStarShader->Use();
-    _mainStarShader->SetMat4("projection", _cameraProjection);
-    _mainStarShader->SetMat4("view", _cameraView);
     _mainStarShader->SetVec3("centerDir", glm::normalize(camera.GetPosition() - _sun->GetPosition()));
     _mainStarShader->SetVec3("shiftStarColor", _sun->GetShiftColor());
     _mainStarShader->SetVec3("colorMult", glm::vec3(0.96862745, 0.58039215, 0.235294117) * _sun->GetShiftColor()); // 247, 148, 60
     _mainStarShader->SetFloat("sunTemperatureInKelvin", _sun->GetStarTemperatureInKelvin());
     _mainStarShader->SetFloat("starRadiusInKilometers", _sun->GetStarRadius());
-    _mainStarShader->SetFloat("zCoef", zCoef);
     _mainStarShader->SetFloat("uColorMap", _sun->GetTemperatureColorUCoordinate());
-    _mainStarShader->SetBool("isVisible", _sun->GetVisibility() == 1.0);
+    _mainStarShader->SetBool("isVisible", _sunMeasuredVisibility == 1.0f);
     _mainStarShader->SetInt("colorMap", 0);
     glBindTextureUnit(0, _sun->GetStarSpectrumTexture());
 
     _mainCoronaStarShader->Use();
-    _mainCoronaStarShader->SetMat4("projection", _cameraProjection);
-    _mainCoronaStarShader->SetMat4("view", _cameraView);
     _mainCoronaStarShader->SetVec3("center", _sun->GetPosition());
     _mainCoronaStarShader->SetVec3("cameraRight", camera.GetRightVector());
     _mainCoronaStarShader->SetVec3("cameraUp", camera.GetUpVector());
     _mainCoronaStarShader->SetVec3("starShiftColor", _sun->GetShiftColor());
-    _mainCoronaStarShader->SetFloat("zCoef", zCoef);
     _mainCoronaStarShader->SetFloat("maxSize", 7.1);
     _mainCoronaStarShader->SetFloat("starRadius", _sun->GetStarRadius());
-    _mainCoronaStarShader->SetFloat("deltaTime", glfwGetTime() * 0.002);
-
-    _mainPlanetShader->Use();
-    _mainPlanetShader->SetMat4("projection", _cameraProjection);
-    _mainPlanetShader->SetMat4("view", _cameraView);
-    _mainPlanetShader->SetVec3("viewPos", camera.GetPosition());
-    _mainPlanetShader->SetVec3("lightPos", _sun->GetPosition());
-    _mainPlanetShader->SetVec3("starGlowTint", _sun->GetGlowTintMult());
-    _mainPlanetShader->SetFloat("farPlane", camera.GetFar());
-    _mainPlanetShader->SetFloat("zCoef", zCoef);
-    _mainPlanetShader->SetFloat("bias", 0.0005);
-    _mainPlanetShader->SetInt("shadowMap", 6);
+
+    // The baked noise is animated in steps of 1 / starNoiseUpdateRate seconds, the procedural one keeps frame.time
+    const auto noiseTime = static_cast<float>(std::floor(glfwGetTime() * starNoiseUpdateRate) / starNoiseUpdateRate);
+    for (const Shader* starShader : {_mainStarShader.get(), _mainCoronaStarShader.get()}) {
+        starShader->Use();
+        starShader->SetBool("isBakedNoise", isBakedStarNoise);
+        starShader->SetInt("noiseVolume", 13);
+        starShader->SetFloat("noisePeriod", _starNoiseVolume->GetPeriod());
+        starShader->SetFloat("noiseTime", noiseTime);
+    }
+    glBindTextureUnit(13, _starNoiseVolume->GetTexture());
+    _sun->SetNoiseVolume(isBakedStarNoise ? _starNoiseVolume.get() : nullptr);
+
+    for (const Shader* planetShader : {_mainPlanetShader.get(), _instancedPlanetShader.get(), _impostorPlanetShader.get(), _instancedImpostorShader.get()}) {
+        planetShader->Use();
+        planetShader->SetFloat("bias", 10.0); // In units of distance from the sun, see ShadowDepthBias
+        planetShader->SetInt("shadowMap", 6);
+        planetShader->SetInt("shadowMapCompare", 7);
+    }
     glBindTextureUnit(6, _shadowMapFBO->GetShadowMap());
+    glBindTextureUnit(7, _shadowMapFBO->GetShadowMap());
+    glBindSampler(7, _shadowMapFBO->GetCompareSampler()); // The same texture, compared by the hardware
 
     _mainAtmosphereShader->Use();
-    _mainAtmosphereShader->SetMat4("projection", _cameraProjection);
-    _mainAtmosphereShader->SetMat4("view", _cameraView);
-    _mainAtmosphereShader->SetFloat("farPlane", camera.GetFar());
-    _mainAtmosphereShader->SetFloat("zCoef", zCoef);
-    _mainAtmosphereShader->SetFloat("bias", 0.001);
+    _mainAtmosphereShader->SetFloat("bias", 20.0);
     _mainAtmosphereShader->SetInt("shadowMap", 11);
     glBindTextureUnit(11, _shadowMapFBO->GetShadowMap());
 
     _mainCloudsShader->Use();
-    _mainCloudsShader->SetMat4("projection", _cameraProjection);
-    _mainCloudsShader->SetMat4("view", _cameraView);
-    _mainCloudsShader->SetVec3("viewPos", camera.GetPosition());
-    _mainCloudsShader->SetVec3("lightPos", _sun->GetPosition());
-    _mainCloudsShader->SetFloat("farPlane", camera.GetFar());
-    _mainCloudsShader->SetFloat("zCoef", zCoef);
-    _mainCloudsShader->SetFloat("bias", 0.001);
-    _mainCloudsShader->SetInt("shadowMap", 8);
+    _mainCloudsShader->SetFloat("bias", 20.0);
+    _mainCloudsShader->SetInt("shadowMapCompare", 8);
     glBindTextureUnit(8, _shadowMapFBO->GetShadowMap());
+    glBindSampler(8, _shadowMapFBO->GetCompareSampler());
+
+    MaterialTable::Instance().Bind(); // Uploads the materials of the planetary systems created during this frame
 
     _mainRingShader->Use();
-    _mainRingShader->SetMat4("projection", _cameraProjection);
-    _mainRingShader->SetMat4("view", _cameraView);
-    _mainRingShader->SetVec3("lightPos", _sun->GetPosition());
-    _mainRingShader->SetVec3("camPos", camera.GetPosition());
-    _mainRingShader->SetVec3("starGlowTint", _sun->GetGlowTintMult());
-    _mainRingShader->SetFloat("zCoef", zCoef);
-    _mainRingShader->SetFloat("bias", 0.001);
-    _mainRingShader->SetInt("shadowMap", 5);
+    _mainRingShader->SetFloat("bias", 20.0);
+    _mainRingShader->SetInt("shadowMapCompare", 5);
     glBindTextureUnit(5, _shadowMapFBO->GetShadowMap());
+    glBindSampler(5, _shadowMapFBO->GetCompareSampler());
 }
 
-void Application::ConfigureMainPlanetShader(const RenderableSceneComponent& renderableComponent) {
-    _mainPlanetShader->SetMat4("lightSpaceMatrix", renderableComponent.lightSpaceMatrix);
-    _mainPlanetShader->SetBool("isNearbyPlanetaryRing", renderableComponent.planetaryRing != nullptr);
-
+void Application::ConfigurePlanetShader(const Shader& shader, const PlanetComponentUniforms& uniforms, const RenderableSceneComponent& renderableComponent) {
     if (renderableComponent.clouds)
-        _mainPlanetShader->SetFloat("yRotation", renderableComponent.clouds->GetLastRotationAngle() - renderableComponent.planet->GetLastRotationAngle());
+        shader.Set(uniforms.yRotation, renderableComponent.clouds->GetLastRotationAngle() - renderableComponent.planet->GetLastRotationAngle());
+
+    if (renderableComponent.planetaryRing)
+        glBindTextureUnit(InstanceBatcher::RING_TEXTURE_UNIT, renderableComponent.planetaryRing->GetRingTexture());
+}
 
-    if (renderableComponent.planetaryRing) {
-        _mainPlanetShader->SetVec3("parentPlanetCenter", renderableComponent.planet->GetPosition());
-        _mainPlanetShader->SetFloat("parentPlanetRadiusSquared", renderableComponent.planet->GetRadius() * renderableComponent.planet->GetRadius());
+void Application::UpdateStarStatistics() {
+    // Read back without waiting, like the occlusion queries, so the numbers in the hints lag behind by a few frames
+    if (_starFragmentQueries)
+        _starFragmentQueries->ReadResult(_starFragmentInvocations);
 
-        _mainPlanetShader->SetVec3("ringCenter", renderableComponent.planetaryRing->GetPosition());
-        _mainPlanetShader->SetVec3("ringNormal", renderableComponent.planetaryRing->GetRingNormal());
-        _mainPlanetShader->SetVec2("ringInnerOuterRadiuses", glm::vec2(renderableComponent.planetaryRing->GetInnerRadius(),
-                                                                       renderableComponent.planetaryRing->GetOuterRadius()));
-        _mainPlanetShader->SetInt("ringDiffuse", 12);
-        glBindTextureUnit(12, renderableComponent.planetaryRing->GetRingTexture());
-    }
+    for (size_t i = 0; i < _starTimeQueries.size(); i++)
+        _starTimeQueries[i]->ReadResult(_starTimes[i]);
 }
 
-void Application::UpdateOcclusionQuery() {
+void Application::UpdateSunVisibility() {
     // Idea: a single query will tell us how many pixels passed, but we also need to know how many pixels are visible when
     // the object isn't occluded so that we can determine what fraction of the pixels passed the test.
     // For this reason, we will actually do 2 occlusion tests. One will turn off depth testing so that it always passes, and
@@ -524,29 +1119,132 @@ void Application::UpdateOcclusionQuery() {
     // Один отключит проверку глубины, чтобы она всегда проходила, а другой включит проверку глубины. Мы можем определить, какая часть звезды видна,
     // взяв passedSamples / totalSamples и используя их для уменьшения или увеличения бликов и свечения линз, когда звезда закрывается объектом.]
 
-    if (_sun->GetStarOcclusionValue(0) == 0) {
-        glGenQueries(2, _sun->GetStarOcclusion().data());
-    }
-    else {
-        GLint totalSamples = 0;
-        GLint passedSamples = 0;
+    // The results are read a few frames after the queries were issued, only when they are already available, so the pipeline is not stalled.
+    // The visibility given to the sun follows the measured one exponentially, which hides both the latency and the frames without a new result
+    _sunOcclusionQueries->ReadVisibility(_sunMeasuredVisibility);
 
-        glGetQueryObjectiv(_sun->GetStarOcclusionValue(0), GL_QUERY_RESULT, &totalSamples);
-        glGetQueryObjectiv(_sun->GetStarOcclusionValue(1), GL_QUERY_RESULT, &passedSamples);
+    constexpr float smoothingTime = 0.1f; // Seconds
+    const float current = _sun->GetVisibility();
+    float smoothed = current + (_sunMeasuredVisibility - current) * (1.0f - std::exp(-static_cast<float>(deltaTime) / smoothingTime));
+    if (std::abs(_sunMeasuredVisibility - smoothed) < 0.001f)
+        smoothed = _sunMeasuredVisibility;
+
+    _sun->SetVisibility(smoothed);
+}
+
+void Application::UpdateSceneComponentsResidency() {
+    for (auto& component : _renderableSceneComponents) {
+        if (component.lazyParts.empty())
+            continue;
+
+        const float distance = CalculateSpaceObjectDistance(component.planet.get());
+        const wstring& engName = component.planet->GetEngName();
+        const auto name = [&engName] { return string(engName.cbegin(), engName.cend()); }; // English names are ASCII, only for the log
+
+        switch (component.residency) {
+            case SceneComponentResidency::Proxy:
+                if (distance < component.loadDistance) {
+                    vector<string> texturePaths;
+                    for (const auto& part : component.lazyParts)
+                        texturePaths.insert(texturePaths.end(), part.texturePaths.cbegin(), part.texturePaths.cend());
+
+                    _textureLoader->Prefetch(texturePaths);
+                    component.residency = SceneComponentResidency::Loading;
+                    cout << name() << " system is loading (distance " << distance << ")" << endl;
+                }
+                break;
+
+            case SceneComponentResidency::Loading: {
+                // At most one part per frame and only after the workers have parsed its textures, so that the main thread never waits for them.
+                // A system, which the camera left while it was loading, is finished first and unloaded afterwards
+                auto& part = component.lazyParts[component.materializedPartsCount];
+                const bool isReady = all_of(part.texturePaths.cbegin(), part.texturePaths.cend(), [this](const string& path) { return _textureLoader->IsReady(path); });
+
+                if (isReady) {
+                    part.materialize(component);
+
+                    if (++component.materializedPartsCount == component.lazyParts.size()) {
+                        component.residency = SceneComponentResidency::Resident;
+                        cout << name() << " system is resident, streamed textures take " << _textureStreamer->GetResidentBytes() / (1024 * 1024) << " MB" << endl;
+                    }
+                }
+                break;
+            }
 
-        if (passedSamples == 0) {
-            _sun->SetVisibility(0.0f);
+            case SceneComponentResidency::Resident:
+                if (distance > component.unloadDistance) {
+                    DematerializeSceneComponent(component);
+                    _instanceBatcher->ReleaseUnusedTextures();
+                    cout << name() << " system is unloaded (distance " << distance << ")" << endl;
+                }
+                break;
         }
-        else {
-            _sun->SetVisibility(static_cast<float>(passedSamples) / static_cast<float>(totalSamples));
+    }
+}
+
+void Application::UpdateTextureStreaming() {
+    // Pixels per unit of size at unit distance, the same for all bodies in this frame
+    const float focalLength = static_cast<float>(_displayHeight) / (2.0f * tan(glm::radians(camera.GetZoom()) / 2.0f));
+
+    // A surface map is wrapped around the whole sphere, so around the equator it needs pi texels per pixel of the visible diameter
+    auto requestSurfaceTextures = [&](const SpaceObject* spaceObject, float radius, const vector<TextureImage2D>& textures) {
+        const float distance = max(CalculateSpaceObjectDistance(spaceObject) - radius, camera.GetNear());
+        const float screenSize = glm::pi<float>() * 2.0f * radius / distance * focalLength;
+
+        for (const auto& texture : textures)
+            _textureStreamer->Request(texture, screenSize);
+    };
+
+    for (const auto& component : _renderableSceneComponents) {
+        requestSurfaceTextures(component.planet.get(), component.planet->GetRadius(), component.planet->GetSurfaceTextures());
+
+        // The surface textures of the satellites are moved into the texture arrays, which upload their levels themselves
+
+        if (component.clouds)
+            requestSurfaceTextures(component.planet.get(), component.planet->GetRadius(), component.clouds->GetTextures());
+
+        if (component.planetaryRing) { // The width of a ring texture goes across the ring, from the inner to the outer radius
+            const PlanetaryRing* ring = component.planetaryRing.get();
+            const float distance = max(CalculateSpaceObjectDistance(ring) - ring->GetOuterRadius(), camera.GetNear());
+            const float screenSize = (ring->GetOuterRadius() - ring->GetInnerRadius()) / distance * focalLength;
+
+            for (const auto& texture : ring->GetTextures())
+                _textureStreamer->Request(texture, screenSize);
         }
     }
+
+    _textureStreamer->SetReservedBytes(_instanceBatcher->GetTexturesSizeInBytes()); // The arrays share the budget with the streamed textures
+    _textureStreamer->Update();
+    _instanceBatcher->UpdateTextures();
 }
 
 float Application::CalculateSpaceObjectDistance(const SpaceObject* spaceObject) const {
     return glm::length(spaceObject->GetPosition() - camera.GetPosition());
 }
 
+const MeshHolder& Application::GetLevelModel(const SpaceObject& body, size_t level) const {
+    return level == 0 ? body.GetModel() : _sphereLods->GetLevel(level);
+}
+
+void Application::SetResidencyDistances(RenderableSceneComponent& component, float systemRadius) {
+    // A system is loaded when its outermost satellite orbit takes about a tenth of the screen height, or when the planet itself is large enough
+    // for its atmosphere to be noticed. It is unloaded a quarter farther away
+    constexpr float loadDistanceBySystemRadius = 10.0f, loadDistanceByPlanetRadius = 60.0f, unloadDistanceFactor = 1.25f;
+
+    component.loadDistance = max(systemRadius * loadDistanceBySystemRadius, component.planet->GetRadius() * loadDistanceByPlanetRadius);
+    component.unloadDistance = component.loadDistance * unloadDistanceFactor;
+}
+
+void Application::DematerializeSceneComponent(RenderableSceneComponent& component) {
+    // Textures and meshes are deleted together with the last object using them, the planet stays as a proxy
+    component.atmospheres.clear(); // They refer to the satellites
+    component.satellites.clear();
+    component.clouds.reset();
+    component.planetaryRing.reset();
+    component.materializedPartsCount = 0;
+    component.residency = SceneComponentResidency::Proxy;
+}
+
 glm::vec3 Application::CurrentFpsColor() const {
     const auto fpsCount = _fpsHandler.GetCurrentFps();
 
@@ -561,6 +1259,7 @@ glm::vec3 Application::CurrentFpsColor() const {
 }
 
 void Application::InitSystems() {
+    ProfileScope profileScope("stage", "InitSystems");
     ios_base::sync_with_stdio(false);
     cin.tie(nullptr);
 
@@ -591,6 +1290,12 @@ void Application::InitSystems() {
     glewExperimental = true;
     glewInit();
 
+    // Let the driver compile shaders on its own threads, the link status is checked by Shader on the first use
+    if (GLEW_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    else if (GLEW_ARB_parallel_shader_compile)
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+
     FT_Init_FreeType(&_ft);
 
     _soundEngine = createIrrKlangDevice(ESOD_AUTO_DETECT, ESEO_MULTI_THREADED | ESEO_LOAD_PLUGINS);
@@ -610,21 +1315,27 @@ void Application::InitSystems() {
         throw runtime_error("Failed to init SDL_Image");
     }
 
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_MULTISAMPLE);
-    glEnable(GL_TEXTURE_2D);
-    glEnable(GL_CULL_FACE);
-    glEnable(GL_POLYGON_SMOOTH);
-    glCullFace(GL_BACK);
+    _renderState.Enable(GL_DEPTH_TEST);
+    _renderState.Enable(GL_MULTISAMPLE);
+    _renderState.Enable(GL_TEXTURE_2D);
+    _renderState.Enable(GL_CULL_FACE);
+    _renderState.Enable(GL_POLYGON_SMOOTH);
+    _renderState.SetCullFace(GL_BACK);
 
     LoadWindowIcon();
     DisplaySystemInformation();
 }
 
 void Application::InitScene() {
+    ProfileScope profileScope("stage", "InitScene");
+    VirtualFileSystem::Instance().Mount("resource.pak"); // Made by AssetBaker next to the executable
     camera.SetAspect(static_cast<float>(_displayWidth) / static_cast<float>(_displayHeight));
-    _shadowMapFBO = make_unique<ShadowMapFBO>(3000, 3000); // Planets one by one use 6000x6000
-    _hdr = make_unique<HDR>(Shader("../resource/shaders/passThrough.vs", "../resource/shaders/hdr.fs"), _displayWidth, _displayHeight);
+    _textureStreamer = make_unique<TextureStreamer>();
+    _textureLoader = make_unique<TextureLoader>(_textureStreamer.get());
+    PrefetchSceneTextures(); // DDS files are parsed by worker threads while shaders and other resources are loaded
+    _uniformRingBuffer = make_unique<UniformRingBuffer>(16 * 1024); // The frame block, a light block per scene component and the array of the lights with room to spare
+    _renderQueue.SetLightBlockBinder([this](GLintptr offset) { _uniformRingBuffer->Bind<LightUniforms>(LightBlockBinding, offset); });
+    _instanceBatcher = make_unique<InstanceBatcher>();
 
     const vector<string> skyBoxFaces = {
             "../resource/textures/Main SkyBox/PositiveX.dds",
@@ -639,15 +1350,31 @@ void Application::InitScene() {
     _mainTextShader = make_unique<Shader>("../resource/shaders/text.vs", "../resource/shaders/text.fs");
     _textRenderer = make_unique<TextRenderer>(_ft, "../resource/fonts/Arial.ttf");
     FT_Done_FreeType(_ft);
-    _shadowMapShader = make_unique<Shader>("../resource/shaders/shadowMap.vs", "../resource/shaders/shadowMap.fs");
+    // The layer of an instance is written by the vertex shader if the extension is supported, otherwise by a pass-through geometry shader
+    if (GLEW_ARB_shader_viewport_layer_array)
+        _shadowMapShader = make_unique<Shader>("../resource/shaders/shadowMap.vs", "../resource/shaders/shadowMap.fs", "", vector<string>{"INSTANCED", "VERTEX_LAYER"});
+    else
+        _shadowMapShader = make_unique<Shader>("../resource/shaders/shadowMap.vs", "../resource/shaders/shadowMap.fs", "../resource/shaders/shadowMap.gs",
+                                               vector<string>{"INSTANCED"});
     _mainSkyBoxShader = make_unique<Shader>("../resource/shaders/skyBox.vs", "../resource/shaders/skyBox.fs");
     _mainStarShader = make_unique<Shader>("../resource/shaders/star.vs", "../resource/shaders/star.fs");
     _mainCoronaStarShader = make_unique<Shader>("../resource/shaders/starCorona.vs", "../resource/shaders/starCorona.fs");
-    _mainPlanetShader = make_unique<Shader>("../resource/shaders/planetLighting.vs", "../resource/shaders/planetLighting.fs");
+    const string shadowTaps = "SHADOW_TAPS " + to_string(shadowPcfTaps), cloudsShadowTaps = "SHADOW_TAPS " + to_string(std::max(shadowPcfTaps / 2, 1));
+    _mainPlanetShader = make_unique<Shader>("../resource/shaders/planetLighting.vs", "../resource/shaders/planetLighting.fs", "", vector<string>{shadowTaps});
+    _instancedPlanetShader = make_unique<Shader>("../resource/shaders/planetLighting.vs", "../resource/shaders/planetLighting.fs", "",
+                                                 vector<string>{"INSTANCED", shadowTaps});
+    _impostorPlanetShader = make_unique<Shader>("../resource/shaders/planetLighting.vs", "../resource/shaders/planetLighting.fs", "",
+                                                vector<string>{"IMPOSTOR", shadowTaps});
+    _instancedImpostorShader = make_unique<Shader>("../resource/shaders/planetLighting.vs", "../resource/shaders/planetLighting.fs", "",
+                                                   vector<string>{"INSTANCED", "IMPOSTOR", shadowTaps});
     _mainAtmosphereShader = make_unique<Shader>("../resource/shaders/atmosphere.vs", "../resource/shaders/atmosphere.fs");
-    _mainCloudsShader = make_unique<Shader>("../resource/shaders/planetLighting.vs", "../resource/shaders/cloudsLighting.fs");
-    _mainRingShader = make_unique<Shader>("../resource/shaders/planetaryRingLighting.vs", "../resource/shaders/planetaryRingLighting.fs");
-    _lensFlare = make_unique<LensFlare>(Shader("../resource/shaders/lensFlare.vs", "../resource/shaders/lensFlare.fs"), TextureImage2D("../resource/textures/flares_bright.dds"),
+    _mainCloudsShader = make_unique<Shader>("../resource/shaders/planetLighting.vs", "../resource/shaders/cloudsLighting.fs", "", vector<string>{cloudsShadowTaps});
+    _mainRingShader = make_unique<Shader>("../resource/shaders/planetaryRingLighting.vs", "../resource/shaders/planetaryRingLighting.fs", "",
+                                          vector<string>{shadowTaps});
+    _hdr = make_unique<HDR>(Shader("../resource/shaders/passThrough.vs", "../resource/shaders/hdr.fs"), _displayWidth, _displayHeight); // Uses its shader at once, so it goes after the others are started
+    const TextureImage2D flaresTexture = _textureLoader->Load("../resource/textures/flares_bright.dds");
+    _textureStreamer->KeepResident(flaresTexture); // Not mapped onto a body, so nothing requests its levels
+    _lensFlare = make_unique<LensFlare>(Shader("../resource/shaders/lensFlare.vs", "../resource/shaders/lensFlare.fs"), flaresTexture,
             FlaresInfo {4,
             {
                 FlareSprite{false, 1.0, 7.0, 0},
@@ -659,10 +1386,35 @@ void Application::InitScene() {
                 FlareSprite{false, 2.25, 0.2, 3},
                 FlareSprite{false, 2.75, 2.0, 7}
             }});
+    _sunOcclusionQueries = make_unique<OcclusionQueryRing>(4); // Frames in flight whose results may still be on the way
+    _starOcclusionProxyShader = make_unique<Shader>("../resource/shaders/starOcclusionProxy.vs", "../resource/shaders/starOcclusionProxy.fs");
+    if (GLEW_ARB_pipeline_statistics_query)
+        _starFragmentQueries = make_unique<StatisticsQueryRing>(GL_FRAGMENT_SHADER_INVOCATIONS_ARB, 4);
+    else
+        cout << "ARB_pipeline_statistics_query is not supported, fragment invocations of the star are not measured" << endl;
+    for (auto& starTimeQueries : _starTimeQueries)
+        starTimeQueries = make_unique<StatisticsQueryRing>(GL_TIME_ELAPSED, 4);
+    _starNoiseVolume = make_unique<NoiseVolume>(128, 32); // 16 MB, 4 texels per lattice cell
 
+    InitUniformHandles();
     InitSongList();
     InitStarSystem();
 
+    for (size_t i = 0; i < _renderableSceneComponents.size(); i++)
+        _renderableSceneComponents[i].shadowLayer = i;
+
+    // A layer per component is kept between frames, see ShadowCache. The light frusta are fitted tightly, so 1500x1500 is enough
+    _shadowMapFBO = make_unique<ShadowMapFBO>(1500, 1500, static_cast<uint16_t>(_renderableSceneComponents.size()), shadowDepthFormat);
+    _shadowCache = make_unique<ShadowCache>(_renderableSceneComponents.size(), _shadowMapFBO->GetShadowMapWidth());
+    _textureLoader->PrintStatistics();
+    TextureRegistry::Instance().PrintStatistics();
+    MeshRegistry::Instance().PrintStatistics();
+    _sphereLods->PrintStatistics();
+    GeometryArena::Instance().PrintStatistics();
+    ShaderCache::Instance().PrintStatistics();
+    MaterialTable::Instance().PrintStatistics();
+    _textureStreamer->PrintStatistics();
+
     glfwShowWindow(_mainWindow);
     glfwSetWindowMonitor(_mainWindow, glfwGetPrimaryMonitor(), 0, 0, _displayWidth, _displayHeight, GLFW_DONT_CARE);
 
@@ -670,6 +1422,87 @@ void Application::InitScene() {
     StartPlayBackgroundMusic();
 }
 
+void Application::PrefetchSceneTextures() {
+    // In the order in which they are taken by InitScene and Init*System, so that the main thread rarely waits for the workers.
+    // Textures of satellites, clouds and rings are prefetched later, when the camera comes near their planet
+    _textureLoader->Prefetch({
+            "../resource/textures/flares_bright.dds",
+            "../resource/textures/Star_Spectrum.dds",
+            "../resource/textures/Neptune_Diffuse.dds",
+            "../resource/textures/Neptune_Clouds_Diffuse.dds",
+            "../resource/textures/Neptune_Normal.dds",
+            "../resource/textures/Mercury_Diffuse.dds",
+            "../resource/textures/Mercury_Normal.dds",
+            "../resource/textures/Mercury_Specular.dds",
+            "../resource/textures/Venus_Diffuse.dds",
+            "../resource/textures/Venus_Normal.dds",
+            "../resource/textures/Mars_Diffuse.dds",
+            "../resource/textures/Mars_Normal.dds",
+            "../resource/textures/Earth_Day_Diffuse.dds",
+            "../resource/textures/Earth_Clouds_Diffuse.dds",
+            "../resource/textures/Earth_Night_Diffuse.dds",
+            "../resource/textures/Earth_Normal.dds",
+            "../resource/textures/Earth_Specular.dds",
+            "../resource/textures/Jupiter_Diffuse.dds",
+            "../resource/textures/Jupiter_Normal.dds",
+            "../resource/textures/Uranus_Diffuse.dds",
+            "../resource/textures/Uranus_Clouds_Diffuse.dds",
+            "../resource/textures/Uranus_Normal.dds",
+            "../resource/textures/Saturn_Diffuse.dds",
+            "../resource/textures/Saturn_Normal.dds",
+            "../resource/textures/Pluto_Diffuse.dds",
+            "../resource/textures/Pluto_Normal.dds",
+            "../resource/textures/Pluto_Specular.dds"
+    });
+}
+
+void Application::InitUniformHandles() {
+    // After all shaders are created, since a handle waits for its program to be linked
+    const Shader& atmosphereShader = *_mainAtmosphereShader;
+    _atmosphereUniforms.camPosition = atmosphereShader.GetUniformHandle<glm::vec3>("camPosition");
+    _atmosphereUniforms.lightPos = atmosphereShader.GetUniformHandle<glm::vec3>("lightPos");
+    _atmosphereUniforms.mieTint = atmosphereShader.GetUniformHandle<glm::vec3>("mieTint");
+    _atmosphereUniforms.hScaleFactor = atmosphereShader.GetUniformHandle<float>("SCALE_H_FACTOR");
+    _atmosphereUniforms.earthSizeCoefficient = atmosphereShader.GetUniformHandle<float>("earthSizeCoefficient");
+    _atmosphereUniforms.isUseToneMapping = atmosphereShader.GetUniformHandle<bool>("isUseToneMapping");
+    _atmosphereUniforms.isNearbyPlanetaryRing = atmosphereShader.GetUniformHandle<bool>("isNearbyPlanetaryRing");
+    _atmosphereUniforms.ringParentPlanetCenter = atmosphereShader.GetUniformHandle<glm::vec3>("ringParentPlanetCenter");
+    _atmosphereUniforms.ringParentPlanetRadiusSquared = atmosphereShader.GetUniformHandle<float>("ringParentPlanetRadiusSquared");
+    _atmosphereUniforms.isUseSphereIntersect = atmosphereShader.GetUniformHandle<bool>("isUseSphereIntersect");
+    _atmosphereUniforms.ringCenter = atmosphereShader.GetUniformHandle<glm::vec3>("ringCenter");
+    _atmosphereUniforms.ringNormal = atmosphereShader.GetUniformHandle<glm::vec3>("ringNormal");
+    _atmosphereUniforms.ringInnerOuterRadiuses = atmosphereShader.GetUniformHandle<glm::vec2>("ringInnerOuterRadiuses");
+    _atmosphereUniforms.ringDiffuse = atmosphereShader.GetUniformHandle<int>("ringDiffuse");
+    _atmosphereUniforms.eclipseCaster = atmosphereShader.GetUniformHandle<int>("eclipseCaster");
+
+    // The mesh and impostor variants are different programs, so their locations are resolved separately. The instanced ones take everything from the instance
+    const auto readPlanetComponentUniforms = [](const Shader& planetShader) {
+        PlanetComponentUniforms uniforms;
+        uniforms.yRotation = planetShader.GetUniformHandle<float>("yRotation");
+        uniforms.eclipseCaster = planetShader.GetUniformHandle<int>("eclipseCaster");
+        return uniforms;
+    };
+
+    _planetComponentUniforms = readPlanetComponentUniforms(*_mainPlanetShader);
+    _impostorComponentUniforms = readPlanetComponentUniforms(*_impostorPlanetShader);
+    _cloudsEclipseCaster = _mainCloudsShader->GetUniformHandle<int>("eclipseCaster");
+
+    // Material textures always occupy the units of their slots (see SpaceObject::Render and InstanceBatcher::Flush), so the samplers are set once
+    for (const Shader* planetShader : {_mainPlanetShader.get(), _instancedPlanetShader.get(), _impostorPlanetShader.get(), _instancedImpostorShader.get()}) {
+        planetShader->Use();
+        planetShader->SetInt("mainDiffuseTexture", DiffuseSlot);
+        planetShader->SetInt("cloudTexture", CloudSlot);
+        planetShader->SetInt("nightTexture", NightSlot);
+        planetShader->SetInt("normalMap", NormalSlot);
+        planetShader->SetInt("specularMap", SpecularSlot);
+        planetShader->SetInt("ringDiffuse", InstanceBatcher::RING_TEXTURE_UNIT);
+    }
+
+    _mainCloudsShader->Use();
+    _mainCloudsShader->SetInt("mainDiffuseTexture", DiffuseSlot);
+    _mainCloudsShader->SetInt("cloudsNormalMap", NormalSlot);
+}
+
 void Application::InitSongList() {
     _backgroundSongs = vector<string_view> {
             "../resource/sounds/Stellardrone - Galaxies.mp3",
@@ -689,13 +1522,23 @@ void Application::InitSongList() {
 }
 
 void Application::InitStarSystem() {
+    ProfileScope profileScope("stage", "InitStarSystem");
     MeshHolder sphereModel("../resource/models/sphere.obj");
+    _sphereLods = make_unique<SphereLodChain>(sphereModel);
+
+    const SphereUvMapping& uvMapping = _sphereLods->GetUvMapping();
+    for (const Shader* impostorShader : {_impostorPlanetShader.get(), _instancedImpostorShader.get()}) {
+        impostorShader->Use();
+        impostorShader->SetVec3("sphereUvMapping", glm::vec3(uvMapping.uSign, uvMapping.uOffset, uvMapping.vSign));
+    }
 
-    StarInfo sunInfo(sphereModel, *_mainStarShader, Shader("../resource/shaders/starGlow.vs", "../resource/shaders/starGlow.fs"), TextureImage2D("../resource/textures/Star_Spectrum.dds"),
+    const TextureImage2D starSpectrum = _textureLoader->Load("../resource/textures/Star_Spectrum.dds");
+    _textureStreamer->KeepResident(starSpectrum); // A color lookup, it is sampled at any size of the sun on screen
+    StarInfo sunInfo(sphereModel, *_mainStarShader, Shader("../resource/shaders/starGlow.vs", "../resource/shaders/starGlow.fs"), starSpectrum,
                      starTemperatureInKelvin, 696342.0, glm::vec3(0.99607843, 0.890196078, 0.725490196), L"Sun", L"Солнце"); // rgb(254, 227, 185)
     _sun = make_shared<Sun>(sunInfo);
 
-    // Initialization in such an order that there is enough virtual memory to initialize all textures (to avoid bad_alloc)
+    // The same order as in PrefetchSceneTextures(), so that textures are taken in the order the workers parse them
     InitNeptuneSystem(sphereModel);
     InitMercury(sphereModel);
     InitVenus(sphereModel);
@@ -708,353 +1551,376 @@ void Application::InitStarSystem() {
 }
 
 void Application::InitMercury(const MeshHolder& sphereModel) {
+    ProfileScope profileScope("system", "InitMercury");
     PlanetInfo mercuryInfo(sphereModel, 0.38, *_mainPlanetShader,
             {
-                TextureImage2D("../resource/textures/Mercury_Diffuse.dds"),
-            }, TextureImage2D("../resource/textures/Mercury_Normal.dds"), L"Mercury", L"Меркурий", TextureImage2D("../resource/textures/Mercury_Specular.dds"));
+                _textureLoader->Load("../resource/textures/Mercury_Diffuse.dds"),
+            }, _textureLoader->Load("../resource/textures/Mercury_Normal.dds"), L"Mercury", L"Меркурий", _textureLoader->Load("../resource/textures/Mercury_Specular.dds"));
     shared_ptr<Planet> mercury = make_shared<Mercury>(mercuryInfo, _sun);
 
-    const glm::mat4 lightProjection = glm::ortho(-mercury->GetRadius() * 3.0f, mercury->GetRadius() * 3.0f, -mercury->GetRadius() * 3.0f, mercury->GetRadius() * 3.0f, camera.GetNear(), camera.GetFar());
-    const glm::mat4 lightView = glm::lookAt(_sun->GetPosition(), mercury->GetPosition() - _sun->GetPosition(), glm::vec3(0.0, 1.0, 0.0));
-    const glm::mat4 lightSpaceMatrix = lightProjection * lightView;
-
     RenderableSceneComponent mercurySystemComponent;
-    mercurySystemComponent.lightSpaceMatrix = lightSpaceMatrix;
     mercurySystemComponent.planet = move(mercury);
     _renderableSceneComponents.push_back(move(mercurySystemComponent));
 }
 
 void Application::InitVenus(const MeshHolder& sphereModel) {
+    ProfileScope profileScope("system", "InitVenus");
     PlanetInfo venusInfo(sphereModel, 0.95, *_mainPlanetShader,
             {
-                TextureImage2D("../resource/textures/Venus_Diffuse.dds"),
-            }, TextureImage2D("../resource/textures/Venus_Normal.dds"), L"Venus", L"Венера");
+                _textureLoader->Load("../resource/textures/Venus_Diffuse.dds"),
+            }, _textureLoader->Load("../resource/textures/Venus_Normal.dds"), L"Venus", L"Венера");
     shared_ptr<Planet> venus = make_shared<Venus>(venusInfo, _sun);
 
-    AtmosphereInfo venusAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 1.1, glm::vec3(203/255.f, 158/255.f, 69/255.), venus->GetRadius() - 0.00007, 1.995);
-    unique_ptr<Atmosphere> venusAtmosphere = make_unique<Atmosphere>(venusAtmosphereInfo, venus);
-
-    const glm::mat4 lightProjection = glm::ortho(-venus->GetRadius() * 3.0f, venus->GetRadius() * 3.0f, -venus->GetRadius() * 3.0f, venus->GetRadius() * 3.0f, camera.GetNear(), camera.GetFar());
-    const glm::mat4 lightView = glm::lookAt(_sun->GetPosition(), venus->GetPosition() - _sun->GetPosition(), glm::vec3(0.0, 1.0, 0.0));
-    const glm::mat4 lightSpaceMatrix = lightProjection * lightView;
-
-    RenderableAtmosphere renderableVenusAtmosphere;
-    renderableVenusAtmosphere.atmosphere = move(venusAtmosphere);
-    renderableVenusAtmosphere.hScaleFactor = 6.0;
-    renderableVenusAtmosphere.parentEarthSizeCoefficient = venus->GetEarthSizeCoefficient();
-
     RenderableSceneComponent venusSystemComponent;
-    venusSystemComponent.lightSpaceMatrix = lightSpaceMatrix;
     venusSystemComponent.planet = move(venus);
-    venusSystemComponent.atmospheres.push_back(move(renderableVenusAtmosphere));
+    venusSystemComponent.lazyParts = {
+            {{}, [this, sphereModel](RenderableSceneComponent& component) {
+                const auto& venus = component.planet;
+                AtmosphereInfo venusAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 1.1, glm::vec3(203/255.f, 158/255.f, 69/255.), venus->GetRadius() - 0.00007, 1.995);
+
+                RenderableAtmosphere renderableVenusAtmosphere;
+                renderableVenusAtmosphere.atmosphere = make_unique<Atmosphere>(venusAtmosphereInfo, venus);
+                renderableVenusAtmosphere.hScaleFactor = 6.0;
+                renderableVenusAtmosphere.parentEarthSizeCoefficient = venus->GetEarthSizeCoefficient();
+                component.atmospheres.push_back(move(renderableVenusAtmosphere));
+            }}
+    };
+    SetResidencyDistances(venusSystemComponent, 0.0f);
     _renderableSceneComponents.push_back(move(venusSystemComponent));
 }
 
 void Application::InitEarthSystem(const MeshHolder& sphereModel) {
+    ProfileScope profileScope("system", "InitEarthSystem");
     PlanetInfo earthInfo(sphereModel, 1.0, *_mainPlanetShader,
             {
-                TextureImage2D("../resource/textures/Earth_Day_Diffuse.dds"),
-                TextureImage2D("../resource/textures/Earth_Clouds_Diffuse.dds"),
-                TextureImage2D("../resource/textures/Earth_Night_Diffuse.dds"),
-            }, TextureImage2D("../resource/textures/Earth_Normal.dds"), L"Earth", L"Земля", TextureImage2D("../resource/textures/Earth_Specular.dds"));
+                _textureLoader->Load("../resource/textures/Earth_Day_Diffuse.dds"),
+                _textureLoader->Load("../resource/textures/Earth_Clouds_Diffuse.dds"),
+                _textureLoader->Load("../resource/textures/Earth_Night_Diffuse.dds"),
+            }, _textureLoader->Load("../resource/textures/Earth_Normal.dds"), L"Earth", L"Земля", _textureLoader->Load("../resource/textures/Earth_Specular.dds"));
     shared_ptr<Planet> earth = make_shared<Earth>(earthInfo, _sun);
 
-    SatelliteInfo moonInfo(sphereModel, 0.2724, *_mainPlanetShader, {TextureImage2D("../resource/textures/Moon_Diffuse.dds")}, TextureImage2D("../resource/textures/Moon_Normal.dds"),
-                           L"Moon", L"Луна");
-    shared_ptr<Satellite> moon = make_shared<Moon>(moonInfo, earth);
-
-    AtmosphereInfo earthAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 1.1, glm::vec3(0.3, 0.7, 1.0), earth->GetRadius() - 0.00007, 2.1);
-    unique_ptr<Atmosphere> earthAtmosphere = make_unique<Atmosphere>(earthAtmosphereInfo, earth);
-
-    CloudsInfo earthCloudsInfo(sphereModel, *_mainCloudsShader, 1.0055, TextureImage2D("../resource/textures/Earth_Clouds_Diffuse.dds"),
-                               TextureImage2D("../resource/textures/Earth_Clouds_Normal.dds"));
-    unique_ptr<Clouds> earthClouds = make_unique<EarthClouds>(earthCloudsInfo, earth);
-
-    const glm::mat4 lightProjection = glm::ortho(-earth->GetRadius() * 3.0f, earth->GetRadius() * 3.0f, -earth->GetRadius() * 3.0f, earth->GetRadius() * 3.0f, camera.GetNear(), camera.GetFar());
-    const glm::mat4 lightView = glm::lookAt(_sun->GetPosition(), earth->GetPosition() - _sun->GetPosition(), glm::vec3(0.0, 1.0, 0.0));
-    const glm::mat4 lightSpaceMatrix = lightProjection * lightView;
-
-    RenderableAtmosphere renderableEarthAtmosphere;
-    renderableEarthAtmosphere.atmosphere = move(earthAtmosphere);
-    renderableEarthAtmosphere.hScaleFactor = 6.0;
-    renderableEarthAtmosphere.parentEarthSizeCoefficient = earth->GetEarthSizeCoefficient();
-
     RenderableSceneComponent earthSystemComponent;
-    earthSystemComponent.lightSpaceMatrix = lightSpaceMatrix;
     earthSystemComponent.planet = move(earth);
-    earthSystemComponent.satellites = vector<shared_ptr<Satellite>>{move(moon)};
-    earthSystemComponent.atmospheres.push_back(move(renderableEarthAtmosphere));
-    earthSystemComponent.clouds = move(earthClouds);
+    earthSystemComponent.lazyParts = {
+            {{"../resource/textures/Moon_Diffuse.dds", "../resource/textures/Moon_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo moonInfo(sphereModel, 0.2724, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Moon_Diffuse.dds")},
+                                       _textureLoader->Load("../resource/textures/Moon_Normal.dds"), L"Moon", L"Луна");
+                component.satellites.push_back(make_shared<Moon>(moonInfo, component.planet));
+            }},
+            {{}, [this, sphereModel](RenderableSceneComponent& component) {
+                const auto& earth = component.planet;
+                AtmosphereInfo earthAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 1.1, glm::vec3(0.3, 0.7, 1.0), earth->GetRadius() - 0.00007, 2.1);
+
+                RenderableAtmosphere renderableEarthAtmosphere;
+                renderableEarthAtmosphere.atmosphere = make_unique<Atmosphere>(earthAtmosphereInfo, earth);
+                renderableEarthAtmosphere.hScaleFactor = 6.0;
+                renderableEarthAtmosphere.parentEarthSizeCoefficient = earth->GetEarthSizeCoefficient();
+                component.atmospheres.push_back(move(renderableEarthAtmosphere));
+            }},
+            {{"../resource/textures/Earth_Clouds_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) { // The diffuse is already taken by the planet
+                CloudsInfo earthCloudsInfo(sphereModel, *_mainCloudsShader, 1.0055, _textureLoader->Load("../resource/textures/Earth_Clouds_Diffuse.dds"),
+                                           _textureLoader->Load("../resource/textures/Earth_Clouds_Normal.dds"));
+                component.clouds = make_unique<EarthClouds>(earthCloudsInfo, component.planet);
+            }}
+    };
+    SetResidencyDistances(earthSystemComponent, 25.0f); // Moon orbit
     _renderableSceneComponents.push_back(move(earthSystemComponent));
 }
 
 void Application::InitMarsSystem(const MeshHolder& sphereModel) {
-    MeshHolder phobosModel("../resource/models/phobos.obj"), deimosModel("../resource/models/deimos.obj");
-
+    ProfileScope profileScope("system", "InitMarsSystem");
     PlanetInfo marsInfo(sphereModel, 0.53, *_mainPlanetShader,
             {
-                TextureImage2D("../resource/textures/Mars_Diffuse.dds"),
-            }, TextureImage2D("../resource/textures/Mars_Normal.dds"), L"Mars", L"Марс");
+                _textureLoader->Load("../resource/textures/Mars_Diffuse.dds"),
+            }, _textureLoader->Load("../resource/textures/Mars_Normal.dds"), L"Mars", L"Марс");
     shared_ptr<Planet> mars = make_shared<Mars>(marsInfo, _sun);
 
-    SatelliteInfo phobosInfo(phobosModel, 0.001768, *_mainPlanetShader, {TextureImage2D("../resource/textures/Phobos_Diffuse.dds")}, TextureImage2D("../resource/textures/Phobos_Normal.dds"),
-                             L"Phobos", L"Фобос");
-    SatelliteInfo deimosInfo(deimosModel, 0.00097316, *_mainPlanetShader, {TextureImage2D("../resource/textures/Deimos_Diffuse.dds")}, TextureImage2D("../resource/textures/Deimos_Normal.dds"),
-                             L"Deimos", L"Деймос");
-    shared_ptr<Satellite> phobos = make_shared<Phobos>(phobosInfo, mars);
-    shared_ptr<Satellite> deimos = make_shared<Deimos>(deimosInfo, mars);
-
-    AtmosphereInfo marsAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 0.583, glm::vec3(0.976, 0.302, 0.208), mars->GetRadius() - 0.00007, 1.113);
-    unique_ptr<Atmosphere> marsAtmosphere = make_unique<Atmosphere>(marsAtmosphereInfo, mars);
-
-    const glm::mat4 lightProjection = glm::ortho(-mars->GetRadius() * 3.0f, mars->GetRadius() * 3.0f, -mars->GetRadius() * 3.0f, mars->GetRadius() * 3.0f, camera.GetNear(),
-                                                 glm::length(_sun->GetPosition() - mars->GetPosition()) + 50.f);
-    const glm::mat4 lightView = glm::lookAt(_sun->GetPosition(), mars->GetPosition() - _sun->GetPosition(), glm::vec3(0.0, 1.0, 0.0));
-    const glm::mat4 lightSpaceMatrix = lightProjection * lightView;
-
-    RenderableAtmosphere renderableMarsAtmosphere;
-    renderableMarsAtmosphere.atmosphere = move(marsAtmosphere);
-    renderableMarsAtmosphere.hScaleFactor = 6.0;
-    renderableMarsAtmosphere.parentEarthSizeCoefficient = mars->GetEarthSizeCoefficient();
-
     RenderableSceneComponent marsSystemComponent;
-    marsSystemComponent.lightSpaceMatrix = lightSpaceMatrix;
     marsSystemComponent.planet = move(mars);
-    marsSystemComponent.satellites = vector<shared_ptr<Satellite>>{move(phobos), move(deimos)};
-    marsSystemComponent.atmospheres.push_back(move(renderableMarsAtmosphere));
+    marsSystemComponent.lazyParts = {
+            {{"../resource/textures/Phobos_Diffuse.dds", "../resource/textures/Phobos_Normal.dds"}, [this](RenderableSceneComponent& component) {
+                MeshHolder phobosModel("../resource/models/phobos.obj");
+                SatelliteInfo phobosInfo(phobosModel, 0.001768, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Phobos_Diffuse.dds")},
+                                         _textureLoader->Load("../resource/textures/Phobos_Normal.dds"), L"Phobos", L"Фобос");
+                component.satellites.push_back(make_shared<Phobos>(phobosInfo, component.planet));
+            }},
+            {{"../resource/textures/Deimos_Diffuse.dds", "../resource/textures/Deimos_Normal.dds"}, [this](RenderableSceneComponent& component) {
+                MeshHolder deimosModel("../resource/models/deimos.obj");
+                SatelliteInfo deimosInfo(deimosModel, 0.00097316, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Deimos_Diffuse.dds")},
+                                         _textureLoader->Load("../resource/textures/Deimos_Normal.dds"), L"Deimos", L"Деймос");
+                component.satellites.push_back(make_shared<Deimos>(deimosInfo, component.planet));
+            }},
+            {{}, [this, sphereModel](RenderableSceneComponent& component) {
+                const auto& mars = component.planet;
+                AtmosphereInfo marsAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 0.583, glm::vec3(0.976, 0.302, 0.208), mars->GetRadius() - 0.00007, 1.113);
+
+                RenderableAtmosphere renderableMarsAtmosphere;
+                renderableMarsAtmosphere.atmosphere = make_unique<Atmosphere>(marsAtmosphereInfo, mars);
+                renderableMarsAtmosphere.hScaleFactor = 6.0;
+                renderableMarsAtmosphere.parentEarthSizeCoefficient = mars->GetEarthSizeCoefficient();
+                component.atmospheres.push_back(move(renderableMarsAtmosphere));
+            }}
+    };
+    SetResidencyDistances(marsSystemComponent, 2.95f); // Deimos orbit
     _renderableSceneComponents.push_back(move(marsSystemComponent));
 }
 
 void Application::InitJupiterSystem(const MeshHolder& sphereModel) {
+    ProfileScope profileScope("system", "InitJupiterSystem");
     PlanetInfo jupiterInfo(sphereModel, 11.2, *_mainPlanetShader,
             {
-                TextureImage2D("../resource/textures/Jupiter_Diffuse.dds"),
-            }, TextureImage2D("../resource/textures/Jupiter_Normal.dds"), L"Jupiter", L"Юпитер");
+                _textureLoader->Load("../resource/textures/Jupiter_Diffuse.dds"),
+            }, _textureLoader->Load("../resource/textures/Jupiter_Normal.dds"), L"Jupiter", L"Юпитер");
     shared_ptr<Planet> jupiter = make_shared<Jupiter>(jupiterInfo, _sun);
 
-    SatelliteInfo ioInfo(sphereModel, 0.28592, *_mainPlanetShader, {TextureImage2D("../resource/textures/Io_Diffuse.dds")}, TextureImage2D("../resource/textures/Io_Normal.dds"),
-                         L"Io", L"Ио");
-    SatelliteInfo europaInfo(sphereModel, 0.244985, *_mainPlanetShader, {TextureImage2D("../resource/textures/Europa_Diffuse.dds")}, TextureImage2D("../resource/textures/Europa_Normal.dds"),
-                             L"Europa", L"Европа");
-    SatelliteInfo ganymedeInfo(sphereModel, 0.41345, *_mainPlanetShader, {TextureImage2D("../resource/textures/Ganymede_Diffuse.dds")}, TextureImage2D("../resource/textures/Ganymede_Normal.dds"),
-                               L"Ganymede", L"Ганимед");
-    SatelliteInfo callistoInfo(sphereModel, 0.3783236, *_mainPlanetShader, {TextureImage2D("../resource/textures/Callisto_Diffuse.dds")}, TextureImage2D("../resource/textures/Callisto_Normal.dds"),
-                               L"Callisto", L"Каллисто");
-    shared_ptr<Satellite> io = make_shared<Io>(ioInfo, jupiter);
-    shared_ptr<Satellite> europa = make_shared<Europa>(europaInfo, jupiter);
-    shared_ptr<Satellite> ganymede = make_shared<Ganymede>(ganymedeInfo, jupiter);
-    shared_ptr<Satellite> callisto = make_shared<Callisto>(callistoInfo, jupiter);
-
-    AtmosphereInfo jupiterAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 11.4, glm::vec3(153.f/255, 139.f/255, 120.f/255), jupiter->GetRadius() - 0.00007, 23.35);
-    unique_ptr<Atmosphere> jupiterAtmosphere = make_unique<Atmosphere>(jupiterAtmosphereInfo, jupiter);
-
-    const glm::mat4 lightProjection = glm::ortho(-jupiter->GetRadius() * 3.0f, jupiter->GetRadius() * 3.0f, -jupiter->GetRadius() * 3.0f, jupiter->GetRadius() * 3.0f, camera.GetNear(), camera.GetFar());
-    const glm::mat4 lightView = glm::lookAt(_sun->GetPosition(), jupiter->GetPosition() - _sun->GetPosition(), glm::vec3(0.0, 1.0, 0.0));
-    const glm::mat4 lightSpaceMatrix = lightProjection * lightView;
-
-    RenderableAtmosphere renderableJupiterAtmosphere;
-    renderableJupiterAtmosphere.atmosphere = move(jupiterAtmosphere);
-    renderableJupiterAtmosphere.hScaleFactor = 26.0;
-    renderableJupiterAtmosphere.parentEarthSizeCoefficient = jupiter->GetEarthSizeCoefficient();
-    renderableJupiterAtmosphere.isUseToneMapping = true;
-
     RenderableSceneComponent jupiterSystemComponent;
-    jupiterSystemComponent.lightSpaceMatrix = lightSpaceMatrix;
     jupiterSystemComponent.planet = move(jupiter);
-    jupiterSystemComponent.satellites = vector<shared_ptr<Satellite>>{move(io), move(europa), move(ganymede), move(callisto)};
-    jupiterSystemComponent.atmospheres.push_back(move(renderableJupiterAtmosphere));
+    jupiterSystemComponent.lazyParts = {
+            {{"../resource/textures/Io_Diffuse.dds", "../resource/textures/Io_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo ioInfo(sphereModel, 0.28592, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Io_Diffuse.dds")},
+                                     _textureLoader->Load("../resource/textures/Io_Normal.dds"), L"Io", L"Ио");
+                component.satellites.push_back(make_shared<Io>(ioInfo, component.planet));
+            }},
+            {{"../resource/textures/Europa_Diffuse.dds", "../resource/textures/Europa_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo europaInfo(sphereModel, 0.244985, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Europa_Diffuse.dds")},
+                                         _textureLoader->Load("../resource/textures/Europa_Normal.dds"), L"Europa", L"Европа");
+                component.satellites.push_back(make_shared<Europa>(europaInfo, component.planet));
+            }},
+            {{"../resource/textures/Ganymede_Diffuse.dds", "../resource/textures/Ganymede_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo ganymedeInfo(sphereModel, 0.41345, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Ganymede_Diffuse.dds")},
+                                           _textureLoader->Load("../resource/textures/Ganymede_Normal.dds"), L"Ganymede", L"Ганимед");
+                component.satellites.push_back(make_shared<Ganymede>(ganymedeInfo, component.planet));
+            }},
+            {{"../resource/textures/Callisto_Diffuse.dds", "../resource/textures/Callisto_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo callistoInfo(sphereModel, 0.3783236, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Callisto_Diffuse.dds")},
+                                           _textureLoader->Load("../resource/textures/Callisto_Normal.dds"), L"Callisto", L"Каллисто");
+                component.satellites.push_back(make_shared<Callisto>(callistoInfo, component.planet));
+            }},
+            {{}, [this, sphereModel](RenderableSceneComponent& component) {
+                const auto& jupiter = component.planet;
+                AtmosphereInfo jupiterAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 11.4, glm::vec3(153.f/255, 139.f/255, 120.f/255), jupiter->GetRadius() - 0.00007, 23.35);
+
+                RenderableAtmosphere renderableJupiterAtmosphere;
+                renderableJupiterAtmosphere.atmosphere = make_unique<Atmosphere>(jupiterAtmosphereInfo, jupiter);
+                renderableJupiterAtmosphere.hScaleFactor = 26.0;
+                renderableJupiterAtmosphere.parentEarthSizeCoefficient = jupiter->GetEarthSizeCoefficient();
+                renderableJupiterAtmosphere.isUseToneMapping = true;
+                component.atmospheres.push_back(move(renderableJupiterAtmosphere));
+            }}
+    };
+    SetResidencyDistances(jupiterSystemComponent, 92.0f); // Callisto orbit
     _renderableSceneComponents.push_back(move(jupiterSystemComponent));
 }
 
 void Application::InitSaturnSystem(const MeshHolder& sphereModel) {
-    MeshHolder saturnRingModel("../resource/models/saturn_ring.obj");
-
+    ProfileScope profileScope("system", "InitSaturnSystem");
     PlanetInfo saturnInfo(sphereModel, 9.14, *_mainPlanetShader,
             {
-                TextureImage2D("../resource/textures/Saturn_Diffuse.dds"),
-            }, TextureImage2D("../resource/textures/Saturn_Normal.dds"), L"Saturn", L"Сатурн");
+                _textureLoader->Load("../resource/textures/Saturn_Diffuse.dds"),
+            }, _textureLoader->Load("../resource/textures/Saturn_Normal.dds"), L"Saturn", L"Сатурн");
     shared_ptr<Planet> saturn = make_shared<Saturn>(saturnInfo, _sun);
 
-    PlanetaryRingInfo saturnRingInfo(saturnRingModel, 22.0, 43.7, *_mainPlanetShader, TextureImage2D("../resource/textures/Saturn_Rings.dds")); // Radiuses from 3D model
-    unique_ptr<PlanetaryRing> saturnRing = make_unique<SaturnRing>(saturnRingInfo, saturn);
-
-    SatelliteInfo mimasInfo(sphereModel, 0.03111, *_mainPlanetShader, {TextureImage2D("../resource/textures/Mimas_Diffuse.dds")}, TextureImage2D("../resource/textures/Mimas_Normal.dds"),
-                            L"Mimas", L"Мимас");
-    SatelliteInfo enceladusInfo(sphereModel, 0.03957, *_mainPlanetShader, {TextureImage2D("../resource/textures/Enceladus_Diffuse.dds")}, TextureImage2D("../resource/textures/Enceladus_Normal.dds"),
-                            L"Enceladus", L"Энцелад");
-    SatelliteInfo tethysInfo(sphereModel, 0.083346, *_mainPlanetShader, {TextureImage2D("../resource/textures/Tethys_Diffuse.dds")}, TextureImage2D("../resource/textures/Tethys_Normal.dds"),
-                            L"Tethys", L"Тефия");
-    SatelliteInfo dioneInfo(sphereModel, 0.08812, *_mainPlanetShader, {TextureImage2D("../resource/textures/Dione_Diffuse.dds")}, TextureImage2D("../resource/textures/Dione_Normal.dds"),
-                            L"Dione", L"Диона");
-    SatelliteInfo rheaInfo(sphereModel, 0.119886, *_mainPlanetShader, {TextureImage2D("../resource/textures/Rhea_Diffuse.dds")}, TextureImage2D("../resource/textures/Rhea_Normal.dds"),
-                            L"Rhea", L"Рея");
-    SatelliteInfo titanInfo(sphereModel, 0.404136, *_mainPlanetShader, {TextureImage2D("../resource/textures/Titan_Diffuse.dds")}, TextureImage2D("../resource/textures/Titan_Normal.dds"),
-                            L"Titan", L"Титан");
-    SatelliteInfo iapetusInfo(sphereModel, 0.115288, *_mainPlanetShader, {TextureImage2D("../resource/textures/Iapetus_Diffuse.dds")}, TextureImage2D("../resource/textures/Iapetus_Normal.dds"),
-                            L"Iapetus", L"Япет");
-    shared_ptr<Satellite> mimas = make_shared<Mimas>(mimasInfo, saturn);
-    shared_ptr<Satellite> enceladus = make_shared<Enceladus>(enceladusInfo, saturn);
-    shared_ptr<Satellite> tethys = make_shared<Tethys>(tethysInfo, saturn);
-    shared_ptr<Satellite> dione = make_shared<Dione>(dioneInfo, saturn);
-    shared_ptr<Satellite> rhea = make_shared<Rhea>(rheaInfo, saturn);
-    shared_ptr<Satellite> titan = make_shared<Titan>(titanInfo, saturn);
-    shared_ptr<Satellite> iapetus = make_shared<Iapetus>(iapetusInfo, saturn);
-
-    AtmosphereInfo saturnAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 9.34, glm::vec3(84.f/255, 132.f/255, 176.f/255), saturn->GetRadius() - 0.00007, 18.6);
-    unique_ptr<Atmosphere> saturnAtmosphere = make_unique<Atmosphere>(saturnAtmosphereInfo, saturn);
-
-    AtmosphereInfo titanAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 0.504136, glm::vec3(40.f/255, 33.f/255, 72.f/255), titan->GetRadius() - 0.00007, 0.8429210,
-                                       glm::vec3(0.36862745, 0.0666667, 0.0196078)); // Mie tint rgb(94, 17, 5));
-    unique_ptr<Atmosphere> titanAtmosphere = make_unique<Atmosphere>(titanAtmosphereInfo, titan);
-
-    const glm::mat4 lightProjection = glm::ortho(-saturn->GetRadius() * 3.0f, saturn->GetRadius() * 3.0f, -saturn->GetRadius() * 3.0f, saturn->GetRadius() * 3.0f, camera.GetNear(), camera.GetFar());
-    const glm::mat4 lightView = glm::lookAt(_sun->GetPosition(), saturn->GetPosition() - _sun->GetPosition(), glm::vec3(0.0, 1.0, 0.0));
-    const glm::mat4 lightSpaceMatrix = lightProjection * lightView;
-
-    RenderableAtmosphere renderableSaturnAtmosphere;
-    renderableSaturnAtmosphere.atmosphere = move(saturnAtmosphere);
-    renderableSaturnAtmosphere.hScaleFactor = 27.0;
-    renderableSaturnAtmosphere.parentEarthSizeCoefficient = saturn->GetEarthSizeCoefficient();
-    renderableSaturnAtmosphere.isUseToneMapping = true;
-
-    RenderableAtmosphere renderableTitanAtmosphere;
-    renderableTitanAtmosphere.atmosphere = move(titanAtmosphere);
-    renderableTitanAtmosphere.hScaleFactor = 4.8;
-    renderableTitanAtmosphere.parentEarthSizeCoefficient = titan->GetEarthSizeCoefficient();
-
     RenderableSceneComponent saturnSystemComponent;
-    saturnSystemComponent.lightSpaceMatrix = lightSpaceMatrix;
     saturnSystemComponent.planet = move(saturn);
-    saturnSystemComponent.satellites = vector<shared_ptr<Satellite>>{move(mimas), move(enceladus), move(tethys), move(dione), move(rhea), move(titan), move(iapetus)};
-    saturnSystemComponent.atmospheres.push_back(move(renderableSaturnAtmosphere));
-    saturnSystemComponent.atmospheres.push_back(move(renderableTitanAtmosphere));
-    saturnSystemComponent.planetaryRing = move(saturnRing);
+    saturnSystemComponent.lazyParts = {
+            {{"../resource/textures/Saturn_Rings.dds"}, [this](RenderableSceneComponent& component) {
+                MeshHolder saturnRingModel("../resource/models/saturn_ring.obj");
+                PlanetaryRingInfo saturnRingInfo(saturnRingModel, 22.0, 43.7, *_mainPlanetShader, _textureLoader->Load("../resource/textures/Saturn_Rings.dds")); // Radiuses from 3D model
+                component.planetaryRing = make_unique<SaturnRing>(saturnRingInfo, component.planet);
+            }},
+            {{}, [this, sphereModel](RenderableSceneComponent& component) {
+                const auto& saturn = component.planet;
+                AtmosphereInfo saturnAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 9.34, glm::vec3(84.f/255, 132.f/255, 176.f/255), saturn->GetRadius() - 0.00007, 18.6);
+
+                RenderableAtmosphere renderableSaturnAtmosphere;
+                renderableSaturnAtmosphere.atmosphere = make_unique<Atmosphere>(saturnAtmosphereInfo, saturn);
+                renderableSaturnAtmosphere.hScaleFactor = 27.0;
+                renderableSaturnAtmosphere.parentEarthSizeCoefficient = saturn->GetEarthSizeCoefficient();
+                renderableSaturnAtmosphere.isUseToneMapping = true;
+                component.atmospheres.push_back(move(renderableSaturnAtmosphere));
+            }},
+            {{"../resource/textures/Mimas_Diffuse.dds", "../resource/textures/Mimas_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo mimasInfo(sphereModel, 0.03111, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Mimas_Diffuse.dds")},
+                                        _textureLoader->Load("../resource/textures/Mimas_Normal.dds"), L"Mimas", L"Мимас");
+                component.satellites.push_back(make_shared<Mimas>(mimasInfo, component.planet));
+            }},
+            {{"../resource/textures/Enceladus_Diffuse.dds", "../resource/textures/Enceladus_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo enceladusInfo(sphereModel, 0.03957, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Enceladus_Diffuse.dds")},
+                                            _textureLoader->Load("../resource/textures/Enceladus_Normal.dds"), L"Enceladus", L"Энцелад");
+                component.satellites.push_back(make_shared<Enceladus>(enceladusInfo, component.planet));
+            }},
+            {{"../resource/textures/Tethys_Diffuse.dds", "../resource/textures/Tethys_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo tethysInfo(sphereModel, 0.083346, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Tethys_Diffuse.dds")},
+                                         _textureLoader->Load("../resource/textures/Tethys_Normal.dds"), L"Tethys", L"Тефия");
+                component.satellites.push_back(make_shared<Tethys>(tethysInfo, component.planet));
+            }},
+            {{"../resource/textures/Dione_Diffuse.dds", "../resource/textures/Dione_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo dioneInfo(sphereModel, 0.08812, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Dione_Diffuse.dds")},
+                                        _textureLoader->Load("../resource/textures/Dione_Normal.dds"), L"Dione", L"Диона");
+                component.satellites.push_back(make_shared<Dione>(dioneInfo, component.planet));
+            }},
+            {{"../resource/textures/Rhea_Diffuse.dds", "../resource/textures/Rhea_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo rheaInfo(sphereModel, 0.119886, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Rhea_Diffuse.dds")},
+                                       _textureLoader->Load("../resource/textures/Rhea_Normal.dds"), L"Rhea", L"Рея");
+                component.satellites.push_back(make_shared<Rhea>(rheaInfo, component.planet));
+            }},
+            {{"../resource/textures/Titan_Diffuse.dds", "../resource/textures/Titan_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo titanInfo(sphereModel, 0.404136, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Titan_Diffuse.dds")},
+                                        _textureLoader->Load("../resource/textures/Titan_Normal.dds"), L"Titan", L"Титан");
+                shared_ptr<Satellite> titan = make_shared<Titan>(titanInfo, component.planet);
+
+                AtmosphereInfo titanAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 0.504136, glm::vec3(40.f/255, 33.f/255, 72.f/255), titan->GetRadius() - 0.00007, 0.8429210,
+                                                   glm::vec3(0.36862745, 0.0666667, 0.0196078)); // Mie tint rgb(94, 17, 5));
+
+                RenderableAtmosphere renderableTitanAtmosphere;
+                renderableTitanAtmosphere.atmosphere = make_unique<Atmosphere>(titanAtmosphereInfo, titan);
+                renderableTitanAtmosphere.hScaleFactor = 4.8;
+                renderableTitanAtmosphere.parentEarthSizeCoefficient = titan->GetEarthSizeCoefficient();
+                component.satellites.push_back(move(titan));
+                component.atmospheres.push_back(move(renderableTitanAtmosphere));
+            }},
+            {{"../resource/textures/Iapetus_Diffuse.dds", "../resource/textures/Iapetus_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo iapetusInfo(sphereModel, 0.115288, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Iapetus_Diffuse.dds")},
+                                          _textureLoader->Load("../resource/textures/Iapetus_Normal.dds"), L"Iapetus", L"Япет");
+                component.satellites.push_back(make_shared<Iapetus>(iapetusInfo, component.planet));
+            }}
+    };
+    SetResidencyDistances(saturnSystemComponent, 96.5f); // Iapetus orbit
     _renderableSceneComponents.push_back(move(saturnSystemComponent));
 }
 
 void Application::InitUranusSystem(const MeshHolder& sphereModel) {
-    MeshHolder uranusRingModel("../resource/models/uranus_ring.obj");
-
+    ProfileScope profileScope("system", "InitUranusSystem");
     PlanetInfo uranusInfo(sphereModel, 3.98085, *_mainPlanetShader,
             {
-                TextureImage2D("../resource/textures/Uranus_Diffuse.dds"),
-                TextureImage2D("../resource/textures/Uranus_Clouds_Diffuse.dds")
-            }, TextureImage2D("../resource/textures/Uranus_Normal.dds"), L"Uranus", L"Уран");
+                _textureLoader->Load("../resource/textures/Uranus_Diffuse.dds"),
+                _textureLoader->Load("../resource/textures/Uranus_Clouds_Diffuse.dds")
+            }, _textureLoader->Load("../resource/textures/Uranus_Normal.dds"), L"Uranus", L"Уран");
     shared_ptr<Planet> uranus = make_shared<Uranus>(uranusInfo, _sun);
-    PlanetaryRingInfo uranusRingInfo(uranusRingModel, 12.6, 16.0, *_mainPlanetShader, TextureImage2D("../resource/textures/Uranus_Rings.dds")); // Radiuses from 3D model
-    unique_ptr<PlanetaryRing> uranusRing = make_unique<UranusRing>(uranusRingInfo, uranus);
-
-    SatelliteInfo mirandaInfo(sphereModel, 0.0368858, *_mainPlanetShader, {TextureImage2D("../resource/textures/Miranda_Diffuse.dds")}, TextureImage2D("../resource/textures/Miranda_Normal.dds"),
-                            L"Miranda", L"Миранда");
-    SatelliteInfo arielInfo(sphereModel, 0.090865, *_mainPlanetShader, {TextureImage2D("../resource/textures/Ariel_Diffuse.dds")}, TextureImage2D("../resource/textures/Ariel_Normal.dds"),
-                            L"Ariel", L"Ариэль");
-    SatelliteInfo umbrielInfo(sphereModel, 0.091775, *_mainPlanetShader, {TextureImage2D("../resource/textures/Umbriel_Diffuse.dds")}, TextureImage2D("../resource/textures/Umbriel_Normal.dds"),
-                            L"Umbriel", L"Умбриэль");
-    SatelliteInfo titaniaInfo(sphereModel, 0.123748, *_mainPlanetShader, {TextureImage2D("../resource/textures/Titania_Diffuse.dds")}, TextureImage2D("../resource/textures/Titania_Normal.dds"),
-                            L"Titania", L"Титания");
-    SatelliteInfo oberonInfo(sphereModel, 0.11951, *_mainPlanetShader, {TextureImage2D("../resource/textures/Oberon_Diffuse.dds")}, TextureImage2D("../resource/textures/Oberon_Normal.dds"),
-                            L"Oberon", L"Оберон");
-    shared_ptr<Satellite> miranda = make_shared<Miranda>(mirandaInfo, uranus);
-    shared_ptr<Satellite> ariel = make_shared<Ariel>(arielInfo, uranus);
-    shared_ptr<Satellite> umbriel = make_shared<Umbriel>(umbrielInfo, uranus);
-    shared_ptr<Satellite> titania = make_shared<Titania>(titaniaInfo, uranus);
-    shared_ptr<Satellite> oberon = make_shared<Oberon>(oberonInfo, uranus);
-
-    CloudsInfo uranusCloudsInfo(sphereModel, *_mainCloudsShader, 3.98635, TextureImage2D("../resource/textures/Uranus_Clouds_Diffuse.dds"),
-                            TextureImage2D("../resource/textures/Uranus_Clouds_Normal.dds"));
-    unique_ptr<Clouds> uranusClouds = make_unique<UranusClouds>(uranusCloudsInfo, uranus);
-
-    AtmosphereInfo uranusAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 4.0, glm::vec3(45.f/255, 101.f/255, 114.f/255), uranus->GetRadius() - 0.00007, 8.1);
-    unique_ptr<Atmosphere> uranusAtmosphere = make_unique<Atmosphere>(uranusAtmosphereInfo, uranus);
-
-    const glm::mat4 lightProjection = glm::ortho(-uranus->GetRadius() * 3.0f, uranus->GetRadius() * 3.0f, -uranus->GetRadius() * 3.0f, uranus->GetRadius() * 3.0f, camera.GetNear(), camera.GetFar());
-    const glm::mat4 lightView = glm::lookAt(_sun->GetPosition(), uranus->GetPosition() - _sun->GetPosition(), glm::vec3(0.0, 1.0, 0.0));
-    const glm::mat4 lightSpaceMatrix = lightProjection * lightView;
-
-    RenderableAtmosphere renderableUranusAtmosphere;
-    renderableUranusAtmosphere.atmosphere = move(uranusAtmosphere);
-    renderableUranusAtmosphere.hScaleFactor = 24.0;
-    renderableUranusAtmosphere.parentEarthSizeCoefficient = uranus->GetEarthSizeCoefficient();
-    renderableUranusAtmosphere.isUseToneMapping = true;
 
     RenderableSceneComponent uranusSystemComponent;
-    uranusSystemComponent.lightSpaceMatrix = lightSpaceMatrix;
     uranusSystemComponent.planet = move(uranus);
-    uranusSystemComponent.satellites = vector<shared_ptr<Satellite>>{move(miranda), move(ariel), move(umbriel), move(titania), move(oberon)};
-    uranusSystemComponent.atmospheres.push_back(move(renderableUranusAtmosphere));
-    uranusSystemComponent.clouds = move(uranusClouds);
-    uranusSystemComponent.planetaryRing = move(uranusRing);
+    uranusSystemComponent.lazyParts = {
+            {{"../resource/textures/Uranus_Rings.dds"}, [this](RenderableSceneComponent& component) {
+                MeshHolder uranusRingModel("../resource/models/uranus_ring.obj");
+                PlanetaryRingInfo uranusRingInfo(uranusRingModel, 12.6, 16.0, *_mainPlanetShader, _textureLoader->Load("../resource/textures/Uranus_Rings.dds")); // Radiuses from 3D model
+                component.planetaryRing = make_unique<UranusRing>(uranusRingInfo, component.planet);
+            }},
+            {{"../resource/textures/Miranda_Diffuse.dds", "../resource/textures/Miranda_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo mirandaInfo(sphereModel, 0.0368858, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Miranda_Diffuse.dds")},
+                                          _textureLoader->Load("../resource/textures/Miranda_Normal.dds"), L"Miranda", L"Миранда");
+                component.satellites.push_back(make_shared<Miranda>(mirandaInfo, component.planet));
+            }},
+            {{"../resource/textures/Ariel_Diffuse.dds", "../resource/textures/Ariel_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo arielInfo(sphereModel, 0.090865, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Ariel_Diffuse.dds")},
+                                        _textureLoader->Load("../resource/textures/Ariel_Normal.dds"), L"Ariel", L"Ариэль");
+                component.satellites.push_back(make_shared<Ariel>(arielInfo, component.planet));
+            }},
+            {{"../resource/textures/Umbriel_Diffuse.dds", "../resource/textures/Umbriel_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo umbrielInfo(sphereModel, 0.091775, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Umbriel_Diffuse.dds")},
+                                          _textureLoader->Load("../resource/textures/Umbriel_Normal.dds"), L"Umbriel", L"Умбриэль");
+                component.satellites.push_back(make_shared<Umbriel>(umbrielInfo, component.planet));
+            }},
+            {{"../resource/textures/Titania_Diffuse.dds", "../resource/textures/Titania_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo titaniaInfo(sphereModel, 0.123748, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Titania_Diffuse.dds")},
+                                          _textureLoader->Load("../resource/textures/Titania_Normal.dds"), L"Titania", L"Титания");
+                component.satellites.push_back(make_shared<Titania>(titaniaInfo, component.planet));
+            }},
+            {{"../resource/textures/Oberon_Diffuse.dds", "../resource/textures/Oberon_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo oberonInfo(sphereModel, 0.11951, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Oberon_Diffuse.dds")},
+                                         _textureLoader->Load("../resource/textures/Oberon_Normal.dds"), L"Oberon", L"Оберон");
+                component.satellites.push_back(make_shared<Oberon>(oberonInfo, component.planet));
+            }},
+            {{"../resource/textures/Uranus_Clouds_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) { // The diffuse is already taken by the planet
+                CloudsInfo uranusCloudsInfo(sphereModel, *_mainCloudsShader, 3.98635, _textureLoader->Load("../resource/textures/Uranus_Clouds_Diffuse.dds"),
+                                            _textureLoader->Load("../resource/textures/Uranus_Clouds_Normal.dds"));
+                component.clouds = make_unique<UranusClouds>(uranusCloudsInfo, component.planet);
+            }},
+            {{}, [this, sphereModel](RenderableSceneComponent& component) {
+                const auto& uranus = component.planet;
+                AtmosphereInfo uranusAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 4.0, glm::vec3(45.f/255, 101.f/255, 114.f/255), uranus->GetRadius() - 0.00007, 8.1);
+
+                RenderableAtmosphere renderableUranusAtmosphere;
+                renderableUranusAtmosphere.atmosphere = make_unique<Atmosphere>(uranusAtmosphereInfo, uranus);
+                renderableUranusAtmosphere.hScaleFactor = 24.0;
+                renderableUranusAtmosphere.parentEarthSizeCoefficient = uranus->GetEarthSizeCoefficient();
+                renderableUranusAtmosphere.isUseToneMapping = true;
+                component.atmospheres.push_back(move(renderableUranusAtmosphere));
+            }}
+    };
+    SetResidencyDistances(uranusSystemComponent, 61.0f); // Oberon orbit
     _renderableSceneComponents.push_back(move(uranusSystemComponent));
 }
 
 void Application::InitNeptuneSystem(const MeshHolder& sphereModel) {
+    ProfileScope profileScope("system", "InitNeptuneSystem");
     PlanetInfo neptuneInfo(sphereModel, 3.8647, *_mainPlanetShader,
             {
-                TextureImage2D("../resource/textures/Neptune_Diffuse.dds"),
-                TextureImage2D("../resource/textures/Neptune_Clouds_Diffuse.dds")
-            }, TextureImage2D("../resource/textures/Neptune_Normal.dds"), L"Neptune", L"Нептун");
+                _textureLoader->Load("../resource/textures/Neptune_Diffuse.dds"),
+                _textureLoader->Load("../resource/textures/Neptune_Clouds_Diffuse.dds")
+            }, _textureLoader->Load("../resource/textures/Neptune_Normal.dds"), L"Neptune", L"Нептун");
     shared_ptr<Planet> neptune = make_shared<Neptune>(neptuneInfo, _sun);
 
-    SatelliteInfo tritonInfo(sphereModel, 0.2724, *_mainPlanetShader, {TextureImage2D("../resource/textures/Triton_Diffuse.dds")}, TextureImage2D("../resource/textures/Triton_Normal.dds"),
-                             L"Triton", L"Тритон");
-    shared_ptr<Satellite> triton = make_shared<Triton>(tritonInfo, neptune);
-
-    CloudsInfo neptuneCloudsInfo(sphereModel, *_mainCloudsShader, 3.87, TextureImage2D("../resource/textures/Neptune_Clouds_Diffuse.dds"),
-                                TextureImage2D("../resource/textures/Neptune_Clouds_Normal.dds"));
-    unique_ptr<Clouds> neptuneClouds = make_unique<NeptuneClouds>(neptuneCloudsInfo, neptune);
-
-    AtmosphereInfo neptuneAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 3.9, glm::vec3(62.f/255, 92.f/255, 169.f/255), neptune->GetRadius() - 0.00007, 7.9);
-    unique_ptr<Atmosphere> neptuneAtmosphere = make_unique<Atmosphere>(neptuneAtmosphereInfo, neptune);
-
-    const glm::mat4 lightProjection = glm::ortho(-neptune->GetRadius() * 3.0f, neptune->GetRadius() * 3.0f, -neptune->GetRadius() * 3.0f, neptune->GetRadius() * 3.0f, camera.GetNear(), camera.GetFar());
-    const glm::mat4 lightView = glm::lookAt(_sun->GetPosition(), neptune->GetPosition() - _sun->GetPosition(), glm::vec3(0.0, 1.0, 0.0));
-    const glm::mat4 lightSpaceMatrix = lightProjection * lightView;
-
-    RenderableAtmosphere renderableNeptuneAtmosphere;
-    renderableNeptuneAtmosphere.atmosphere = move(neptuneAtmosphere);
-    renderableNeptuneAtmosphere.hScaleFactor = 23.0;
-    renderableNeptuneAtmosphere.parentEarthSizeCoefficient = neptune->GetEarthSizeCoefficient();
-    renderableNeptuneAtmosphere.isUseToneMapping = true;
-
     RenderableSceneComponent neptuneSystemComponent;
-    neptuneSystemComponent.lightSpaceMatrix = lightSpaceMatrix;
     neptuneSystemComponent.planet = move(neptune);
-    neptuneSystemComponent.satellites = vector<shared_ptr<Satellite>>{move(triton)};
-    neptuneSystemComponent.atmospheres.push_back(move(renderableNeptuneAtmosphere));
-    neptuneSystemComponent.clouds = move(neptuneClouds);
+    neptuneSystemComponent.lazyParts = {
+            {{"../resource/textures/Triton_Diffuse.dds", "../resource/textures/Triton_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo tritonInfo(sphereModel, 0.2724, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Triton_Diffuse.dds")},
+                                         _textureLoader->Load("../resource/textures/Triton_Normal.dds"), L"Triton", L"Тритон");
+                component.satellites.push_back(make_shared<Triton>(tritonInfo, component.planet));
+            }},
+            {{"../resource/textures/Neptune_Clouds_Normal.dds"}, [this, sphereModel](RenderableSceneComponent& component) { // The diffuse is already taken by the planet
+                CloudsInfo neptuneCloudsInfo(sphereModel, *_mainCloudsShader, 3.87, _textureLoader->Load("../resource/textures/Neptune_Clouds_Diffuse.dds"),
+                                             _textureLoader->Load("../resource/textures/Neptune_Clouds_Normal.dds"));
+                component.clouds = make_unique<NeptuneClouds>(neptuneCloudsInfo, component.planet);
+            }},
+            {{}, [this, sphereModel](RenderableSceneComponent& component) {
+                const auto& neptune = component.planet;
+                AtmosphereInfo neptuneAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 3.9, glm::vec3(62.f/255, 92.f/255, 169.f/255), neptune->GetRadius() - 0.00007, 7.9);
+
+                RenderableAtmosphere renderableNeptuneAtmosphere;
+                renderableNeptuneAtmosphere.atmosphere = make_unique<Atmosphere>(neptuneAtmosphereInfo, neptune);
+                renderableNeptuneAtmosphere.hScaleFactor = 23.0;
+                renderableNeptuneAtmosphere.parentEarthSizeCoefficient = neptune->GetEarthSizeCoefficient();
+                renderableNeptuneAtmosphere.isUseToneMapping = true;
+                component.atmospheres.push_back(move(renderableNeptuneAtmosphere));
+            }}
+    };
+    SetResidencyDistances(neptuneSystemComponent, 42.5f); // Triton orbit
     _renderableSceneComponents.push_back(move(neptuneSystemComponent));
 }
 
 void Application::InitPlutoSystem(const MeshHolder& sphereModel) {
+    ProfileScope profileScope("system", "InitPlutoSystem");
     PlanetInfo plutoInfo(sphereModel, 0.18651, *_mainPlanetShader,
             {
-                TextureImage2D("../resource/textures/Pluto_Diffuse.dds"),
-            }, TextureImage2D("../resource/textures/Pluto_Normal.dds"), L"Pluto", L"Плутон", TextureImage2D("../resource/textures/Pluto_Specular.dds"));
+                _textureLoader->Load("../resource/textures/Pluto_Diffuse.dds"),
+            }, _textureLoader->Load("../resource/textures/Pluto_Normal.dds"), L"Pluto", L"Плутон", _textureLoader->Load("../resource/textures/Pluto_Specular.dds"));
     shared_ptr<Planet> pluto = make_shared<Pluto>(plutoInfo, _sun);
 
-    SatelliteInfo charonInfo(sphereModel, 0.09512, *_mainPlanetShader, {TextureImage2D("../resource/textures/Charon_Diffuse.dds")}, TextureImage2D("../resource/textures/Charon_Normal.dds"),
-                             L"Charon", L"Харон", TextureImage2D("../resource/textures/Charon_Specular.dds"));
-    shared_ptr<Satellite> charon  = make_shared<Charon>(charonInfo, pluto);
-
-    AtmosphereInfo plutoAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 0.45, glm::vec3(92.f/255, 120.f/255, 141.f/255), pluto->GetRadius(), 1.0,
-                                       glm::vec3(35.f/255, 52.f/255, 220.f/255));
-    unique_ptr<Atmosphere> plutoAtmosphere = make_unique<Atmosphere>(plutoAtmosphereInfo, pluto);
-
-    const glm::mat4 lightProjection = glm::ortho(-pluto->GetRadius() * 3.0f, pluto->GetRadius() * 3.0f, -pluto->GetRadius() * 3.0f, pluto->GetRadius() * 3.0f, camera.GetNear(), camera.GetFar());
-    const glm::mat4 lightView = glm::lookAt(_sun->GetPosition(), pluto->GetPosition() - _sun->GetPosition(), glm::vec3(0.0, 1.0, 0.0));
-    const glm::mat4 lightSpaceMatrix = lightProjection * lightView;
-
-    RenderableAtmosphere renderablePlutoAtmosphere;
-    renderablePlutoAtmosphere.atmosphere = move(plutoAtmosphere);
-    renderablePlutoAtmosphere.hScaleFactor = 16.0;
-    renderablePlutoAtmosphere.parentEarthSizeCoefficient = pluto->GetEarthSizeCoefficient();
-    renderablePlutoAtmosphere.isUseToneMapping = true;
-
     RenderableSceneComponent plutoSystemComponent;
-    plutoSystemComponent.lightSpaceMatrix = lightSpaceMatrix;
     plutoSystemComponent.planet = move(pluto);
-    plutoSystemComponent.satellites = vector<shared_ptr<Satellite>>{move(charon)};
-    plutoSystemComponent.atmospheres.push_back(move(renderablePlutoAtmosphere));
+    plutoSystemComponent.lazyParts = {
+            {{"../resource/textures/Charon_Diffuse.dds", "../resource/textures/Charon_Normal.dds", "../resource/textures/Charon_Specular.dds"},
+             [this, sphereModel](RenderableSceneComponent& component) {
+                SatelliteInfo charonInfo(sphereModel, 0.09512, *_mainPlanetShader, {_textureLoader->Load("../resource/textures/Charon_Diffuse.dds")},
+                                         _textureLoader->Load("../resource/textures/Charon_Normal.dds"), L"Charon", L"Харон", _textureLoader->Load("../resource/textures/Charon_Specular.dds"));
+                component.satellites.push_back(make_shared<Charon>(charonInfo, component.planet));
+            }},
+            {{}, [this, sphereModel](RenderableSceneComponent& component) {
+                const auto& pluto = component.planet;
+                AtmosphereInfo plutoAtmosphereInfo(sphereModel, *_mainAtmosphereShader, 0.45, glm::vec3(92.f/255, 120.f/255, 141.f/255), pluto->GetRadius(), 1.0,
+                                                   glm::vec3(35.f/255, 52.f/255, 220.f/255));
+
+                RenderableAtmosphere renderablePlutoAtmosphere;
+                renderablePlutoAtmosphere.atmosphere = make_unique<Atmosphere>(plutoAtmosphereInfo, pluto);
+                renderablePlutoAtmosphere.hScaleFactor = 16.0;
+                renderablePlutoAtmosphere.parentEarthSizeCoefficient = pluto->GetEarthSizeCoefficient();
+                renderablePlutoAtmosphere.isUseToneMapping = true;
+                component.atmospheres.push_back(move(renderablePlutoAtmosphere));
+            }}
+    };
+    SetResidencyDistances(plutoSystemComponent, 25.0f); // Charon orbit
     _renderableSceneComponents.push_back(move(plutoSystemComponent));
 }
 
@@ -1316,6 +2182,18 @@ void Application::KeyCallback(GLFWwindow*, int key, int, int action, int) {
         isVertSyncEnabled = !isVertSyncEnabled;
         VertSync(isVertSyncEnabled);
     }
+    if (key == GLFW_KEY_F2 && action == GLFW_PRESS) {
+        isUniformBenchmarkRequested = true;
+    }
+    if (key == GLFW_KEY_F3 && action == GLFW_PRESS) {
+        isEclipseShadows = !isEclipseShadows;
+    }
+    if (key == GLFW_KEY_F4 && action == GLFW_PRESS) {
+        isStarOcclusionProxy = !isStarOcclusionProxy;
+    }
+    if (key == GLFW_KEY_F5 && action == GLFW_PRESS) {
+        isBakedStarNoise = !isBakedStarNoise;
+    }
 }
 
 bool Application::WGLExtensionSupported(const char* extensionName) {
@@ -1357,11 +2235,30 @@ void Application::StopPlayBackgroundMusic() {
 }
 
 void Application::Dispose() {
+    StopSearchNearestPlanet();
+    StopPlayBackgroundMusic();
+    if (_textureStreamer)
+        _textureStreamer->PrintStatistics();
+    if (_instanceBatcher)
+        _instanceBatcher->PrintStatistics();
+    // Textures are deleted together with the last object using them, so it must happen while the GL context is still alive
+    _renderableSceneComponents.clear();
+    _sun.reset();
+    _lensFlare.reset();
+    _sunOcclusionQueries.reset();
+    _starFragmentQueries.reset();
+    _starOcclusionProxyShader.reset();
+    for (auto& starTimeQueries : _starTimeQueries)
+        starTimeQueries.reset();
+    _starNoiseVolume.reset();
+    _uniformRingBuffer.reset();
+    _instanceBatcher.reset();
+    _sphereLods.reset();
+    GeometryArena::Instance().Release();
+    MaterialTable::Instance().Release();
     glfwTerminate();
     SDL_Quit();
     IMG_Quit();
-    StopSearchNearestPlanet();
-    StopPlayBackgroundMusic();
     _soundEngine->drop();
 }
 
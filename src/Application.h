@@ -9,22 +9,130 @@ namespace {
     float lastX, lastY;
     float starExposure = 8.0f, starGamma = 0.4545454f, starTemperatureInKelvin = 5778.0f;
     double deltaTime = 0.0, lastFrame = 0.0;
-    bool isFirstMouse = true, isTimeRun = true, isRenderHints = true, isRenderPlanetStarDistances = true, isRenderSatelliteDistances = true, isVertSyncEnabled = true;
+    bool isFirstMouse = true, isTimeRun = true, isRenderHints = true, isRenderPlanetStarDistances = true, isRenderSatelliteDistances = true, isVertSyncEnabled = true,
+        isUniformBenchmarkRequested = false, isEclipseShadows = true, isStarOcclusionProxy = true, isBakedStarNoise = true;
+
+    // Depth format of the shadow map layers and the PCF taps of the planet and ring shaders (clouds take half of them)
+    constexpr ShadowDepthFormat shadowDepthFormat = ShadowDepthFormat::Depth16;
+    constexpr int shadowPcfTaps = 8;
+
+    // The animation of the baked star noise advances this many times per second instead of every frame
+    constexpr float starNoiseUpdateRate = 30.0f;
 }
 
+enum StarTimedPass : uint8_t {
+    Corona,
+    Surface,
+    Glow,
+    StarTimedPassesCount
+};
+
 struct RenderableAtmosphere {
     std::unique_ptr<Atmosphere> atmosphere;
     float hScaleFactor, parentEarthSizeCoefficient;
     bool isUseToneMapping = false;
 };
 
-struct RenderableSceneComponent {
+// Uniforms which are set for each atmosphere or each scene component, resolved once after the shaders are created
+struct AtmosphereUniforms {
+    UniformHandle<glm::vec3> camPosition, lightPos, mieTint, ringParentPlanetCenter, ringCenter, ringNormal;
+    UniformHandle<glm::vec2> ringInnerOuterRadiuses;
+    UniformHandle<float> hScaleFactor, earthSizeCoefficient, ringParentPlanetRadiusSquared;
+    UniformHandle<bool> isUseToneMapping, isNearbyPlanetaryRing, isUseSphereIntersect;
+    UniformHandle<int> ringDiffuse, eclipseCaster;
+};
+
+struct PlanetComponentUniforms { // The ring of the component is in its light block
+    UniformHandle<float> yRotation;
+    UniformHandle<int> eclipseCaster; // Per body rather than per component, see Application::FindEclipseCaster
+};
+
+// std140 uniform blocks from resource/shaders/uniformBlocks.glsl, the layout of the structs must match them
+enum UniformBlockBinding : GLuint {
+    FrameBlockBinding = 0,
+    LightBlockBinding = 1
+};
+
+constexpr GLuint LightBufferBinding = 2; // Shader storage binding of the lights of all components, read by the instanced programs
+
+struct FrameUniforms {
+    glm::mat4 projection;
+    glm::mat4 view;
+    glm::vec3 cameraPosition;
+    float zCoef;
+    glm::vec3 lightPosition;
+    float farPlane;
+    glm::vec3 starGlowTint;
+    float time;
+};
+
+constexpr int32_t MAX_ECLIPSE_CASTERS = 8; // Saturn with its seven satellites
+
+struct LightUniforms {
     glm::mat4 lightSpaceMatrix;
+    int32_t shadowLayer; // Of the shadow map array, -1 if no caster of the component is drawn into it
+    float depthNear, depthFar; // Distances from the sun covered by the depth of the layer
+    int32_t eclipseCastersCount;
+    glm::vec4 eclipseCasters[MAX_ECLIPSE_CASTERS]; // Spheres shaded analytically, xyz = center, w = radius
+    float sunRadius;
+    int32_t hasRing; // Of the planet, the ring shades the bodies of the component
+    float parentPlanetRadiusSquared;
+    int32_t padding0;
+    glm::vec3 parentPlanetCenter;
+    float ringInnerRadius;
+    glm::vec3 ringCenter;
+    float ringOuterRadius;
+    glm::vec3 ringNormal;
+    int32_t padding1;
+};
+
+// LightUniforms has the same layout in the std430 LightBuffer
+static_assert(sizeof(FrameUniforms) == 176 && sizeof(LightUniforms) == 272, "The structs must follow the std140 layout of the uniform blocks");
+
+struct RenderableSceneComponent;
+
+// A satellite, an atmosphere, clouds or a ring, which is created only when the camera comes near its planet
+struct LazySceneComponentPart {
+    std::vector<std::string> texturePaths; // Parsed by the loader workers before the part is materialized
+    std::function<void(RenderableSceneComponent&)> materialize;
+};
+
+// Result of the frustum test of the current frame. Culled bodies are still moved along their orbits, but not drawn
+struct SceneComponentVisibility {
+    bool isComponent = true, isPlanet = true, isClouds = true, isRing = true;
+    std::vector<uint8_t> satellites, atmospheres;
+
+    // Levels of SphereLodChain picked by the projected size, 0 for bodies with their own models
+    size_t planetLevel = 0, planetShadowLevel = 0;
+    std::vector<size_t> satelliteLevels, satelliteShadowLevels;
+};
+
+struct CullingStatistics {
+    size_t testedObjects = 0, culledObjects = 0, culledComponents = 0;
+};
+
+enum class SceneComponentResidency {
+    Proxy, // Only the planet itself, its textures are kept at the least detailed levels by the streamer
+    Loading,
+    Resident
+};
+
+struct RenderableSceneComponent {
+    glm::mat4 lightSpaceMatrix = glm::mat4(1.0f); // Fitted every frame while the component is visible
+    glm::vec2 lightDepthRange = glm::vec2(0.0f, 1.0f);
+    size_t shadowLayer = 0; // The index of the component
+    GLintptr lightBlockOffset = 0; // Offset of this frame's light block in the uniform ring buffer
     std::shared_ptr<Planet> planet;
     std::vector<std::shared_ptr<Satellite>> satellites;
     std::vector<RenderableAtmosphere> atmospheres;
     std::unique_ptr<Clouds> clouds;
     std::unique_ptr<PlanetaryRing> planetaryRing;
+    SceneComponentVisibility visibility;
+
+    std::vector<LazySceneComponentPart> lazyParts;
+    SceneComponentResidency residency = SceneComponentResidency::Proxy;
+    size_t materializedPartsCount = 0;
+    float loadDistance = 0.0f, unloadDistance = 0.0f; // The gap between them keeps a system from being loaded and unloaded every frame
 };
 
 class Application {
@@ -44,16 +152,42 @@ private:
     std::string _currentMusicTrack;
     glm::mat4 _cameraProjection = glm::mat4(), _cameraView = glm::mat4();
     std::unique_ptr<std::thread> _backgroundMusicThread, _searchNearestPlanetThread;
+    std::unique_ptr<TextureStreamer> _textureStreamer;
+    std::unique_ptr<TextureLoader> _textureLoader;
     std::unique_ptr<TextRenderer> _textRenderer;
+    std::unique_ptr<UniformRingBuffer> _uniformRingBuffer;
+    std::unique_ptr<InstanceBatcher> _instanceBatcher;
     std::unique_ptr<ShadowMapFBO> _shadowMapFBO;
+    std::unique_ptr<ShadowCache> _shadowCache;
     std::unique_ptr<HDR> _hdr;
     std::unique_ptr<SkyBox> _skyBox;
-    std::unique_ptr<Shader> _shadowMapShader;
+    std::unique_ptr<Shader> _shadowMapShader, _instancedPlanetShader; // The shadow map shader is the instanced and layered variant
+    std::unique_ptr<Shader> _impostorPlanetShader, _instancedImpostorShader; // Ray traced spheres, see SphereLodChain
+    std::unique_ptr<SphereLodChain> _sphereLods;
     std::unique_ptr<Shader> _mainSkyBoxShader, _mainTextShader, _mainStarShader, _mainCoronaStarShader, _mainPlanetShader, _mainAtmosphereShader, _mainCloudsShader,
         _mainRingShader;
     std::unique_ptr<LensFlare> _lensFlare;
+    std::unique_ptr<OcclusionQueryRing> _sunOcclusionQueries;
+    std::unique_ptr<StatisticsQueryRing> _starFragmentQueries; // Fragment shader invocations of the star path, null without ARB_pipeline_statistics_query
+    std::unique_ptr<Shader> _starOcclusionProxyShader;
+    uint64_t _starFragmentInvocations = 0;
+    std::unique_ptr<NoiseVolume> _starNoiseVolume;
+    std::array<std::unique_ptr<StatisticsQueryRing>, StarTimedPassesCount> _starTimeQueries; // GL_TIME_ELAPSED of each star pass
+    std::array<uint64_t, StarTimedPassesCount> _starTimes {}; // Nanoseconds
+    float _sunMeasuredVisibility = 1.0f; // The last read back value, the one given to the sun is smoothed over time
     std::shared_ptr<Star> _sun;
     std::vector<RenderableSceneComponent> _renderableSceneComponents;
+    AtmosphereUniforms _atmosphereUniforms;
+    PlanetComponentUniforms _planetComponentUniforms, _impostorComponentUniforms;
+    std::vector<LightUniforms> _lights; // Of all components in this frame, in their order
+    UniformHandle<int> _cloudsEclipseCaster;
+    UniformBenchmark _uniformBenchmark;
+    RenderStateCache& _renderState = RenderStateCache::Instance();
+    RenderQueue _renderQueue;
+    size_t _lastFrameDrawCalls = 0, _lastFrameTriangles = 0;
+    CullingStatistics _lastFrameCulling;
+    std::vector<BoundingSphere> _boundingSpheres;
+    std::vector<uint8_t> _boundingSpheresVisibility;
     std::vector<std::string_view> _backgroundSongs;
 
     void InitSystems();
@@ -68,6 +202,8 @@ private:
     void InitUranusSystem(const MeshHolder& sphereModel);
     void InitNeptuneSystem(const MeshHolder& sphereModel);
     void InitPlutoSystem(const MeshHolder& sphereModel);
+    void PrefetchSceneTextures();
+    void InitUniformHandles();
     void InitSongList();
     void Dispose();
     void StartSearchNearestPlanet();
@@ -77,24 +213,45 @@ private:
     void LoadWindowIcon() const;
     void DisplaySystemInformation() const;
     void ProcessSceneComponentsRendering();
-    void ShadowMapPass(const RenderableSceneComponent& component);
-    void RenderPass(const RenderableSceneComponent& component);
+    void ShadowMapPass();
+    bool AddShadowCasters(const RenderableSceneComponent& component, std::vector<ShadowCache::Caster>& casters);
+    void SubmitOpaqueDraws(const RenderableSceneComponent& component);
+    void SubmitTransparentDraws(const RenderableSceneComponent& component);
+    void AdvanceCulledComponent(const RenderableSceneComponent& component);
     void ProcessStarRendering();
     void RenderStarCorona() const;
     void RenderStar() const;
     void RenderStarEffects() const;
-    void RenderAtmospheres(const std::vector<RenderableAtmosphere>& renderableAtmospheres, const glm::mat4& lightSpaceMatrix, const PlanetaryRing* ring) const;
-    void RenderClouds(Clouds* renderableClouds, const glm::mat4& lightSpaceMatrix) const;
-    void RenderPlanetaryRing(const Shader& shader, PlanetaryRing* planetaryRing, const glm::mat4& lightSpaceMatrix) const;
+    void SubmitPlanet(const RenderableSceneComponent& component);
+    void SubmitSatellites();
+    void DrawSatellitesInstanced();
+    void SubmitAtmosphere(const RenderableSceneComponent& component, const RenderableAtmosphere& renderableAtmosphere);
+    void SubmitClouds(const RenderableSceneComponent& component);
+    void SubmitPlanetaryRing(const RenderableSceneComponent& component);
     void RenderPlanetSatelliteStarDistances() const;
     void RenderSpaceObjectDistance(const SpaceObject* spaceObject) const;
     void RenderHints() const;
+    void UpdateFrameUniforms();
+    void UpdateSceneComponentsVisibility();
+    void SelectSphereLevels(RenderableSceneComponent& component) const;
+    void UpdateLightSpaceMatrices();
+    void FitLightFrustum(RenderableSceneComponent& component) const;
+    LightUniforms MakeLightUniforms(const RenderableSceneComponent& component) const;
+    // Index of the body in the eclipse casters of the light block of its component, -1 if it is not one
+    int32_t FindEclipseCaster(const RenderableSceneComponent& component, const SpaceObject& body) const;
     void ConfigureMainShaders();
-    void ConfigureMainPlanetShader(const RenderableSceneComponent& renderableComponent);
-    void UpdateOcclusionQuery();
+    void ConfigurePlanetShader(const Shader& shader, const PlanetComponentUniforms& uniforms, const RenderableSceneComponent& renderableComponent);
+    void UpdateSunVisibility();
+    void UpdateStarStatistics();
+    void UpdateSceneComponentsResidency();
+    void UpdateTextureStreaming();
     void ProcessInput(GLFWwindow* window);
     float CalculateSpaceObjectDistance(const SpaceObject* spaceObject) const;
+    const MeshHolder& GetLevelModel(const SpaceObject& body, size_t level) const; // The own model at level 0
     glm::vec3 CurrentFpsColor() const;
+    static float CalculateShellSortDistance(float centerDistance, float radius); // Sort key of a transparent shell
+    static void SetResidencyDistances(RenderableSceneComponent& component, float systemRadius);
+    static void DematerializeSceneComponent(RenderableSceneComponent& component);
     static void FramebufferSizeCallback(GLFWwindow* window, int width, int height);
     static void MouseCallback(GLFWwindow* window, double xPos, double yPos);
     static void ScrollCallback(GLFWwindow* window, double xoffset, double yOffset);
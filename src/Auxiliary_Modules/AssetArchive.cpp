@@ -0,0 +1,289 @@
+#include "AssetArchive.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <zlib.h>
+
+namespace {
+    constexpr char assetArchiveMagic[4] = {'S', 'S', 'P', 'K'};
+    constexpr uint32_t assetArchiveVersion = 2;
+    constexpr uint32_t codecStored = 0, codecZlib = 1;
+    constexpr size_t chunkSize = 1024 * 1024; // Big enough for a good ratio, small enough to inflate big files on several threads
+    constexpr size_t storedAlignment = 4096; // Page size, stored entries are used in place like separately mapped files
+    std::atomic<unsigned> inflateHelpersCount {0}; // Threads inflating chunks for all archives, see AssetArchive::Inflate
+
+    struct AssetArchiveHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t entriesCount;
+        uint32_t chunksCount;
+        uint64_t indexOffset;
+    };
+
+    struct AssetArchiveChunk {
+        uint64_t offset;
+        uint32_t storedSize;
+        uint32_t size;
+    };
+
+    struct AssetArchiveEntry {
+        uint32_t pathLength; // The path follows the entry
+        uint32_t codec;
+        uint64_t size;
+        uint32_t firstChunk;
+        uint32_t chunksCount;
+        uint64_t sourceSize;
+        int64_t sourceWriteTime;
+    };
+
+    template<typename T>
+    T ReadStruct(const uint8_t* data, size_t fileSize, size_t offset, const std::string& path) {
+        if (offset + sizeof(T) > fileSize)
+            throw std::runtime_error(path + " has a damaged index");
+
+        T value;
+        std::memcpy(&value, data + offset, sizeof(T));
+        return value;
+    }
+
+    template<typename T>
+    void WriteStruct(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+}
+
+AssetArchive::AssetArchive(const std::string& path) : _file(std::make_shared<const MappedFile>(path)) {
+    const uint8_t* data = _file->GetData();
+    const size_t fileSize = _file->GetSize();
+    const auto header = ReadStruct<AssetArchiveHeader>(data, fileSize, 0, path);
+
+    if (std::memcmp(header.magic, assetArchiveMagic, sizeof(assetArchiveMagic)) != 0 || header.version != assetArchiveVersion)
+        throw std::runtime_error(path + " is not an asset archive or has an old version");
+
+    size_t offset = header.indexOffset;
+    _chunks.reserve(header.chunksCount);
+    for (uint32_t i = 0; i < header.chunksCount; i++, offset += sizeof(AssetArchiveChunk)) {
+        const auto chunk = ReadStruct<AssetArchiveChunk>(data, fileSize, offset, path);
+        if (chunk.offset + chunk.storedSize > fileSize)
+            throw std::runtime_error(path + " is truncated");
+
+        _chunks.push_back(Chunk{chunk.offset, chunk.storedSize, chunk.size});
+    }
+
+    uint64_t compressedEnd = 0;
+    for (uint32_t i = 0; i < header.entriesCount; i++) {
+        const auto entry = ReadStruct<AssetArchiveEntry>(data, fileSize, offset, path);
+        offset += sizeof(AssetArchiveEntry);
+
+        if (offset + entry.pathLength > fileSize || static_cast<size_t>(entry.firstChunk) + entry.chunksCount > _chunks.size())
+            throw std::runtime_error(path + " has a damaged index");
+
+        std::string virtualPath(reinterpret_cast<const char*>(data + offset), entry.pathLength);
+        offset += entry.pathLength;
+
+        if (entry.codec == codecZlib && entry.chunksCount > 0) {
+            const auto& lastChunk = _chunks[entry.firstChunk + entry.chunksCount - 1];
+            compressedEnd = std::max(compressedEnd, lastChunk.offset + lastChunk.storedSize);
+        }
+
+        _entries.emplace(std::move(virtualPath), Entry{entry.size, entry.codec, entry.firstChunk, entry.chunksCount,
+                                                       FileStamp{entry.sourceSize, entry.sourceWriteTime}});
+    }
+
+    // Small compressed files (shaders, models, fonts) are all needed at startup, one read ahead instead of many page faults
+    _file->Prefetch(0, compressedEnd);
+}
+
+bool AssetArchive::Contains(const std::string& virtualPath) const {
+    return _entries.count(virtualPath) != 0;
+}
+
+AssetFile AssetArchive::Read(const std::string& virtualPath) const {
+    const auto entryIt = _entries.find(virtualPath);
+    if (entryIt == _entries.end())
+        throw std::runtime_error(virtualPath + " is not in the asset archive");
+
+    const Entry& entry = entryIt->second;
+    if (entry.codec == codecStored)
+        return AssetFile(_file, entry.chunksCount > 0 ? _chunks[entry.firstChunk].offset : 0, entry.size);
+
+    return AssetFile(Inflate(entry, virtualPath));
+}
+
+FileStamp AssetArchive::GetSourceStamp(const std::string& virtualPath) const {
+    const auto entryIt = _entries.find(virtualPath);
+    if (entryIt == _entries.end())
+        throw std::runtime_error(virtualPath + " is not in the asset archive");
+
+    return entryIt->second.sourceStamp;
+}
+
+size_t AssetArchive::GetEntriesCount() const {
+    return _entries.size();
+}
+
+size_t AssetArchive::GetSize() const {
+    return _file->GetSize();
+}
+
+void AssetArchive::Bake(const std::string& archivePath, const std::vector<std::pair<std::string, std::string>>& files) {
+    std::ofstream archive(archivePath, std::ios::binary | std::ios::trunc);
+    if (!archive)
+        throw std::runtime_error("Cannot write " + archivePath);
+
+    AssetArchiveHeader header {};
+    std::memcpy(header.magic, assetArchiveMagic, sizeof(assetArchiveMagic));
+    header.version = assetArchiveVersion;
+    WriteStruct(archive, header); // Rewritten at the end, when the index offset is known
+
+    std::vector<AssetArchiveChunk> chunks;
+    std::vector<std::pair<AssetArchiveEntry, std::string>> entries;
+    std::vector<std::pair<std::string, std::string>> storedFiles; // Written after all compressed ones
+    uint64_t position = sizeof(header);
+
+    const auto readFile = [](const std::string& diskPath) {
+        std::ifstream file(diskPath, std::ios::binary);
+        if (!file)
+            throw std::runtime_error("Cannot read " + diskPath);
+        return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+
+    for (const auto& [virtualPath, diskPath] : files) {
+        // DDS files are streamed by mip levels for as long as their textures live, so they must stay mapped and are never inflated to the heap
+        const bool isDDS = virtualPath.size() >= 4 && virtualPath.compare(virtualPath.size() - 4, 4, ".dds") == 0;
+        if (isDDS) {
+            storedFiles.emplace_back(virtualPath, diskPath);
+            continue;
+        }
+
+        const std::vector<uint8_t> bytes = readFile(diskPath);
+        const FileStamp sourceStamp = FileStamp::Of(diskPath).value_or(FileStamp{});
+
+        // Compress chunk by chunk, the entry is stored as is if it does not get at least 10% smaller
+        std::vector<std::vector<uint8_t>> compressedChunks;
+        size_t compressedSize = 0;
+
+        for (size_t offset = 0; offset < bytes.size(); offset += chunkSize) {
+            const size_t size = std::min<size_t>(chunkSize, bytes.size() - offset); // Explicit type, min is a macro in windows.h
+            uLongf storedSize = compressBound(static_cast<uLong>(size));
+            std::vector<uint8_t> compressed(storedSize);
+
+            if (compress2(compressed.data(), &storedSize, bytes.data() + offset, static_cast<uLong>(size), Z_BEST_COMPRESSION) != Z_OK)
+                throw std::runtime_error("Cannot compress " + diskPath);
+
+            compressed.resize(storedSize);
+            compressedSize += storedSize;
+            compressedChunks.push_back(std::move(compressed));
+        }
+
+        // The codec decides the place: compressed entries go first, so that the constructor reads them ahead with one range
+        if (compressedSize * 10 >= bytes.size() * 9) {
+            storedFiles.emplace_back(virtualPath, diskPath);
+            continue;
+        }
+
+        AssetArchiveEntry entry {static_cast<uint32_t>(virtualPath.size()), codecZlib, bytes.size(), static_cast<uint32_t>(chunks.size()), 0,
+                                 sourceStamp.size, sourceStamp.writeTime};
+
+        for (size_t i = 0; i < compressedChunks.size(); i++) {
+            const auto& compressed = compressedChunks[i];
+            archive.write(reinterpret_cast<const char*>(compressed.data()), compressed.size());
+
+            const size_t size = std::min<size_t>(chunkSize, bytes.size() - i * chunkSize);
+            chunks.push_back(AssetArchiveChunk{position, static_cast<uint32_t>(compressed.size()), static_cast<uint32_t>(size)});
+            position += compressed.size();
+        }
+
+        entry.chunksCount = static_cast<uint32_t>(chunks.size()) - entry.firstChunk;
+        entries.emplace_back(entry, virtualPath);
+    }
+
+    // Stored files are read again instead of being kept in memory, they are the big textures
+    for (const auto& [virtualPath, diskPath] : storedFiles) {
+        const std::vector<uint8_t> bytes = readFile(diskPath);
+        const FileStamp sourceStamp = FileStamp::Of(diskPath).value_or(FileStamp{});
+        const uint64_t alignedPosition = (position + storedAlignment - 1) / storedAlignment * storedAlignment;
+        archive.write(std::string(alignedPosition - position, '\0').data(), alignedPosition - position);
+        archive.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+
+        entries.emplace_back(AssetArchiveEntry{static_cast<uint32_t>(virtualPath.size()), codecStored, bytes.size(), static_cast<uint32_t>(chunks.size()), 1,
+                                               sourceStamp.size, sourceStamp.writeTime}, virtualPath);
+        chunks.push_back(AssetArchiveChunk{alignedPosition, static_cast<uint32_t>(bytes.size()), static_cast<uint32_t>(bytes.size())});
+        position = alignedPosition + bytes.size();
+    }
+
+    header.entriesCount = static_cast<uint32_t>(entries.size());
+    header.chunksCount = static_cast<uint32_t>(chunks.size());
+    header.indexOffset = position;
+
+    for (const auto& chunk : chunks)
+        WriteStruct(archive, chunk);
+
+    for (const auto& [entry, virtualPath] : entries) {
+        WriteStruct(archive, entry);
+        archive.write(virtualPath.data(), virtualPath.size());
+    }
+
+    archive.seekp(0);
+    WriteStruct(archive, header);
+
+    if (!archive)
+        throw std::runtime_error("Cannot write " + archivePath);
+}
+
+std::vector<uint8_t> AssetArchive::Inflate(const Entry& entry, const std::string& virtualPath) const {
+    std::vector<uint8_t> bytes(entry.size);
+
+    const auto inflateChunk = [&](uint32_t chunkIndex, size_t outputOffset) {
+        const Chunk& chunk = _chunks[entry.firstChunk + chunkIndex];
+        uLongf size = chunk.size;
+
+        if (outputOffset + chunk.size > bytes.size() ||
+            uncompress(bytes.data() + outputOffset, &size, _file->GetData() + chunk.offset, chunk.storedSize) != Z_OK || size != chunk.size)
+            throw std::runtime_error(virtualPath + " is damaged in the asset archive");
+    };
+
+    std::vector<size_t> outputOffsets(entry.chunksCount);
+    for (uint32_t i = 1; i < entry.chunksCount; i++)
+        outputOffsets[i] = outputOffsets[i - 1] + _chunks[entry.firstChunk + i - 1].size;
+
+    std::atomic<uint32_t> nextChunk {0};
+    const auto inflateChunks = [&] {
+        for (uint32_t i = nextChunk++; i < entry.chunksCount; i = nextChunk++)
+            inflateChunk(i, outputOffsets[i]);
+    };
+
+    // This thread takes chunks together with helpers. The helpers of all calls are limited by the cores, as TextureLoader workers
+    // inflate their files at the same time, and a call which finds no free helper inflates the whole entry itself
+    const unsigned maxHelpersCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    std::vector<std::future<void>> helpers;
+
+    for (uint32_t i = 1; i < entry.chunksCount; i++) {
+        unsigned helpersCount = inflateHelpersCount.load();
+        do {
+            if (helpersCount >= maxHelpersCount)
+                break;
+        } while (!inflateHelpersCount.compare_exchange_weak(helpersCount, helpersCount + 1));
+
+        if (helpersCount >= maxHelpersCount)
+            break;
+
+        helpers.push_back(std::async(std::launch::async, [&inflateChunks] {
+            struct HelperSlot {
+                ~HelperSlot() { inflateHelpersCount--; }
+            } slot;
+            inflateChunks();
+        }));
+    }
+
+    inflateChunks();
+    for (auto& helper : helpers)
+        helper.get(); // Rethrows errors of the helpers
+
+    return bytes;
+}
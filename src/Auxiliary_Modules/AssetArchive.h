@@ -0,0 +1,42 @@
+#ifndef SOLARSYSTEM_ASSETARCHIVE_H
+#define SOLARSYSTEM_ASSETARCHIVE_H
+#include "AssetFile.h"
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// All resources in one memory mapped file: header | data | index. Entries that do not compress and DDS textures (they are streamed
+// from the mapping) are stored as is at page boundaries and used in place. The others are split into chunks compressed with zlib, which are inflated
+// in parallel. Compressed entries go first, so at startup they are read ahead with one sequential read
+class AssetArchive {
+public:
+    explicit AssetArchive(const std::string& path);
+    bool Contains(const std::string& virtualPath) const;
+    AssetFile Read(const std::string& virtualPath) const;
+    FileStamp GetSourceStamp(const std::string& virtualPath) const; // Of the file on disk the entry was baked from
+    size_t GetEntriesCount() const;
+    size_t GetSize() const;
+    // Files are (virtual path, path on disk). Compressed entries are written first and stored ones after them, each in the given order
+    static void Bake(const std::string& archivePath, const std::vector<std::pair<std::string, std::string>>& files);
+
+private:
+    struct Chunk {
+        uint64_t offset;
+        uint32_t storedSize, size;
+    };
+
+    struct Entry {
+        uint64_t size;
+        uint32_t codec;
+        uint32_t firstChunk, chunksCount;
+        FileStamp sourceStamp;
+    };
+
+    std::shared_ptr<const MappedFile> _file;
+    std::unordered_map<std::string, Entry> _entries;
+    std::vector<Chunk> _chunks;
+
+    std::vector<uint8_t> Inflate(const Entry& entry, const std::string& virtualPath) const;
+};
+
+#endif //SOLARSYSTEM_ASSETARCHIVE_H
@@ -0,0 +1,52 @@
+#include "AssetFile.h"
+#include <filesystem>
+
+std::optional<FileStamp> FileStamp::Of(const std::string& path) {
+    std::error_code error;
+    const auto size = std::filesystem::file_size(path, error);
+    if (error)
+        return std::nullopt;
+
+    const auto writeTime = std::filesystem::last_write_time(path, error);
+    if (error)
+        return std::nullopt;
+
+    return FileStamp{size, static_cast<int64_t>(writeTime.time_since_epoch().count())};
+}
+
+bool FileStamp::operator==(const FileStamp& other) const {
+    return size == other.size && writeTime == other.writeTime;
+}
+
+bool FileStamp::operator!=(const FileStamp& other) const {
+    return !(*this == other);
+}
+
+AssetFile::AssetFile(std::shared_ptr<const MappedFile> mapping, size_t offset, size_t size) : _mapping(std::move(mapping)), _size(size) {
+    _data = _mapping->GetData() + offset;
+}
+
+AssetFile::AssetFile(std::vector<uint8_t> bytes) : _bytes(std::make_shared<const std::vector<uint8_t>>(std::move(bytes))) {
+    _data = _bytes->data();
+    _size = _bytes->size();
+}
+
+const uint8_t* AssetFile::GetData() const {
+    return _data;
+}
+
+size_t AssetFile::GetSize() const {
+    return _size;
+}
+
+std::string_view AssetFile::GetText() const {
+    return {reinterpret_cast<const char*>(_data), _size};
+}
+
+uint64_t AssetFile::CalculateHash() const {
+    return MappedFile::CalculateHash(_data, _size);
+}
+
+bool AssetFile::IsMapped() const {
+    return _mapping != nullptr;
+}
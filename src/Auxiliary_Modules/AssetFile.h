@@ -0,0 +1,41 @@
+#ifndef SOLARSYSTEM_ASSETFILE_H
+#define SOLARSYSTEM_ASSETFILE_H
+#include "MappedFile.h"
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Size and last write time of a file on disk. Packed resources and cooked blobs keep the stamp of the file they were made from,
+// so an edited source is noticed even when the copy made from it is newer
+struct FileStamp {
+    uint64_t size = 0;
+    int64_t writeTime = 0; // Ticks of std::filesystem::file_time_type
+
+    static std::optional<FileStamp> Of(const std::string& path); // Empty if there is no such file
+    bool operator==(const FileStamp& other) const;
+    bool operator!=(const FileStamp& other) const;
+};
+
+// Contents of a file opened through VirtualFileSystem. Points into the mapped archive (stored entries), into a mapped
+// loose file, or owns the decompressed bytes. Copies share the same data
+class AssetFile {
+public:
+    AssetFile(std::shared_ptr<const MappedFile> mapping, size_t offset, size_t size);
+    explicit AssetFile(std::vector<uint8_t> bytes);
+
+    const uint8_t* GetData() const;
+    size_t GetSize() const;
+    std::string_view GetText() const;
+    uint64_t CalculateHash() const; // FNV-1a, touches every page like MappedFile::CalculateHash()
+    bool IsMapped() const; // False for the decompressed bytes, which live on the heap
+
+private:
+    std::shared_ptr<const MappedFile> _mapping;
+    std::shared_ptr<const std::vector<uint8_t>> _bytes;
+    const uint8_t* _data = nullptr;
+    size_t _size = 0;
+};
+
+#endif //SOLARSYSTEM_ASSETFILE_H
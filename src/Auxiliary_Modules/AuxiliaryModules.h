@@ -6,8 +6,25 @@
 #include "MeshHolder.h"
 #include "FPS_Handler.h"
 #include "ShadowMapFBO.h"
+#include "ShadowCache.h"
 #include "HDR.h"
 #include "TextRenderer.h"
 #include "LensFlare.h"
+#include "TextureLoader.h"
+#include "ShaderCache.h"
+#include "TextureStreamer.h"
+#include "StartupProfiler.h"
+#include "VirtualFileSystem.h"
+#include "UniformBenchmark.h"
+#include "UniformRingBuffer.h"
+#include "MaterialTable.h"
+#include "RenderStateCache.h"
+#include "RenderQueue.h"
+#include "InstanceBatcher.h"
+#include "Frustum.h"
+#include "SphereLodChain.h"
+#include "OcclusionQueryRing.h"
+#include "StatisticsQueryRing.h"
+#include "NoiseVolume.h"
 
 #endif //SOLARSYSTEM_AUXILIARYMODULES_H
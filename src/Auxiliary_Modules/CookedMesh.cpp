@@ -0,0 +1,115 @@
+#include "CookedMesh.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+    constexpr char cookedMeshMagic[4] = {'S', 'S', 'M', 'B'};
+    constexpr uint32_t cookedMeshVersion = 2;
+
+    struct CookedMeshHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t vertexSize; // The blob is useless if the Vertex layout has changed since cooking
+        uint32_t meshesCount;
+        uint64_t modelSize; // FileStamp of the model the blob was cooked from
+        int64_t modelWriteTime;
+    };
+
+    struct CookedMeshEntry {
+        uint32_t verticesCount;
+        uint32_t indicesCount;
+    };
+}
+
+CookedMesh::CookedMesh(const std::string& path) : _file(VirtualFileSystem::Instance().Open(path)) {
+    const uint8_t* data = _file.GetData();
+    const size_t fileSize = _file.GetSize();
+
+    CookedMeshHeader header {};
+    if (fileSize < sizeof(header))
+        throw std::runtime_error(path + " is not a cooked mesh");
+
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, cookedMeshMagic, sizeof(cookedMeshMagic)) != 0 || header.version != cookedMeshVersion)
+        throw std::runtime_error(path + " is not a cooked mesh or has an old version");
+    if (header.vertexSize != sizeof(Vertex))
+        throw std::runtime_error(path + " was cooked with another vertex layout");
+
+    size_t offset = sizeof(header) + header.meshesCount * sizeof(CookedMeshEntry);
+    if (offset > fileSize)
+        throw std::runtime_error(path + " is truncated");
+
+    _meshes.reserve(header.meshesCount);
+    for (uint32_t i = 0; i < header.meshesCount; i++) {
+        CookedMeshEntry entry {};
+        std::memcpy(&entry, data + sizeof(header) + i * sizeof(CookedMeshEntry), sizeof(entry));
+
+        const size_t verticesSize = entry.verticesCount * sizeof(Vertex), indicesSize = entry.indicesCount * sizeof(uint32_t);
+        if (offset + verticesSize + indicesSize > fileSize)
+            throw std::runtime_error(path + " is truncated");
+
+        // All sizes are multiples of 4 and the data is page aligned or in a heap buffer, so it can be used in place
+        _meshes.push_back(MeshView{reinterpret_cast<const Vertex*>(data + offset), entry.verticesCount,
+                                   reinterpret_cast<const uint32_t*>(data + offset + verticesSize), entry.indicesCount});
+        offset += verticesSize + indicesSize;
+    }
+}
+
+const std::vector<CookedMesh::MeshView>& CookedMesh::GetMeshes() const {
+    return _meshes;
+}
+
+void CookedMesh::Write(const std::string& path, const std::vector<MeshData>& meshes, const FileStamp& modelStamp) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("Cannot write " + path);
+
+    CookedMeshHeader header {};
+    std::memcpy(header.magic, cookedMeshMagic, sizeof(cookedMeshMagic));
+    header.version = cookedMeshVersion;
+    header.vertexSize = sizeof(Vertex);
+    header.meshesCount = static_cast<uint32_t>(meshes.size());
+    header.modelSize = modelStamp.size;
+    header.modelWriteTime = modelStamp.writeTime;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const auto& mesh : meshes) {
+        const CookedMeshEntry entry {static_cast<uint32_t>(mesh.vertices.size()), static_cast<uint32_t>(mesh.indices.size())};
+        file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+
+    for (const auto& mesh : meshes) {
+        file.write(reinterpret_cast<const char*>(mesh.vertices.data()), mesh.vertices.size() * sizeof(Vertex));
+        file.write(reinterpret_cast<const char*>(mesh.indices.data()), mesh.indices.size() * sizeof(uint32_t));
+    }
+
+    if (!file)
+        throw std::runtime_error("Cannot write " + path);
+}
+
+std::string CookedMesh::MakeCookedPath(const std::string& modelPath) {
+    return std::filesystem::path(modelPath).replace_extension(".mesh").generic_string();
+}
+
+bool CookedMesh::IsUpToDate(const std::string& cookedPath, const std::string& modelPath) {
+    const auto& fileSystem = VirtualFileSystem::Instance();
+    std::error_code error;
+    if (!fileSystem.IsPacked(cookedPath) && !std::filesystem::exists(cookedPath, error))
+        return false;
+
+    const auto modelStamp = FileStamp::Of(modelPath);
+    if (!modelStamp) // Only the blob is shipped
+        return true;
+
+    // The same blob the loader would read, packed or loose, must have been cooked from this very model file
+    const AssetFile file = fileSystem.Open(cookedPath);
+    CookedMeshHeader header {};
+    if (file.GetSize() < sizeof(header))
+        return false;
+
+    std::memcpy(&header, file.GetData(), sizeof(header));
+    return std::memcmp(header.magic, cookedMeshMagic, sizeof(cookedMeshMagic)) == 0 && header.version == cookedMeshVersion &&
+           FileStamp{header.modelSize, header.modelWriteTime} == *modelStamp;
+}
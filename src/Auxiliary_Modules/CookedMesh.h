@@ -0,0 +1,30 @@
+#ifndef SOLARSYSTEM_COOKEDMESH_H
+#define SOLARSYSTEM_COOKEDMESH_H
+#include "MeshData.h"
+#include "VirtualFileSystem.h"
+
+// Binary model blob made by MeshCooker from a model file. Vertices and indices are stored exactly as Mesh uploads them to GeometryArena:
+// header | (vertices count, indices count) for each mesh | vertices and indices of each mesh.
+// The header keeps the stamp of the model file, so a blob is stale as soon as the model is edited, wherever the blob is read from.
+// Material textures are not stored, the models of the scene do not use them. Little-endian only
+class CookedMesh {
+public:
+    struct MeshView {
+        const Vertex* vertices;
+        uint32_t verticesCount;
+        const uint32_t* indices;
+        uint32_t indicesCount;
+    };
+
+    explicit CookedMesh(const std::string& path);
+    const std::vector<MeshView>& GetMeshes() const;
+    static void Write(const std::string& path, const std::vector<MeshData>& meshes, const FileStamp& modelStamp);
+    static std::string MakeCookedPath(const std::string& modelPath); // "models/phobos.obj" -> "models/phobos.mesh"
+    static bool IsUpToDate(const std::string& cookedPath, const std::string& modelPath); // The blob exists and was cooked from the model as it is now
+
+private:
+    AssetFile _file;
+    std::vector<MeshView> _meshes;
+};
+
+#endif //SOLARSYSTEM_COOKEDMESH_H
@@ -0,0 +1,216 @@
+#include "DDSImage.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    // Layout is described here: https://learn.microsoft.com/en-us/windows/win32/direct3ddds/dds-header
+    constexpr uint32_t DDSF_FOURCC = 0x00000004;
+    constexpr uint32_t DDSF_CUBEMAP = 0x00000200;
+    constexpr uint32_t DDSF_VOLUME = 0x00200000;
+    constexpr uint32_t FOURCC_DXT1 = 0x31545844; // MAKEFOURCC('D','X','T','1')
+    constexpr uint32_t FOURCC_DXT3 = 0x33545844; // MAKEFOURCC('D','X','T','3')
+    constexpr uint32_t FOURCC_DXT5 = 0x35545844; // MAKEFOURCC('D','X','T','5')
+
+    struct DDS_PIXELFORMAT {
+        uint32_t dwSize;
+        uint32_t dwFlags;
+        uint32_t dwFourCC;
+        uint32_t dwRGBBitCount;
+        uint32_t dwRBitMask;
+        uint32_t dwGBitMask;
+        uint32_t dwBBitMask;
+        uint32_t dwABitMask;
+    };
+
+    struct DDS_HEADER {
+        uint32_t dwSize;
+        uint32_t dwFlags;
+        uint32_t dwHeight;
+        uint32_t dwWidth;
+        uint32_t dwPitchOrLinearSize;
+        uint32_t dwDepth;
+        uint32_t dwMipMapCount;
+        uint32_t dwReserved1[11];
+        DDS_PIXELFORMAT ddspf;
+        uint32_t dwCaps1;
+        uint32_t dwCaps2;
+        uint32_t dwReserved2[3];
+    };
+
+    constexpr size_t ddsMagicSize = 4;
+}
+
+DDSImage::DDSImage(const std::string& path) : _file(VirtualFileSystem::Instance().Open(path)) {
+    ParseHeader(path);
+}
+
+void DDSImage::Upload2D(GLenum target, size_t firstLevel) const {
+    for (size_t i = firstLevel; i < _mipLevels.size(); i++)
+        UploadLevel(target, i);
+}
+
+void DDSImage::UploadLevel(GLenum target, size_t level) const {
+    const auto& mipLevel = _mipLevels.at(level);
+
+    if (_isCompressed) {
+        glCompressedTexImage2D(target, static_cast<GLint>(level), _format, mipLevel.width, mipLevel.height, 0, mipLevel.size, mipLevel.data);
+        return;
+    }
+
+    // Rows of uncompressed images in DDS are tightly packed
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(target, static_cast<GLint>(level), _components, mipLevel.width, mipLevel.height, 0, _format, GL_UNSIGNED_BYTE, mipLevel.data);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+}
+
+void DDSImage::ReleaseLevel(GLenum target, size_t level) const {
+    if (_isCompressed)
+        glCompressedTexImage2D(target, static_cast<GLint>(level), _format, 0, 0, 0, 0, nullptr);
+    else
+        glTexImage2D(target, static_cast<GLint>(level), _components, 0, 0, 0, _format, GL_UNSIGNED_BYTE, nullptr);
+}
+
+void DDSImage::UploadLayerLevel(GLuint arrayTexture, GLint layer, size_t level) const {
+    const auto& mipLevel = _mipLevels.at(level);
+
+    if (_isCompressed) {
+        glCompressedTextureSubImage3D(arrayTexture, static_cast<GLint>(level), 0, 0, layer, mipLevel.width, mipLevel.height, 1, _format, mipLevel.size, mipLevel.data);
+        return;
+    }
+
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTextureSubImage3D(arrayTexture, static_cast<GLint>(level), 0, 0, layer, mipLevel.width, mipLevel.height, 1, _format, GL_UNSIGNED_BYTE, mipLevel.data);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+}
+
+uint64_t DDSImage::CalculateContentHash() const {
+    return _file.CalculateHash();
+}
+
+GLsizei DDSImage::GetWidth() const {
+    return _mipLevels.front().width;
+}
+
+GLsizei DDSImage::GetHeight() const {
+    return _mipLevels.front().height;
+}
+
+GLenum DDSImage::GetFormat() const {
+    return _format;
+}
+
+bool DDSImage::IsCompressed() const {
+    return _isCompressed;
+}
+
+bool DDSImage::IsMapped() const {
+    return _file.IsMapped();
+}
+
+const std::vector<DDSImage::MipLevel>& DDSImage::GetMipLevels() const {
+    return _mipLevels;
+}
+
+size_t DDSImage::GetPayloadSize() const {
+    size_t payloadSize = 0;
+    for (const auto& level : _mipLevels)
+        payloadSize += level.size;
+
+    return payloadSize;
+}
+
+void DDSImage::ParseHeader(const std::string& path) {
+    const uint8_t* data = _file.GetData();
+    const size_t fileSize = _file.GetSize();
+
+    if (fileSize < ddsMagicSize + sizeof(DDS_HEADER) || std::memcmp(data, "DDS ", ddsMagicSize) != 0)
+        throw std::runtime_error(path + " is not a DDS file");
+
+    DDS_HEADER header;
+    std::memcpy(&header, data + ddsMagicSize, sizeof(DDS_HEADER));
+
+    if ((header.dwCaps2 & DDSF_CUBEMAP) || ((header.dwCaps2 & DDSF_VOLUME) && header.dwDepth > 0))
+        throw std::runtime_error(path + ": cube map and volume DDS files are not supported");
+
+    const auto& pixelFormat = header.ddspf;
+
+    if (pixelFormat.dwFlags & DDSF_FOURCC) {
+        _isCompressed = true;
+        switch (pixelFormat.dwFourCC) {
+            case FOURCC_DXT1:
+                _format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+                _components = 3;
+                break;
+            case FOURCC_DXT3:
+                _format = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+                _components = 4;
+                break;
+            case FOURCC_DXT5:
+                _format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                _components = 4;
+                break;
+            default:
+                throw std::runtime_error(path + ": unknown texture compression");
+        }
+    }
+    else if (pixelFormat.dwRGBBitCount == 32 && pixelFormat.dwRBitMask == 0x00FF0000 && pixelFormat.dwGBitMask == 0x0000FF00 &&
+             pixelFormat.dwBBitMask == 0x000000FF && pixelFormat.dwABitMask == 0xFF000000) {
+        _format = GL_BGRA_EXT;
+        _components = 4;
+    }
+    else if (pixelFormat.dwRGBBitCount == 32 && pixelFormat.dwRBitMask == 0x000000FF && pixelFormat.dwGBitMask == 0x0000FF00 &&
+             pixelFormat.dwBBitMask == 0x00FF0000 && pixelFormat.dwABitMask == 0xFF000000) {
+        _format = GL_RGBA;
+        _components = 4;
+    }
+    else if (pixelFormat.dwRGBBitCount == 24 && pixelFormat.dwRBitMask == 0x000000FF && pixelFormat.dwGBitMask == 0x0000FF00 &&
+             pixelFormat.dwBBitMask == 0x00FF0000) {
+        _format = GL_RGB;
+        _components = 3;
+    }
+    else if (pixelFormat.dwRGBBitCount == 24 && pixelFormat.dwRBitMask == 0x00FF0000 && pixelFormat.dwGBitMask == 0x0000FF00 &&
+             pixelFormat.dwBBitMask == 0x000000FF) {
+        _format = GL_BGR_EXT;
+        _components = 3;
+    }
+    else if (pixelFormat.dwRGBBitCount == 8) {
+        _format = GL_LUMINANCE;
+        _components = 1;
+    }
+    else
+        throw std::runtime_error(path + ": unknown texture format");
+
+    // The count in the file includes the main surface
+    const uint32_t levelsCount = std::max<uint32_t>(header.dwMipMapCount, 1);
+    GLsizei width = std::max<GLsizei>(header.dwWidth, 1), height = std::max<GLsizei>(header.dwHeight, 1);
+    size_t offset = ddsMagicSize + sizeof(DDS_HEADER);
+
+    _mipLevels.reserve(levelsCount);
+    for (uint32_t i = 0; i < levelsCount; i++) {
+        const GLsizei levelSize = CalculateLevelSize(width, height);
+
+        if (offset + levelSize > fileSize)
+            throw std::runtime_error(path + " is truncated");
+
+        _mipLevels.push_back(MipLevel{width, height, levelSize, data + offset});
+        offset += levelSize;
+
+        if (width == 1 && height == 1)
+            break;
+
+        width = std::max<GLsizei>(width >> 1, 1);
+        height = std::max<GLsizei>(height >> 1, 1);
+    }
+}
+
+GLsizei DDSImage::CalculateLevelSize(GLsizei width, GLsizei height) const {
+    if (_isCompressed)
+        return ((width + 3) / 4) * ((height + 3) / 4) * (_format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT ? 8 : 16);
+
+    return width * height * _components;
+}
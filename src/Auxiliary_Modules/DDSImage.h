@@ -0,0 +1,42 @@
+#ifndef SOLARSYSTEM_DDSIMAGE_H
+#define SOLARSYSTEM_DDSIMAGE_H
+#include "VirtualFileSystem.h"
+#include <GL/glew.h>
+#include <vector>
+
+// DDS reader on top of a memory mapped file (a stored entry of the asset archive or a loose file). Mip levels point straight into the mapping, so nothing is copied to the heap
+// and the data goes from the page cache to the driver. Compressed archive entries are the exception, they are inflated to the heap first (see IsMapped).
+// Only flat (2D) DXT1/3/5, RGB(A), BGR(A) and luminance images are supported
+class DDSImage {
+public:
+    struct MipLevel {
+        GLsizei width, height, size;
+        const uint8_t* data;
+    };
+
+    explicit DDSImage(const std::string& path);
+    void Upload2D(GLenum target = GL_TEXTURE_2D, size_t firstLevel = 0) const; // Texture must be bound to the target before. Level firstLevel of the file goes to the level firstLevel of the texture
+    void UploadLevel(GLenum target, size_t level) const;
+    void ReleaseLevel(GLenum target, size_t level) const; // Respecifies the level as empty, so the driver can free its memory
+    void UploadLayerLevel(GLuint arrayTexture, GLint layer, size_t level) const; // Into a layer of the immutable storage of a GL_TEXTURE_2D_ARRAY
+    uint64_t CalculateContentHash() const;
+    GLsizei GetWidth() const;
+    GLsizei GetHeight() const;
+    GLenum GetFormat() const;
+    bool IsCompressed() const;
+    bool IsMapped() const; // Keeping the image costs only address space, not a heap copy of the file
+    const std::vector<MipLevel>& GetMipLevels() const;
+    size_t GetPayloadSize() const; // Sum of all mip level sizes in bytes
+
+private:
+    AssetFile _file;
+    GLenum _format = 0;
+    GLint _components = 0;
+    bool _isCompressed = false;
+    std::vector<MipLevel> _mipLevels;
+
+    void ParseHeader(const std::string& path);
+    GLsizei CalculateLevelSize(GLsizei width, GLsizei height) const;
+};
+
+#endif //SOLARSYSTEM_DDSIMAGE_H
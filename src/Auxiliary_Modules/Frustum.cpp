@@ -0,0 +1,63 @@
+#include "Frustum.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SOLARSYSTEM_FRUSTUM_SSE
+#endif
+
+Frustum::Frustum(const glm::mat4& projectionView) {
+    // Rows of the matrix, glm stores columns
+    const glm::vec4 row0(projectionView[0][0], projectionView[1][0], projectionView[2][0], projectionView[3][0]);
+    const glm::vec4 row1(projectionView[0][1], projectionView[1][1], projectionView[2][1], projectionView[3][1]);
+    const glm::vec4 row2(projectionView[0][2], projectionView[1][2], projectionView[2][2], projectionView[3][2]);
+    const glm::vec4 row3(projectionView[0][3], projectionView[1][3], projectionView[2][3], projectionView[3][3]);
+
+    const std::array<glm::vec4, 6> planes = {row3 + row0, row3 - row0, row3 + row1, row3 - row1, row3 + row2, row3 - row2}; // Left, right, bottom, top, near, far
+
+    for (size_t i = 0; i < planes.size(); i++) {
+        const float length = glm::length(glm::vec3(planes[i])); // Normalized, so that the distance to a plane can be compared with a radius
+        _normalX[i] = planes[i].x / length;
+        _normalY[i] = planes[i].y / length;
+        _normalZ[i] = planes[i].z / length;
+        _distance[i] = planes[i].w / length;
+    }
+}
+
+bool Frustum::IsVisible(const BoundingSphere& sphere) const {
+    for (size_t i = 0; i < _distance.size(); i++) {
+        if (_normalX[i] * sphere.center.x + _normalY[i] * sphere.center.y + _normalZ[i] * sphere.center.z + _distance[i] < -sphere.radius)
+            return false;
+    }
+
+    return true;
+}
+
+void Frustum::TestSpheres(const std::vector<BoundingSphere>& spheres, std::vector<uint8_t>& visibility) const {
+    visibility.resize(spheres.size());
+    size_t first = 0;
+
+#ifdef SOLARSYSTEM_FRUSTUM_SSE
+    for (; first + 4 <= spheres.size(); first += 4) {
+        const BoundingSphere* batch = &spheres[first];
+        const __m128 centerX = _mm_setr_ps(batch[0].center.x, batch[1].center.x, batch[2].center.x, batch[3].center.x);
+        const __m128 centerY = _mm_setr_ps(batch[0].center.y, batch[1].center.y, batch[2].center.y, batch[3].center.y);
+        const __m128 centerZ = _mm_setr_ps(batch[0].center.z, batch[1].center.z, batch[2].center.z, batch[3].center.z);
+        const __m128 negativeRadius = _mm_setr_ps(-batch[0].radius, -batch[1].radius, -batch[2].radius, -batch[3].radius);
+        __m128 outside = _mm_setzero_ps();
+
+        for (size_t i = 0; i < _distance.size(); i++) {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(centerX, _mm_set1_ps(_normalX[i])), _mm_mul_ps(centerY, _mm_set1_ps(_normalY[i])));
+            distance = _mm_add_ps(distance, _mm_mul_ps(centerZ, _mm_set1_ps(_normalZ[i])));
+            distance = _mm_add_ps(distance, _mm_set1_ps(_distance[i]));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negativeRadius));
+        }
+
+        const int outsideMask = _mm_movemask_ps(outside);
+        for (size_t lane = 0; lane < 4; lane++)
+            visibility[first + lane] = (outsideMask & (1 << lane)) == 0;
+    }
+#endif
+
+    for (; first < spheres.size(); first++)
+        visibility[first] = IsVisible(spheres[first]);
+}
@@ -0,0 +1,27 @@
+#ifndef SOLARSYSTEM_FRUSTUM_H
+#define SOLARSYSTEM_FRUSTUM_H
+#include <glm/glm.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct BoundingSphere {
+    glm::vec3 center;
+    float radius;
+};
+
+// Planes of the view frustum, extracted from a projection-view matrix (Gribb & Hartmann). Spheres are tested four at a time
+// with SSE, each against all six planes, the scalar loop handles the rest and builds without SSE
+class Frustum {
+public:
+    explicit Frustum(const glm::mat4& projectionView);
+    bool IsVisible(const BoundingSphere& sphere) const;
+    void TestSpheres(const std::vector<BoundingSphere>& spheres, std::vector<uint8_t>& visibility) const; // 1 for a visible sphere
+
+private:
+    // Structure of arrays, so that one SSE register holds a component of the same plane for four spheres
+    std::array<float, 6> _normalX, _normalY, _normalZ, _distance;
+};
+
+#endif //SOLARSYSTEM_FRUSTUM_H
@@ -0,0 +1,179 @@
+#include "GeometryArena.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+size_t GeometryArena::_drawCallsCount = 0, GeometryArena::_trianglesCount = 0;
+
+GeometryArena& GeometryArena::Instance() {
+    static GeometryArena arena;
+    return arena;
+}
+
+GeometryArena::Allocation GeometryArena::Allocate(const Vertex* vertices, size_t verticesCount, const uint32_t* indices, size_t indicesCount) {
+    if (_vao == 0)
+        CreateVertexArray();
+
+    // Enough for the sphere, both rings and the Mars moons without growing
+    constexpr size_t minimalVerticesCapacity = 256 * 1024, minimalIndicesCapacity = 1024 * 1024;
+
+    Allocation allocation;
+    allocation.baseVertex = static_cast<GLint>(AllocateRange(_vertices, _vertexBuffer, verticesCount, sizeof(Vertex), minimalVerticesCapacity));
+    allocation.firstIndex = static_cast<GLuint>(AllocateRange(_indices, _indexBuffer, indicesCount, sizeof(uint32_t), minimalIndicesCapacity));
+    allocation.verticesCount = verticesCount;
+    allocation.indicesCount = indicesCount;
+
+    // A grown buffer is a new object, so the VAO is pointed to the current ones each time
+    glVertexArrayVertexBuffer(_vao, 0, _vertexBuffer, 0, sizeof(Vertex));
+    glVertexArrayElementBuffer(_vao, _indexBuffer);
+
+    glNamedBufferSubData(_vertexBuffer, static_cast<GLintptr>(allocation.baseVertex * sizeof(Vertex)), static_cast<GLsizeiptr>(verticesCount * sizeof(Vertex)),
+                         vertices);
+    glNamedBufferSubData(_indexBuffer, static_cast<GLintptr>(allocation.firstIndex * sizeof(uint32_t)),
+                         static_cast<GLsizeiptr>(indicesCount * sizeof(uint32_t)), indices);
+    return allocation;
+}
+
+void GeometryArena::Free(const Allocation& allocation) {
+    if (allocation.verticesCount == 0 || _vao == 0) // Empty or made before Release
+        return;
+
+    _vertices.Free(static_cast<size_t>(allocation.baseVertex), allocation.verticesCount);
+    _indices.Free(allocation.firstIndex, allocation.indicesCount);
+}
+
+std::vector<Vertex> GeometryArena::ReadVertices(const Allocation& allocation) const {
+    std::vector<Vertex> vertices(allocation.verticesCount);
+    glGetNamedBufferSubData(_vertexBuffer, static_cast<GLintptr>(allocation.baseVertex * sizeof(Vertex)),
+                            static_cast<GLsizeiptr>(allocation.verticesCount * sizeof(Vertex)), vertices.data());
+    return vertices;
+}
+
+void GeometryArena::Bind() const {
+    glBindVertexArray(_vao);
+}
+
+void GeometryArena::Release() {
+    glDeleteVertexArrays(1, &_vao);
+    glDeleteBuffers(1, &_vertexBuffer);
+    glDeleteBuffers(1, &_indexBuffer);
+    _vao = _vertexBuffer = _indexBuffer = 0;
+    _vertices = RangeAllocator();
+    _indices = RangeAllocator();
+}
+
+void GeometryArena::PrintStatistics() const {
+    constexpr double bytesInMegabyte = 1024.0 * 1024.0;
+
+    std::cout << std::fixed << std::setprecision(2) << "Geometry arena: " << _vertices.GetUsed() << " of " << _vertices.GetCapacity() << " vertices, "
+              << _indices.GetUsed() << " of " << _indices.GetCapacity() << " indices, "
+              << (_vertices.GetCapacity() * sizeof(Vertex) + _indices.GetCapacity() * sizeof(uint32_t)) / bytesInMegabyte << " MB" << std::endl;
+}
+
+void GeometryArena::CountDrawCalls(size_t count, size_t trianglesCount) {
+    _drawCallsCount += count;
+    _trianglesCount += trianglesCount;
+}
+
+size_t GeometryArena::GetDrawCallsCount() {
+    return _drawCallsCount;
+}
+
+size_t GeometryArena::GetTrianglesCount() {
+    return _trianglesCount;
+}
+
+void GeometryArena::ResetDrawCallsCount() {
+    _drawCallsCount = _trianglesCount = 0;
+}
+
+void GeometryArena::CreateVertexArray() {
+    glCreateVertexArrays(1, &_vao);
+
+    const auto setAttribute = [this](GLuint index, GLint size, size_t offset) {
+        glEnableVertexArrayAttrib(_vao, index);
+        glVertexArrayAttribFormat(_vao, index, size, GL_FLOAT, GL_FALSE, static_cast<GLuint>(offset));
+        glVertexArrayAttribBinding(_vao, index, 0);
+    };
+
+    setAttribute(0, 3, offsetof(Vertex, position)); // Позиции вершин
+    setAttribute(1, 3, offsetof(Vertex, normal)); // Нормали вершин
+    setAttribute(2, 2, offsetof(Vertex, textureCoords)); // Координаты вершинных текстур
+    setAttribute(3, 3, offsetof(Vertex, tangent)); // Тангент к вершинам
+    setAttribute(4, 3, offsetof(Vertex, bitangent)); // Битангент к вершинам
+}
+
+void GeometryArena::GrowBuffer(GLuint& buffer, size_t oldBytes, size_t newBytes) {
+    GLuint grownBuffer = 0;
+    glCreateBuffers(1, &grownBuffer);
+    glNamedBufferStorage(grownBuffer, static_cast<GLsizeiptr>(newBytes), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+    if (buffer != 0) {
+        glCopyNamedBufferSubData(buffer, grownBuffer, 0, 0, static_cast<GLsizeiptr>(oldBytes));
+        glDeleteBuffers(1, &buffer);
+    }
+
+    buffer = grownBuffer;
+}
+
+size_t GeometryArena::AllocateRange(RangeAllocator& allocator, GLuint& buffer, size_t count, size_t elementSize, size_t minimalCapacity) {
+    size_t offset = allocator.Allocate(count);
+
+    if (offset == RangeAllocator::NO_SPACE) {
+        const size_t oldCapacity = allocator.GetCapacity();
+        const size_t newCapacity = std::max({oldCapacity * 2, oldCapacity + count, minimalCapacity});
+
+        GrowBuffer(buffer, oldCapacity * elementSize, newCapacity * elementSize);
+        allocator.Grow(newCapacity);
+        offset = allocator.Allocate(count);
+    }
+
+    return offset;
+}
+
+size_t GeometryArena::RangeAllocator::Allocate(size_t size) {
+    const auto range = std::find_if(_freeRanges.begin(), _freeRanges.end(), [size](const Range& range) { return range.size >= size; });
+    if (range == _freeRanges.end())
+        return NO_SPACE;
+
+    const size_t offset = range->offset;
+    range->offset += size;
+    range->size -= size;
+    if (range->size == 0)
+        _freeRanges.erase(range);
+
+    _used += size;
+    return offset;
+}
+
+void GeometryArena::RangeAllocator::Free(size_t offset, size_t size) {
+    auto next = std::lower_bound(_freeRanges.begin(), _freeRanges.end(), offset, [](const Range& range, size_t offset) { return range.offset < offset; });
+    next = _freeRanges.insert(next, Range{offset, size});
+    _used -= size;
+
+    // Merges with the following range, then with the preceding one
+    if (next + 1 != _freeRanges.end() && next->offset + next->size == (next + 1)->offset) {
+        next->size += (next + 1)->size;
+        _freeRanges.erase(next + 1);
+    }
+
+    if (next != _freeRanges.begin() && (next - 1)->offset + (next - 1)->size == next->offset) {
+        (next - 1)->size += next->size;
+        _freeRanges.erase(next);
+    }
+}
+
+void GeometryArena::RangeAllocator::Grow(size_t capacity) {
+    const size_t oldCapacity = _capacity;
+    _capacity = capacity;
+    _used += capacity - oldCapacity; // Released at once as a free range at the end
+    Free(oldCapacity, capacity - oldCapacity);
+}
+
+size_t GeometryArena::RangeAllocator::GetCapacity() const {
+    return _capacity;
+}
+
+size_t GeometryArena::RangeAllocator::GetUsed() const {
+    return _used;
+}
@@ -0,0 +1,71 @@
+#ifndef SOLARSYSTEM_GEOMETRYARENA_H
+#define SOLARSYSTEM_GEOMETRYARENA_H
+#include "MeshData.h"
+#include <GL/glew.h>
+#include <cstddef>
+#include <vector>
+
+// Layout of the commands read by glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+// One vertex and one index buffer with a shared VAO for all static meshes. A mesh gets a range of each buffer, so draws of
+// different meshes need no VAO switches and can be merged into one glMultiDrawElementsIndirect. The buffers grow by copying
+// on the GPU when they are full, freed ranges are reused. Used from the GL thread only
+class GeometryArena {
+public:
+    struct Allocation {
+        GLint baseVertex = 0;
+        GLuint firstIndex = 0;
+        size_t verticesCount = 0, indicesCount = 0;
+    };
+
+    static GeometryArena& Instance();
+    Allocation Allocate(const Vertex* vertices, size_t verticesCount, const uint32_t* indices, size_t indicesCount);
+    void Free(const Allocation& allocation);
+    std::vector<Vertex> ReadVertices(const Allocation& allocation) const; // Reads back from the GPU, for tools which need the CPU copy once
+    void Bind() const; // Binds the shared VAO
+    void Release(); // Deletes the buffers, must be called while the GL context is alive
+    void PrintStatistics() const;
+    static void CountDrawCalls(size_t count, size_t trianglesCount); // Draw calls of arena geometry since the last reset, for the hints
+    static size_t GetDrawCallsCount();
+    static size_t GetTrianglesCount();
+    static void ResetDrawCallsCount();
+
+private:
+    // First-fit allocator of element ranges, adjacent free ranges are merged
+    class RangeAllocator {
+    public:
+        static constexpr size_t NO_SPACE = static_cast<size_t>(-1);
+
+        size_t Allocate(size_t size); // Returns the first element or NO_SPACE
+        void Free(size_t offset, size_t size);
+        void Grow(size_t capacity);
+        size_t GetCapacity() const;
+        size_t GetUsed() const;
+
+    private:
+        struct Range {
+            size_t offset, size;
+        };
+
+        std::vector<Range> _freeRanges; // Sorted by offset
+        size_t _capacity = 0, _used = 0;
+    };
+
+    GLuint _vao = 0, _vertexBuffer = 0, _indexBuffer = 0;
+    RangeAllocator _vertices, _indices;
+    static size_t _drawCallsCount, _trianglesCount;
+
+    GeometryArena() = default;
+    void CreateVertexArray();
+    static void GrowBuffer(GLuint& buffer, size_t oldBytes, size_t newBytes); // Contents are kept
+    static size_t AllocateRange(RangeAllocator& allocator, GLuint& buffer, size_t count, size_t elementSize, size_t minimalCapacity);
+};
+
+#endif //SOLARSYSTEM_GEOMETRYARENA_H
@@ -0,0 +1,150 @@
+#include "InstanceBatcher.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <tuple>
+
+InstanceBatcher::~InstanceBatcher() {
+    glDeleteBuffers(1, &_instanceBuffer);
+    glDeleteBuffers(1, &_indirectBuffer);
+}
+
+void InstanceBatcher::Add(const MeshHolder& mesh, const TextureImage2D& diffuse, const TextureImage2D& normal, const TextureImage2D& specular,
+                          const glm::mat4& model, uint32_t materialIndex, int32_t eclipseCaster, uint32_t lightIndex, GLuint ringTexture)
+{
+    const LayerReference diffuseLayer = FindOrAddLayer(diffuse);
+    const LayerReference normalLayer = FindOrAddLayer(normal);
+    const LayerReference specularLayer = FindOrAddLayer(specular);
+
+    _pendingInstances.push_back(PendingInstance{mesh.GetMeshModel(), &mesh, diffuseLayer.array, normalLayer.array, specularLayer.array, ringTexture,
+                                                InstanceRecord{model, materialIndex, static_cast<uint32_t>(diffuseLayer.layer),
+                                                               static_cast<uint32_t>(normalLayer.layer), static_cast<uint32_t>(specularLayer.layer),
+                                                               eclipseCaster, lightIndex}});
+}
+
+void InstanceBatcher::AddShadowCaster(const MeshHolder& mesh, const glm::mat4& lightSpaceModel, uint32_t layer) {
+    Add(mesh, TextureImage2D(), TextureImage2D(), TextureImage2D(), lightSpaceModel, layer, -1);
+}
+
+void InstanceBatcher::Flush(bool isTextured) {
+    if (_pendingInstances.empty())
+        return;
+
+    const auto batchKey = [](const PendingInstance& instance) {
+        return std::tie(instance.diffuseArray, instance.normalArray, instance.specularArray, instance.ringTexture, instance.meshKey);
+    };
+    const auto isSameTextures = [](const PendingInstance& lhs, const PendingInstance& rhs) {
+        return lhs.diffuseArray == rhs.diffuseArray && lhs.normalArray == rhs.normalArray && lhs.specularArray == rhs.specularArray &&
+               lhs.ringTexture == rhs.ringTexture;
+    };
+
+    std::stable_sort(_pendingInstances.begin(), _pendingInstances.end(), [&batchKey](const PendingInstance& lhs, const PendingInstance& rhs) {
+        return batchKey(lhs) < batchKey(rhs);
+    });
+
+    _records.clear();
+    for (const auto& instance : _pendingInstances)
+        _records.push_back(instance.record);
+
+    // The shaders index the records with gl_BaseInstance + gl_InstanceID
+    _commands.clear();
+    _submissions.clear();
+    for (size_t first = 0; first < _pendingInstances.size();) {
+        size_t last = first + 1;
+        while (last < _pendingInstances.size() && batchKey(_pendingInstances[last]) == batchKey(_pendingInstances[first]))
+            last++;
+
+        const auto& batch = _pendingInstances[first];
+        if (_submissions.empty() || (isTextured && !isSameTextures(*_submissions.back().textures, batch)))
+            _submissions.push_back(Submission{_commands.size(), 0, &batch});
+
+        batch.mesh->AppendIndirectCommands(_commands, static_cast<GLuint>(last - first), static_cast<GLuint>(first));
+        _submissions.back().commandsCount = _commands.size() - _submissions.back().firstCommand;
+        first = last;
+    }
+
+    UploadStreamBuffer(_instanceBuffer, _instanceBufferBytes, _records.data(), _records.size() * sizeof(InstanceRecord));
+    UploadStreamBuffer(_indirectBuffer, _indirectBufferBytes, _commands.data(), _commands.size() * sizeof(DrawElementsIndirectCommand));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDING, _instanceBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _indirectBuffer);
+    GeometryArena::Instance().Bind();
+
+    for (const auto& submission : _submissions) {
+        if (isTextured) {
+            const auto& textures = *submission.textures;
+            glBindTextureUnit(DiffuseSlot, textures.diffuseArray ? textures.diffuseArray->GetTexture() : 0);
+            glBindTextureUnit(NormalSlot, textures.normalArray ? textures.normalArray->GetTexture() : 0);
+            glBindTextureUnit(SpecularSlot, textures.specularArray ? textures.specularArray->GetTexture() : 0);
+            if (textures.ringTexture != 0)
+                glBindTextureUnit(RING_TEXTURE_UNIT, textures.ringTexture);
+        }
+
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(submission.firstCommand * sizeof(DrawElementsIndirectCommand)),
+                                    static_cast<GLsizei>(submission.commandsCount), 0);
+    }
+
+    size_t trianglesCount = 0;
+    for (const auto& command : _commands)
+        trianglesCount += command.count / 3 * command.instanceCount;
+
+    GeometryArena::CountDrawCalls(_submissions.size(), trianglesCount);
+    glBindVertexArray(0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    _pendingInstances.clear();
+}
+
+void InstanceBatcher::UpdateTextures() {
+    for (auto& [format, array] : _arrays)
+        array->Update();
+}
+
+void InstanceBatcher::ReleaseUnusedTextures() {
+    for (auto& [format, array] : _arrays) {
+        for (const GLuint texture : array->ReleaseUnusedLayers())
+            _layers.erase(texture);
+    }
+}
+
+size_t InstanceBatcher::GetTexturesSizeInBytes() const {
+    size_t sizeInBytes = 0;
+    for (const auto& [format, array] : _arrays)
+        sizeInBytes += array->GetSizeInBytes();
+
+    return sizeInBytes;
+}
+
+void InstanceBatcher::PrintStatistics() const {
+    size_t layersCount = 0;
+    for (const auto& [format, array] : _arrays)
+        layersCount += array->GetLayersCount();
+
+    const size_t sizeInBytes = GetTexturesSizeInBytes();
+    std::cout << "Instance batcher: " << _arrays.size() << " texture arrays with " << layersCount << " layers, " << std::fixed << std::setprecision(1)
+              << static_cast<double>(sizeInBytes) / (1024.0 * 1024.0) << " MB" << std::endl;
+}
+
+InstanceBatcher::LayerReference InstanceBatcher::FindOrAddLayer(const TextureImage2D& texture) {
+    if (texture.GetTexture() == 0)
+        return LayerReference();
+
+    if (const auto it = _layers.find(texture.GetTexture()); it != _layers.end())
+        return it->second;
+
+    const TextureArray::Format format = TextureArray::GetFormat(texture);
+    auto& array = _arrays[format];
+    if (!array)
+        array = std::make_unique<TextureArray>(format);
+
+    const LayerReference reference{array.get(), array->AddLayer(texture)};
+    _layers.emplace(texture.GetTexture(), reference);
+    return reference;
+}
+
+void InstanceBatcher::UploadStreamBuffer(GLuint& buffer, size_t& capacityBytes, const void* data, size_t bytes) {
+    if (buffer == 0)
+        glCreateBuffers(1, &buffer);
+
+    capacityBytes = std::max(capacityBytes, bytes);
+    glNamedBufferData(buffer, static_cast<GLsizeiptr>(capacityBytes), nullptr, GL_STREAM_DRAW);
+    glNamedBufferSubData(buffer, 0, static_cast<GLsizeiptr>(bytes), data);
+}
@@ -0,0 +1,84 @@
+#ifndef SOLARSYSTEM_INSTANCEBATCHER_H
+#define SOLARSYSTEM_INSTANCEBATCHER_H
+#include "MeshHolder.h"
+#include "TextureArray.h"
+#include "MaterialTable.h"
+#include <glm/glm.hpp>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Record of the InstanceBuffer block in planetLighting.vs and shadowMap.vs (INSTANCED variants), std430
+struct InstanceRecord {
+    glm::mat4 model;
+    uint32_t materialIndex;
+    uint32_t diffuseLayer, normalLayer, specularLayer;
+    int32_t eclipseCaster; // Index of the body in the eclipse casters of its light block, -1 if it is not one
+    uint32_t lightIndex; // Of the component of the body in the LightBuffer block
+    int32_t padding[2];
+};
+
+static_assert(sizeof(InstanceRecord) == 96, "The struct must follow the std430 layout of the InstanceBuffer block");
+
+// Collects bodies during a pass and draws them with glMultiDrawElementsIndirect: one indirect command per mesh with all bodies which
+// use it as instances, and one submission per set of texture arrays and ring (a single one for untextured passes, e.g. shadow maps).
+// Bodies of several components can be flushed together, each instance picks the light of its component.
+// Surface textures are moved into texture arrays by their format the first time a body with them is added. Used from the GL thread only
+class InstanceBatcher {
+public:
+    static constexpr GLuint BINDING = 1; // Shader storage buffer binding of the InstanceBuffer block
+    static constexpr GLuint RING_TEXTURE_UNIT = 12; // Of ringDiffuse in the planet programs
+
+    InstanceBatcher() = default;
+    ~InstanceBatcher();
+    InstanceBatcher(const InstanceBatcher&) = delete;
+    InstanceBatcher& operator=(const InstanceBatcher&) = delete;
+    // The mesh must stay alive until Flush. Textures may be empty, e.g. without a specular map. The ring texture is of the ring in the light, if it has one
+    void Add(const MeshHolder& mesh, const TextureImage2D& diffuse, const TextureImage2D& normal, const TextureImage2D& specular, const glm::mat4& model,
+             uint32_t materialIndex, int32_t eclipseCaster, uint32_t lightIndex = 0, GLuint ringTexture = 0);
+    // For the layered shadow pass: the matrix goes from model space to the light clip space, the layer of the shadow map array takes the place of the material
+    void AddShadowCaster(const MeshHolder& mesh, const glm::mat4& lightSpaceModel, uint32_t layer);
+    // Draws the added bodies with the program in use. Textured, the arrays are bound to the units of the material slots
+    void Flush(bool isTextured = true);
+    void UpdateTextures(); // Uploads one more level of the surface textures per array
+    void ReleaseUnusedTextures(); // Frees the layers of textures which are not used by any body anymore (unloaded planetary systems)
+    size_t GetTexturesSizeInBytes() const; // VRAM taken by the texture arrays
+    void PrintStatistics() const;
+
+private:
+    struct LayerReference {
+        TextureArray* array = nullptr;
+        GLint layer = 0;
+    };
+
+    struct PendingInstance {
+        const MeshModel* meshKey;
+        const MeshHolder* mesh;
+        TextureArray* diffuseArray;
+        TextureArray* normalArray;
+        TextureArray* specularArray;
+        GLuint ringTexture;
+        InstanceRecord record;
+    };
+
+    std::map<TextureArray::Format, std::unique_ptr<TextureArray>> _arrays;
+    std::unordered_map<GLuint, LayerReference> _layers; // By the id of the source texture
+    std::vector<PendingInstance> _pendingInstances;
+    struct Submission {
+        size_t firstCommand, commandsCount;
+        const PendingInstance* textures; // The first instance of the submission, its arrays and ring are bound
+    };
+
+    std::vector<InstanceRecord> _records;
+    std::vector<DrawElementsIndirectCommand> _commands;
+    std::vector<Submission> _submissions;
+    GLuint _instanceBuffer = 0, _indirectBuffer = 0;
+    size_t _instanceBufferBytes = 0, _indirectBufferBytes = 0;
+
+    LayerReference FindOrAddLayer(const TextureImage2D& texture);
+    // Reallocating the storage each flush lets the driver hand out a new one while the previous pass still reads the old
+    static void UploadStreamBuffer(GLuint& buffer, size_t& capacityBytes, const void* data, size_t bytes);
+};
+
+#endif //SOLARSYSTEM_INSTANCEBATCHER_H
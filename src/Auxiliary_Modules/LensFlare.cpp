@@ -80,8 +80,8 @@ LensFlare::LensFlare(const Shader& shader, const TextureImage2D& lensTexture, co
     glBindVertexArray(0);
 }
 
-void LensFlare::Render(const glm::mat4& projection, const glm::mat4& view, const glm::vec3& center, const glm::vec3& color, float aspectRatio, float size,
-                       float intensity, const std::optional<RingCameraInfo>& ringCameraInfo) const
+void LensFlare::Render(const glm::vec3& center, const glm::vec3& color, float aspectRatio, float size, float intensity,
+                       const std::optional<RingCameraInfo>& ringCameraInfo) const
 {
     if (size <= 0.0f || intensity <= 0.0f)
         return;
@@ -89,8 +89,6 @@ void LensFlare::Render(const glm::mat4& projection, const glm::mat4& view, const
     glm::vec2 dims(size, size * aspectRatio);
 
     _lensFlareShader.Use();
-    _lensFlareShader.SetMat4("projection", projection);
-    _lensFlareShader.SetMat4("view", view);
     _lensFlareShader.SetVec3("center", center);
     _lensFlareShader.SetVec3("color", color);
     _lensFlareShader.SetVec2("dims", dims);
@@ -101,7 +99,6 @@ void LensFlare::Render(const glm::mat4& projection, const glm::mat4& view, const
 
     _lensFlareShader.SetBool("isPlanetaryRingInView", ringCameraInfo.has_value());
     if (ringCameraInfo) {
-        _lensFlareShader.SetVec3("cameraPosition", ringCameraInfo->cameraPosition);
         _lensFlareShader.SetVec3("ringCenter", ringCameraInfo->ringCenter);
         _lensFlareShader.SetVec3("ringNormal", ringCameraInfo->ringNormal);
         _lensFlareShader.SetVec2("ringInnerOuterRadiuses", ringCameraInfo->ringInnerOuterRadiuses);
@@ -29,7 +29,7 @@ static constexpr int INDICES_PER_QUAD = 6;
 class LensFlare {
 public:
     explicit LensFlare(const Shader& shader, const TextureImage2D& lensTexture, const FlaresInfo& properties);
-    void Render(const glm::mat4& projection, const glm::mat4& view, const glm::vec3& center, const glm::vec3& color, float aspectRatio, float size, float intensity,
+    void Render(const glm::vec3& center, const glm::vec3& color, float aspectRatio, float size, float intensity,
                 const std::optional<RingCameraInfo>& ringCameraInfo) const;
 
 private:
@@ -0,0 +1,136 @@
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) {
+#ifdef _WIN32
+    _fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (_fileHandle == INVALID_HANDLE_VALUE) {
+        _fileHandle = nullptr;
+        throw std::runtime_error("Cannot open file " + path);
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(_fileHandle, &fileSize)) {
+        Close();
+        throw std::runtime_error("Cannot get size of file " + path);
+    }
+    _size = static_cast<size_t>(fileSize.QuadPart);
+
+    if (_size == 0)
+        return; // Empty files cannot be mapped
+
+    _mappingHandle = CreateFileMappingA(_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_mappingHandle == nullptr) {
+        Close();
+        throw std::runtime_error("Cannot map file " + path);
+    }
+
+    _data = static_cast<const uint8_t*>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+    const int fileDescriptor = open(path.c_str(), O_RDONLY);
+    if (fileDescriptor == -1)
+        throw std::runtime_error("Cannot open file " + path);
+
+    struct stat fileStat {};
+    if (fstat(fileDescriptor, &fileStat) == -1) {
+        close(fileDescriptor);
+        throw std::runtime_error("Cannot get size of file " + path);
+    }
+    _size = static_cast<size_t>(fileStat.st_size);
+
+    if (_size == 0) {
+        close(fileDescriptor);
+        return; // Empty files cannot be mapped
+    }
+
+    void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    close(fileDescriptor); // The mapping keeps its own reference to the file
+    _data = data == MAP_FAILED ? nullptr : static_cast<const uint8_t*>(data);
+#endif
+
+    if (_data == nullptr) {
+        Close();
+        throw std::runtime_error("Cannot map file " + path);
+    }
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+const uint8_t* MappedFile::GetData() const {
+    return _data;
+}
+
+size_t MappedFile::GetSize() const {
+    return _size;
+}
+
+uint64_t MappedFile::CalculateHash() const {
+    return CalculateHash(_data, _size);
+}
+
+void MappedFile::Prefetch(size_t offset, size_t size) const {
+    if (offset >= _size)
+        return;
+    size = std::min<size_t>(size, _size - offset); // Explicit type, min is a macro in windows.h
+
+#ifdef _WIN32
+#if _WIN32_WINNT >= 0x0602 // PrefetchVirtualMemory appeared in Windows 8
+    WIN32_MEMORY_RANGE_ENTRY range {const_cast<uint8_t*>(_data + offset), size};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#endif
+#else
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t alignedOffset = offset / pageSize * pageSize; // madvise wants a page aligned address
+    madvise(const_cast<uint8_t*>(_data + alignedOffset), size + offset - alignedOffset, MADV_WILLNEED);
+#endif
+}
+
+uint64_t MappedFile::CalculateHash(const uint8_t* data, size_t size) {
+    constexpr uint64_t fnvOffsetBasis = 14695981039346656037ull, fnvPrime = 1099511628211ull;
+    uint64_t hash = fnvOffsetBasis;
+    size_t offset = 0;
+
+    // 8 bytes per step, byte by byte it is several times slower on big textures
+    for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + offset, sizeof(uint64_t));
+        hash = (hash ^ word) * fnvPrime;
+    }
+
+    for (; offset < size; offset++)
+        hash = (hash ^ data[offset]) * fnvPrime;
+
+    return hash;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (_data != nullptr)
+        UnmapViewOfFile(_data);
+    if (_mappingHandle != nullptr)
+        CloseHandle(_mappingHandle);
+    if (_fileHandle != nullptr)
+        CloseHandle(_fileHandle);
+
+    _mappingHandle = _fileHandle = nullptr;
+#else
+    if (_data != nullptr)
+        munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+
+    _data = nullptr;
+    _size = 0;
+}
@@ -0,0 +1,33 @@
+#ifndef SOLARSYSTEM_MAPPEDFILE_H
+#define SOLARSYSTEM_MAPPEDFILE_H
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file. The data is paged in by the OS on access and is not copied to the heap
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* GetData() const;
+    size_t GetSize() const;
+    // FNV-1a over the whole file. Touches every page, so the disk read happens here (e.g. on a worker thread) and not on the first access
+    uint64_t CalculateHash() const;
+    void Prefetch(size_t offset, size_t size) const; // Asks the OS to read the range ahead with large sequential reads
+    static uint64_t CalculateHash(const uint8_t* data, size_t size);
+
+private:
+    const uint8_t* _data = nullptr;
+    size_t _size = 0;
+#ifdef _WIN32
+    void* _fileHandle = nullptr;
+    void* _mappingHandle = nullptr;
+#endif
+
+    void Close();
+};
+
+#endif //SOLARSYSTEM_MAPPEDFILE_H
@@ -0,0 +1,43 @@
+#include "MaterialTable.h"
+#include <iostream>
+
+MaterialTable& MaterialTable::Instance() {
+    static MaterialTable table;
+    return table;
+}
+
+uint32_t MaterialTable::Register(uint32_t flags, float ambientFactor) {
+    _registrationsCount++;
+
+    for (uint32_t index = 0; index < _materials.size(); index++) {
+        if (_materials[index].flags == flags && _materials[index].ambientFactor == ambientFactor)
+            return index;
+    }
+
+    _materials.push_back(MaterialRecord{flags, ambientFactor});
+    _isDirty = true;
+    return static_cast<uint32_t>(_materials.size() - 1);
+}
+
+void MaterialTable::Bind() {
+    if (_isDirty) {
+        // Materials are only added when a planetary system is created, so the whole table is simply uploaded again
+        if (_buffer == 0)
+            glCreateBuffers(1, &_buffer);
+
+        glNamedBufferData(_buffer, _materials.size() * sizeof(MaterialRecord), _materials.data(), GL_STATIC_DRAW);
+        _isDirty = false;
+    }
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDING, _buffer);
+}
+
+void MaterialTable::Release() {
+    glDeleteBuffers(1, &_buffer);
+    _buffer = 0;
+    _isDirty = !_materials.empty();
+}
+
+void MaterialTable::PrintStatistics() const {
+    std::cout << "Material table: " << _materials.size() << " materials for " << _registrationsCount << " bodies" << std::endl;
+}
@@ -0,0 +1,54 @@
+#ifndef SOLARSYSTEM_MATERIALTABLE_H
+#define SOLARSYSTEM_MATERIALTABLE_H
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Must match the MATERIAL_* constants in resource/shaders/uniformBlocks.glsl
+enum MaterialFlags : uint32_t {
+    NoMaterialFlags = 0,
+    HasNightTexture = 1u << 0,
+    HasSpecularMap = 1u << 1,
+    HasSpecular = 1u << 2,
+    HasClouds = 1u << 3,
+    UseSphereIntersect = 1u << 4 // To avoid the ring shadow while behind a planet (parent planet with rings)
+};
+
+// Texture units of the material textures, the samplers of the body shaders are set to them once
+enum MaterialTextureSlot : uint8_t {
+    DiffuseSlot = 0,
+    CloudSlot,
+    NightSlot,
+    NormalSlot,
+    SpecularSlot,
+    MATERIAL_TEXTURE_SLOTS_COUNT
+};
+
+// Flags and factors of the body materials in one shader storage buffer. A body passes the index of its material as the base instance of its draw,
+// so drawing it needs no uniforms. Identical materials share a record. Used from the GL thread only
+class MaterialTable {
+public:
+    static constexpr GLuint BINDING = 0; // Shader storage buffer binding of the MaterialBuffer block
+
+    static MaterialTable& Instance();
+    uint32_t Register(uint32_t flags, float ambientFactor); // Returns the index of the material
+    void Bind(); // Uploads the table if materials were added since the last call
+    void Release(); // Deletes the buffer, must be called while the GL context is alive
+    void PrintStatistics() const;
+
+private:
+    struct MaterialRecord { // std430
+        uint32_t flags;
+        float ambientFactor;
+    };
+
+    std::vector<MaterialRecord> _materials;
+    size_t _registrationsCount = 0;
+    GLuint _buffer = 0;
+    bool _isDirty = false;
+
+    MaterialTable() = default;
+};
+
+#endif //SOLARSYSTEM_MATERIALTABLE_H
@@ -1,13 +1,14 @@
 #include "Mesh.h"
 
-Mesh::Mesh(std::vector<Vertex> vertices, std::vector<size_t> indices, std::vector<Texture> textures)
-    : _vao(0), _vbo(0), _ebo(0), _vertices(std::move(vertices)), _indices(std::move(indices)), _textures(std::move(textures))
+Mesh::Mesh(const Vertex* vertices, size_t verticesCount, const uint32_t* indices, size_t indicesCount, std::vector<Texture> textures)
+    : _verticesCount(verticesCount), _indicesCount(indicesCount), _textures(std::move(textures)),
+      _geometry(GeometryArena::Instance().Allocate(vertices, verticesCount, indices, indicesCount))
 {
-    SetupMesh();
+    static_assert(sizeof(GLuint) == sizeof(uint32_t), "Indices are drawn as GL_UNSIGNED_INT");
 }
 
 // Отрисовка (рендеринг) меша
-void Mesh::Draw(const Shader& shader) const {
+void Mesh::Draw(const Shader& shader, GLuint baseInstance, GLsizei instanceCount) const {
     // Not used
     size_t diffuseNumber = 1;
     size_t specularNumber = 1;
@@ -29,50 +30,47 @@ void Mesh::Draw(const Shader& shader) const {
             number = std::to_string(heightNumber++);
 
         // Устанавливаем сэмплер на правильный текстурный блок
-        glUniform1i(glGetUniformLocation(shader.GetProgramId(), (name + number).c_str()), i);
+        shader.SetInt(name + number, static_cast<int>(i));
         glBindTexture(GL_TEXTURE_2D, _textures[i].id); // Связываем текстуру
     }
 
     // Непосредственная отрисовка меша
-    glBindVertexArray(_vao); // Связывание с вершинным массивом
-    glDrawElements(GL_TRIANGLES, _indices.size(), GL_UNSIGNED_INT, nullptr); // Отрисовка меша при помощи треугольников
+    GeometryArena::Instance().Bind(); // Связывание с вершинным массивом
+    glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, static_cast<GLsizei>(_indicesCount), GL_UNSIGNED_INT,
+                                                  reinterpret_cast<const void*>(_geometry.firstIndex * sizeof(uint32_t)), instanceCount,
+                                                  _geometry.baseVertex, baseInstance); // Отрисовка меша при помощи треугольников
+    GeometryArena::CountDrawCalls(1, _indicesCount / 3 * static_cast<size_t>(instanceCount));
     glBindVertexArray(0); // Отвязывание вершинного массива
 
     // Возврат к значению по умолчанию
     glActiveTexture(GL_TEXTURE0);
 }
 
-void Mesh::SetupMesh() {
-    // Генерация буферов / массивов
-    glGenVertexArrays(1, &_vao);
-    glGenBuffers(1, &_vbo);
-    glGenBuffers(1, &_ebo);
+DrawElementsIndirectCommand Mesh::GetIndirectCommand(GLuint instanceCount, GLuint baseInstance) const {
+    return DrawElementsIndirectCommand{static_cast<GLuint>(_indicesCount), instanceCount, _geometry.firstIndex, _geometry.baseVertex, baseInstance};
+}
 
-    glBindVertexArray(_vao); // Связывание с вершинным массивом
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo); // Связывание с вершинным буфером
+std::vector<Vertex> Mesh::ReadVertices() const {
+    return GeometryArena::Instance().ReadVertices(_geometry);
+}
 
-    // Копируем в вершинный буфер вершины и указываем о статической обработке данных видеокартой
-    glBufferData(GL_ARRAY_BUFFER, _vertices.size() * sizeof(Vertex), _vertices.data(), GL_STATIC_DRAW);
+void Mesh::Release() {
+    GeometryArena::Instance().Free(_geometry);
+    _geometry = GeometryArena::Allocation();
+}
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo); // Связывание с элементным буфером (копируем индексы)
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, _indices.size() * sizeof(size_t), _indices.data(), GL_STATIC_DRAW);
+size_t Mesh::GetVerticesCount() const {
+    return _verticesCount;
+}
 
-    // Установка указателей вершинных атрибутов (указание параметров доступа вершинных атрибутов к VBO)
-    // Позиции вершин
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)nullptr);
-    // Нормали вершин
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-    // Координаты вершинных текстур
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, textureCoords));
-    // Тангент к вершинам
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
-    // Битангент к вершинам
-    glEnableVertexAttribArray(4);
-    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, bitangent));
+size_t Mesh::GetIndicesCount() const {
+    return _indicesCount;
+}
+
+size_t Mesh::GetCpuBytes() const {
+    return sizeof(Mesh) + _textures.capacity() * sizeof(Texture);
+}
 
-    glBindVertexArray(0);
+size_t Mesh::GetGpuBytes() const {
+    return _verticesCount * sizeof(Vertex) + _indicesCount * sizeof(GLuint);
 }
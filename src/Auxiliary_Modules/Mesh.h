@@ -1,42 +1,33 @@
 #ifndef SOLARSYSTEM_MESH_H
 #define SOLARSYSTEM_MESH_H
 #include "Shader.h"
+#include "MeshData.h"
+#include "GeometryArena.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include <assimp/types.h>
 #include <string>
 #include <utility>
 #include <vector>
 
-struct Vertex {
-    glm::vec3 position;
-    glm::vec3 normal;
-    glm::vec2 textureCoords;
-    glm::vec3 tangent;
-    glm::vec3 bitangent;
-};
-
-struct Texture {
-    size_t id;
-    std::string type;
-    aiString path;
-};
-
 class Mesh {
 public:
-    explicit Mesh(std::vector<Vertex> vertices, std::vector<size_t> indices, std::vector<Texture> textures);
-    void Draw(const Shader& shader) const; // Отрисовка (рендеринг) меша
+    // Vertices and indices are only uploaded to the GPU (a range of GeometryArena), the mesh does not keep them in CPU memory
+    // Vertices and indices can point straight into a memory mapped file
+    explicit Mesh(const Vertex* vertices, size_t verticesCount, const uint32_t* indices, size_t indicesCount, std::vector<Texture> textures = {});
+    void Draw(const Shader& shader, GLuint baseInstance = 0, GLsizei instanceCount = 1) const; // Отрисовка (рендеринг) меша
+    DrawElementsIndirectCommand GetIndirectCommand(GLuint instanceCount, GLuint baseInstance) const; // For draws merged by glMultiDrawElementsIndirect
+    std::vector<Vertex> ReadVertices() const; // Reads back from the arena
+    void Release(); // Frees the range of the arena, copies of the mesh become invalid
+    size_t GetVerticesCount() const;
+    size_t GetIndicesCount() const;
+    size_t GetCpuBytes() const;
+    size_t GetGpuBytes() const;
 
 private:
-    std::vector<Vertex> _vertices; // Вершины
-    std::vector<size_t> _indices; // Индексы
+    size_t _verticesCount = 0; // Количество вершин
+    size_t _indicesCount = 0; // Количество индексов
     std::vector<Texture> _textures; // Текстуры
-    GLuint _vbo; // Объект вершинного буфера (VBO)
-    GLuint _vao; // Объект вершинного массива (VAO)
-    GLuint _ebo; // Объект элементного буфера (EBO)
-
-    // Инициализация всех буферных объектов / массивов
-    void SetupMesh();
+    GeometryArena::Allocation _geometry;
 };
 
 #endif //SOLARSYSTEM_MESH_H
@@ -0,0 +1,30 @@
+#ifndef SOLARSYSTEM_MESHDATA_H
+#define SOLARSYSTEM_MESHDATA_H
+#include <glm/glm.hpp>
+#include <assimp/types.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Vertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 textureCoords;
+    glm::vec3 tangent;
+    glm::vec3 bitangent;
+};
+
+struct Texture {
+    size_t id;
+    std::string type;
+    aiString path;
+};
+
+// CPU side of a mesh before the upload
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<Texture> textures;
+};
+
+#endif //SOLARSYSTEM_MESHDATA_H
@@ -1,34 +1,28 @@
 #ifndef SOLARSYSTEM_MESHKEEPER_H
 #define SOLARSYSTEM_MESHKEEPER_H
 #include "Shader.h"
-#include "Mesh.h"
+#include "MeshRegistry.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <vector>
 
-size_t TextureFromFile(const std::string& path); // Not used at all
-
+// Lightweight handle to a model from MeshRegistry, copies share the same GPU buffers
 class MeshHolder {
 public:
     explicit MeshHolder(const std::string& path);
-    void Draw(const Shader& shader) const; // Отрисовка модели (мешей)
+    MeshHolder(const std::string& name, const std::function<MeshData()>& generate); // See MeshRegistry::AcquireGenerated
+    void Draw(const Shader& shader, GLuint baseInstance = 0, GLsizei instanceCount = 1) const; // Отрисовка модели (мешей), baseInstance is read by shaders as gl_BaseInstance
+    void AppendIndirectCommands(std::vector<DrawElementsIndirectCommand>& commands, GLuint instanceCount, GLuint baseInstance) const; // One per mesh
+    const std::string& GetPath() const;
+    const MeshModel* GetMeshModel() const; // Identity of the shared GPU buffers, e.g. as a sort key
+    std::vector<Vertex> ReadVertices() const; // Of all meshes, read back from the GPU
 
 private:
-    std::vector<Texture> _loadedTextures;
-    std::vector<Mesh> _meshes;
-    std::string _directory;
-
-    // Обрабатывает узел рекурсивно. Обрабатывает каждую отдельную сетку, расположенную в узле, и повторяет этот процесс на своих дочерних узлах (если есть).
-    void ProcessNode(aiNode* node, const aiScene* scene);
-    Mesh ProcessMesh(aiMesh* mesh, const aiScene* scene);
-    std::vector<Texture> LoadMaterialTextures(aiMaterial* mat, const aiTextureType& type, const std::string& typeName);
+    std::shared_ptr<const MeshModel> _model;
 };
 
 #endif //SOLARSYSTEM_MESHKEEPER_H
@@ -0,0 +1,122 @@
+#include "MeshRegistry.h"
+#include "StartupProfiler.h"
+#include <chrono>
+#include <iomanip>
+
+MeshModel::~MeshModel() {
+    for (auto& mesh : meshes)
+        mesh.Release();
+}
+
+size_t MeshModel::GetCpuBytes() const {
+    size_t cpuBytes = sizeof(MeshModel) + path.capacity();
+    for (const auto& mesh : meshes)
+        cpuBytes += mesh.GetCpuBytes();
+
+    return cpuBytes;
+}
+
+size_t MeshModel::GetGpuBytes() const {
+    size_t gpuBytes = 0;
+    for (const auto& mesh : meshes)
+        gpuBytes += mesh.GetGpuBytes();
+
+    return gpuBytes;
+}
+
+MeshRegistry& MeshRegistry::Instance() {
+    static MeshRegistry registry;
+    return registry;
+}
+
+std::shared_ptr<const MeshModel> MeshRegistry::Acquire(const std::string& path) {
+    if (auto model = _models[path].lock()) {
+        _hits++;
+        return model;
+    }
+
+    std::shared_ptr<const MeshModel> model = LoadModel(path);
+    _models[path] = model;
+    _loads++;
+    return model;
+}
+
+std::shared_ptr<const MeshModel> MeshRegistry::AcquireGenerated(const std::string& name, const std::function<MeshData()>& generate) {
+    if (auto model = _models[name].lock()) {
+        _hits++;
+        return model;
+    }
+
+    const auto startPoint = std::chrono::steady_clock::now();
+    auto model = std::make_shared<MeshModel>();
+    model->path = name;
+    model->isGenerated = true;
+
+    const MeshData meshData = generate();
+    model->meshes.emplace_back(meshData.vertices.data(), meshData.vertices.size(), meshData.indices.data(), meshData.indices.size());
+    _freedCpuBytes += meshData.vertices.size() * sizeof(Vertex) + meshData.indices.size() * sizeof(uint32_t);
+    model->loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startPoint).count();
+
+    _models[name] = model;
+    _loads++;
+    return model;
+}
+
+void MeshRegistry::PrintStatistics() const {
+    constexpr double bytesInKilobyte = 1024.0;
+
+    std::cout << std::fixed << std::setprecision(2) << "Models: " << _loads << " loaded, " << _hits << " reused, "
+              << _freedCpuBytes / bytesInKilobyte << " KB of vertices and indices freed after upload" << std::endl;
+
+    for (const auto& [path, weakModel] : _models) {
+        const auto model = weakModel.lock();
+        if (!model)
+            continue;
+
+        std::cout << "  " << path << ": " << (model->isGenerated ? "generated" : model->isCooked ? "cooked" : "Assimp") << ", " << model->loadTime << " ms" << std::endl;
+
+        for (const auto& mesh : model->meshes) {
+            std::cout << "    " << mesh.GetVerticesCount() << " vertices, " << mesh.GetIndicesCount() << " indices, CPU "
+                      << mesh.GetCpuBytes() / bytesInKilobyte << " KB, GPU " << mesh.GetGpuBytes() / bytesInKilobyte << " KB" << std::endl;
+        }
+    }
+}
+
+std::shared_ptr<MeshModel> MeshRegistry::LoadModel(const std::string& path) {
+    ProfileScope profileScope("mesh", path);
+    const auto startPoint = std::chrono::steady_clock::now();
+    auto model = std::make_shared<MeshModel>();
+    model->path = path;
+
+    const std::string cookedPath = CookedMesh::MakeCookedPath(path);
+    model->isCooked = CookedMesh::IsUpToDate(cookedPath, path) && LoadCookedModel(*model, cookedPath);
+
+    if (!model->isCooked) {
+        std::cout << path << " has no up-to-date cooked mesh, it is loaded through Assimp (run MeshCooker to speed it up)" << std::endl;
+
+        for (const auto& meshData : ModelImporter::Import(path)) {
+            model->meshes.emplace_back(meshData.vertices.data(), meshData.vertices.size(), meshData.indices.data(), meshData.indices.size(), meshData.textures);
+            _freedCpuBytes += meshData.vertices.size() * sizeof(Vertex) + meshData.indices.size() * sizeof(uint32_t);
+        }
+    }
+
+    profileScope.SetGpuBytes(model->GetGpuBytes());
+    model->loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startPoint).count();
+    return model;
+}
+
+bool MeshRegistry::LoadCookedModel(MeshModel& model, const std::string& cookedPath) {
+    try {
+        const CookedMesh cookedMesh(cookedPath);
+
+        // Buffers are filled straight from the mapping, the blob is unmapped right after the upload
+        for (const auto& meshView : cookedMesh.GetMeshes())
+            model.meshes.emplace_back(meshView.vertices, meshView.verticesCount, meshView.indices, meshView.indicesCount);
+
+        return true;
+    }
+    catch (const std::runtime_error& error) {
+        std::cout << error.what() << std::endl; // The blob is validated before any mesh is created
+        return false;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef SOLARSYSTEM_MESHREGISTRY_H
+#define SOLARSYSTEM_MESHREGISTRY_H
+#include "Mesh.h"
+#include "ModelImporter.h"
+#include "CookedMesh.h"
+#include <functional>
+#include <map>
+#include <memory>
+
+// All meshes of one model file, shared by every MeshHolder created for this file
+struct MeshModel {
+    std::string path;
+    std::vector<Mesh> meshes;
+    bool isCooked = false; // Loaded from the blob made by MeshCooker, not through Assimp
+    bool isGenerated = false; // Made in code, see MeshRegistry::AcquireGenerated
+    double loadTime = 0.0; // Reading and uploading, ms
+
+    ~MeshModel();
+    size_t GetCpuBytes() const;
+    size_t GetGpuBytes() const;
+};
+
+// Process-wide cache of models. Each file is loaded and uploaded once, the registry holds weak references only,
+// so GL buffers are deleted together with the last MeshHolder. Used from the GL thread only
+class MeshRegistry {
+public:
+    static MeshRegistry& Instance();
+    std::shared_ptr<const MeshModel> Acquire(const std::string& path);
+    // A model made in code, e.g. a sphere tessellation, it is generated and uploaded once and shared by the name like a file
+    std::shared_ptr<const MeshModel> AcquireGenerated(const std::string& name, const std::function<MeshData()>& generate);
+    void PrintStatistics() const;
+
+private:
+    std::map<std::string, std::weak_ptr<const MeshModel>> _models;
+    size_t _hits = 0, _loads = 0;
+    size_t _freedCpuBytes = 0; // Vertices and indices that are not kept after the upload
+
+    MeshRegistry() = default;
+    std::shared_ptr<MeshModel> LoadModel(const std::string& path);
+    static bool LoadCookedModel(MeshModel& model, const std::string& cookedPath);
+};
+
+#endif //SOLARSYSTEM_MESHREGISTRY_H
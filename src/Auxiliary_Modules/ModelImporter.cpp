@@ -0,0 +1,136 @@
+#include "ModelImporter.h"
+#include "VirtualFileSystem.h"
+#include <filesystem>
+#include <stdexcept>
+
+std::vector<MeshData> ModelImporter::Import(const std::string& path) {
+    const AssetFile file = VirtualFileSystem::Instance().Open(path);
+    const std::string formatHint = std::filesystem::path(path).extension().string().substr(1); // "obj", Assimp cannot guess it from memory
+
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFileFromMemory(file.GetData(), file.GetSize(), aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs |
+                                                       aiProcess_CalcTangentSpace, formatHint.c_str());
+
+    if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+        throw std::runtime_error("ERROR::ASSIMP:: " + std::string(importer.GetErrorString()));
+    }
+
+    std::vector<MeshData> meshes;
+    std::vector<Texture> loadedTextures;
+    ProcessNode(scene->mRootNode, scene, meshes, loadedTextures);
+
+    return meshes;
+}
+
+void ModelImporter::ProcessNode(aiNode* node, const aiScene* scene, std::vector<MeshData>& meshes, std::vector<Texture>& loadedTextures) {
+    // Обрабатываем каждую сетку, расположенную в текущем узле
+    for(size_t i = 0; i < node->mNumMeshes; i++) {
+        // Обработать все полигональные сетки в узле(если есть)
+        aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
+        meshes.push_back(ProcessMesh(mesh, scene, loadedTextures));
+    }
+    // Выполнить ту же обработку и для каждого потомка узла
+    for(size_t i = 0; i < node->mNumChildren; i++) {
+        ProcessNode(node->mChildren[i], scene, meshes, loadedTextures);
+    }
+}
+
+MeshData ModelImporter::ProcessMesh(aiMesh* mesh, const aiScene* scene, std::vector<Texture>& loadedTextures) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<Texture> textures;
+
+    // Обход каждой вершины меша
+    for(size_t i = 0; i < mesh->mNumVertices; i++) {
+        Vertex vertex;
+        glm::vec3 vector;
+        vector.x = mesh->mVertices[i].x;
+        vector.y = mesh->mVertices[i].y;
+        vector.z = mesh->mVertices[i].z;
+        vertex.position = vector;
+        //std::cout << "_position: " << vertex.position.x << " " << vertex.position.y << " " << vertex.position.z << std::endl;
+
+        if (mesh->HasNormals()) {
+            vector.x = mesh->mNormals[i].x;
+            vector.y = mesh->mNormals[i].y;
+            vector.z = mesh->mNormals[i].z;
+            vertex.normal = vector;
+            //std::cout << "Normal: " << vertex.normal.x << " " << vertex.normal.y << " " << vertex.normal.z << std::endl;
+        }
+
+        if(mesh->mTextureCoords[0]) {
+            glm::vec2 vec;
+            vec.x = mesh->mTextureCoords[0][i].x;
+            vec.y = mesh->mTextureCoords[0][i].y;
+            vertex.textureCoords = vec;
+            //std::cout << "TextureCoords: " << vertex.textureCoords.x << " " << vertex.textureCoords.y << std::endl;
+
+            vector.x = mesh->mTangents[i].x;
+            vector.y = mesh->mTangents[i].y;
+            vector.z = mesh->mTangents[i].z;
+            vertex.tangent = vector;
+            //std::cout << "Tangent: " << vertex.tangent.x << " " << vertex.tangent.y << " " << vertex.tangent.z << std::endl;
+
+            vector.x = mesh->mBitangents[i].x;
+            vector.y = mesh->mBitangents[i].y;
+            vector.z = mesh->mBitangents[i].z;
+            vertex.bitangent = vector;
+            //std::cout << "Bitangent: " << vertex.bitangent.x << " " << vertex.bitangent.y << " " << vertex.bitangent.z << std::endl;
+        }
+        else
+            vertex.textureCoords = glm::vec2(0.0f, 0.0f);
+
+        vertices.push_back(vertex);
+    }
+
+    for(size_t i = 0; i < mesh->mNumFaces; i++) {
+        aiFace face = mesh->mFaces[i];
+        for(size_t j = 0; j < face.mNumIndices; j++)
+            indices.push_back(face.mIndices[j]);
+    }
+
+    aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+    // 1. Диффузные карты
+    std::vector<Texture> diffuseMaps = LoadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse", loadedTextures);
+    textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
+    // 2. Отражательные карты
+    std::vector<Texture> specularMaps = LoadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular", loadedTextures);
+    textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+    // 3. Карты нормалей
+    std::vector<Texture> normalMaps = LoadMaterialTextures(material, aiTextureType_HEIGHT, "texture_normal", loadedTextures);
+    textures.insert(textures.end(), normalMaps.begin(), normalMaps.end());
+    // 4. Карты высот
+    std::vector<Texture> heightMaps = LoadMaterialTextures(material, aiTextureType_AMBIENT, "texture_height", loadedTextures);
+    textures.insert(textures.end(), heightMaps.begin(), heightMaps.end());
+
+    return MeshData{std::move(vertices), std::move(indices), std::move(textures)};
+}
+
+std::vector<Texture> ModelImporter::LoadMaterialTextures(aiMaterial* mat, const aiTextureType& type, const std::string& typeName, std::vector<Texture>& loadedTextures) {
+    std::vector<Texture> textures;
+    for(size_t i = 0; i < mat->GetTextureCount(type); i++) {
+        aiString str;
+        mat->GetTexture(type, i, &str);
+        bool skip = false;
+        for(const auto& loadedTexture : loadedTextures) {
+            if(loadedTexture.path == str) {
+                textures.push_back(loadedTexture);
+                skip = true;
+                break;
+            }
+        }
+        if(!skip) { // Если текстура не загружалась - загружаем
+            Texture texture;
+            texture.id = TextureFromFile(str.C_Str());
+            texture.type = typeName;
+            texture.path = str.C_Str();
+            textures.push_back(texture);
+            loadedTextures.push_back(texture);
+        }
+    }
+    return textures;
+}
+
+size_t TextureFromFile(const std::string& path) {
+    return 0;
+}
@@ -0,0 +1,22 @@
+#ifndef SOLARSYSTEM_MODELIMPORTER_H
+#define SOLARSYSTEM_MODELIMPORTER_H
+#include "MeshData.h"
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+size_t TextureFromFile(const std::string& path); // Not used at all
+
+// Reads a model file with Assimp into CPU side meshes. Does not touch GL, so it is also used by the offline MeshCooker
+class ModelImporter {
+public:
+    static std::vector<MeshData> Import(const std::string& path);
+
+private:
+    // Обрабатывает узел рекурсивно. Обрабатывает каждую отдельную сетку, расположенную в узле, и повторяет этот процесс на своих дочерних узлах (если есть).
+    static void ProcessNode(aiNode* node, const aiScene* scene, std::vector<MeshData>& meshes, std::vector<Texture>& loadedTextures);
+    static MeshData ProcessMesh(aiMesh* mesh, const aiScene* scene, std::vector<Texture>& loadedTextures);
+    static std::vector<Texture> LoadMaterialTextures(aiMaterial* mat, const aiTextureType& type, const std::string& typeName, std::vector<Texture>& loadedTextures);
+};
+
+#endif //SOLARSYSTEM_MODELIMPORTER_H
@@ -0,0 +1,112 @@
+#include "NoiseVolume.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    uint32_t Hash(int x, int y, int z, uint32_t seed) {
+        uint32_t h = seed ^ static_cast<uint32_t>(x) * 0x8da6b343u ^ static_cast<uint32_t>(y) * 0xd8163841u ^ static_cast<uint32_t>(z) * 0xcb1ab31fu;
+        h ^= h >> 16;
+        h *= 0x7feb352du;
+        h ^= h >> 15;
+        h *= 0x846ca68bu;
+        h ^= h >> 16;
+        return h;
+    }
+
+    float Gradient(uint32_t hash, const glm::vec3& offset) {
+        // The 12 edge directions of a cube, as in improved Perlin noise
+        static constexpr float gradients[12][3] = {
+                {1, 1, 0}, {-1, 1, 0}, {1, -1, 0}, {-1, -1, 0},
+                {1, 0, 1}, {-1, 0, 1}, {1, 0, -1}, {-1, 0, -1},
+                {0, 1, 1}, {0, -1, 1}, {0, 1, -1}, {0, -1, -1}
+        };
+        const float* g = gradients[hash % 12];
+        return g[0] * offset.x + g[1] * offset.y + g[2] * offset.z;
+    }
+
+    float Fade(float t) {
+        return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+    }
+}
+
+NoiseVolume::NoiseVolume(uint16_t size, uint16_t period, uint32_t seed) : _size(size), _period(period) {
+    if (size == 0 || period == 0 || size % period != 0)
+        throw std::runtime_error("The size of a noise volume must be a multiple of its period, got " + std::to_string(size) + " and " + std::to_string(period));
+
+    const auto bakeStart = std::chrono::steady_clock::now();
+    std::vector<glm::vec4> texels(static_cast<size_t>(size) * size * size);
+    const float cellsPerTexel = static_cast<float>(period) / static_cast<float>(size);
+
+    auto bakeSlices = [&](uint16_t firstSlice, uint16_t step) {
+        for (uint16_t z = firstSlice; z < size; z += step) {
+            for (uint16_t y = 0; y < size; y++) {
+                for (uint16_t x = 0; x < size; x++) {
+                    const glm::vec3 position = glm::vec3(x, y, z) * cellsPerTexel;
+                    glm::vec4& texel = texels[(static_cast<size_t>(z) * size + y) * size + x];
+                    for (int channel = 0; channel < 4; channel++)
+                        texel[channel] = GradientNoise(position, period, seed + channel);
+                }
+            }
+        }
+    };
+
+    const auto threadsCount = static_cast<uint16_t>(std::clamp<unsigned>(std::thread::hardware_concurrency(), 1, size));
+    std::vector<std::thread> workers;
+    for (uint16_t i = 1; i < threadsCount; i++)
+        workers.emplace_back(bakeSlices, i, threadsCount);
+    bakeSlices(0, threadsCount);
+    for (auto& worker : workers)
+        worker.join();
+
+    const auto levelsCount = static_cast<GLsizei>(std::log2(size)) + 1;
+    glCreateTextures(GL_TEXTURE_3D, 1, &_texture);
+    glTextureStorage3D(_texture, levelsCount, GL_RGBA16F, size, size, size);
+    glTextureSubImage3D(_texture, 0, 0, 0, 0, size, size, size, GL_RGBA, GL_FLOAT, texels.data());
+    glGenerateTextureMipmap(_texture);
+    glTextureParameteri(_texture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(_texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTextureParameteri(_texture, GL_TEXTURE_WRAP_R, GL_REPEAT);
+    glTextureParameteri(_texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTextureParameteri(_texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    const auto bakeTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - bakeStart).count();
+    std::cout << "Noise volume " << size << "^3 (period " << period << ") baked in " << bakeTime << " ms on " << threadsCount << " threads" << std::endl;
+}
+
+NoiseVolume::~NoiseVolume() {
+    glDeleteTextures(1, &_texture);
+}
+
+GLuint NoiseVolume::GetTexture() const {
+    return _texture;
+}
+
+float NoiseVolume::GetPeriod() const {
+    return static_cast<float>(_period);
+}
+
+float NoiseVolume::GradientNoise(const glm::vec3& position, int period, uint32_t seed) {
+    const glm::vec3 cell = glm::floor(position);
+    const glm::vec3 offset = position - cell;
+    const glm::vec3 fade(Fade(offset.x), Fade(offset.y), Fade(offset.z));
+    const int x0 = static_cast<int>(cell.x) % period, y0 = static_cast<int>(cell.y) % period, z0 = static_cast<int>(cell.z) % period;
+    const int x1 = (x0 + 1) % period, y1 = (y0 + 1) % period, z1 = (z0 + 1) % period; // The lattice wraps, so the noise tiles
+
+    auto corner = [&](int x, int y, int z, float dx, float dy, float dz) {
+        return Gradient(Hash(x, y, z, seed), offset - glm::vec3(dx, dy, dz));
+    };
+
+    const float x00 = glm::mix(corner(x0, y0, z0, 0, 0, 0), corner(x1, y0, z0, 1, 0, 0), fade.x);
+    const float x10 = glm::mix(corner(x0, y1, z0, 0, 1, 0), corner(x1, y1, z0, 1, 1, 0), fade.x);
+    const float x01 = glm::mix(corner(x0, y0, z1, 0, 0, 1), corner(x1, y0, z1, 1, 0, 1), fade.x);
+    const float x11 = glm::mix(corner(x0, y1, z1, 0, 1, 1), corner(x1, y1, z1, 1, 1, 1), fade.x);
+    const float value = glm::mix(glm::mix(x00, x10, fade.y), glm::mix(x01, x11, fade.y), fade.z);
+
+    return glm::clamp(value, -1.0f, 1.0f);
+}
@@ -0,0 +1,27 @@
+#ifndef SOLARSYSTEM_NOISEVOLUME_H
+#define SOLARSYSTEM_NOISEVOLUME_H
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+
+// Tiling 3D gradient noise baked once at startup into a mipmapped GL_RGBA16F texture, four independent fields in its channels.
+// The lattice wraps every `period` cells, so the texture repeats seamlessly and octaves are sampled with scaled coordinates
+// (see noiseVolume.glsl). The slices are baked on all CPU cores, which takes a fraction of a second for 128^3
+class NoiseVolume {
+public:
+    NoiseVolume(uint16_t size, uint16_t period, uint32_t seed = 1);
+    NoiseVolume(const NoiseVolume&) = delete;
+    NoiseVolume& operator=(const NoiseVolume&) = delete;
+    ~NoiseVolume();
+
+    GLuint GetTexture() const;
+    float GetPeriod() const; // In lattice cells, the same units snoise takes
+
+private:
+    GLuint _texture = 0;
+    uint16_t _size, _period;
+
+    static float GradientNoise(const glm::vec3& position, int period, uint32_t seed); // In [-1, 1]
+};
+
+#endif //SOLARSYSTEM_NOISEVOLUME_H
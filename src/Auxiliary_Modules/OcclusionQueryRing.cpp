@@ -0,0 +1,77 @@
+#include "OcclusionQueryRing.h"
+
+OcclusionQueryRing::OcclusionQueryRing(uint8_t pairsCount) : _pairs(pairsCount) {
+    for (auto& pair : _pairs) {
+        glGenQueries(1, &pair.totalQuery);
+        glGenQueries(1, &pair.passedQuery);
+    }
+}
+
+OcclusionQueryRing::~OcclusionQueryRing() {
+    for (const auto& pair : _pairs) {
+        glDeleteQueries(1, &pair.totalQuery);
+        glDeleteQueries(1, &pair.passedQuery);
+    }
+}
+
+void OcclusionQueryRing::Begin(OcclusionSamples samples) {
+    QueryPair& pair = _pairs[_currentPair];
+    glBeginQuery(GL_SAMPLES_PASSED, samples == OcclusionSamples::Total ? pair.totalQuery : pair.passedQuery);
+    _isIssued = true;
+}
+
+void OcclusionQueryRing::End() {
+    glEndQuery(GL_SAMPLES_PASSED);
+}
+
+void OcclusionQueryRing::EndFrame() {
+    _frame++;
+    if (!_isIssued)
+        return;
+
+    QueryPair& pair = _pairs[_currentPair];
+    pair.frame = _frame - 1;
+    pair.isPending = true;
+
+    _currentPair = (_currentPair + 1) % _pairs.size();
+    _isIssued = false;
+}
+
+bool OcclusionQueryRing::ReadVisibility(float& visibility) {
+    // From the oldest pair to the newest one. The queries complete in order, so the first unavailable result ends the search
+    bool isRead = false;
+
+    for (size_t i = 0; i < _pairs.size(); i++) {
+        QueryPair& pair = _pairs[(_currentPair + i) % _pairs.size()];
+        if (!pair.isPending)
+            continue;
+
+        GLuint isAvailable = GL_FALSE;
+        glGetQueryObjectuiv(pair.passedQuery, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+        if (!isAvailable)
+            break;
+
+        GLuint totalSamples = 0, passedSamples = 0;
+        glGetQueryObjectuiv(pair.totalQuery, GL_QUERY_RESULT, &totalSamples); // Issued before the passed one, so it is available too
+        glGetQueryObjectuiv(pair.passedQuery, GL_QUERY_RESULT, &passedSamples);
+
+        visibility = totalSamples == 0 ? 0.0f : static_cast<float>(passedSamples) / static_cast<float>(totalSamples);
+        _lastLatency = _frame - pair.frame;
+        pair.isPending = false;
+        isRead = true;
+    }
+
+    return isRead;
+}
+
+bool OcclusionQueryRing::IsIssued() const {
+    return _isIssued;
+}
+
+GLuint OcclusionQueryRing::GetPassedQuery() const {
+    return _pairs[_currentPair].passedQuery;
+}
+
+uint64_t OcclusionQueryRing::GetLastLatency() const {
+    return _lastLatency;
+}
@@ -0,0 +1,45 @@
+#ifndef SOLARSYSTEM_OCCLUSIONQUERYRING_H
+#define SOLARSYSTEM_OCCLUSIONQUERYRING_H
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class OcclusionSamples : uint8_t {
+    Total, // Drawn without the depth test
+    Passed
+};
+
+// Pairs of GL_SAMPLES_PASSED queries, one pair per frame in flight. The results are read a frame or more later,
+// only once GL_QUERY_RESULT_AVAILABLE is set, so the CPU never waits for the GPU. A pair which is still pending when
+// its turn comes again is simply reissued and its result is lost
+class OcclusionQueryRing {
+public:
+    explicit OcclusionQueryRing(uint8_t pairsCount);
+    OcclusionQueryRing(const OcclusionQueryRing&) = delete;
+    OcclusionQueryRing& operator=(const OcclusionQueryRing&) = delete;
+    ~OcclusionQueryRing();
+
+    void Begin(OcclusionSamples samples);
+    void End();
+    void EndFrame();
+    // The passed to total samples ratio of the newest pair with an available result. Returns false if no result arrived since the last call
+    bool ReadVisibility(float& visibility);
+    bool IsIssued() const; // Whether the queries of the current frame were issued
+    GLuint GetPassedQuery() const; // Of the current frame, for glBeginConditionalRender
+    uint64_t GetLastLatency() const; // Frames between issuing and reading the last result
+
+private:
+    struct QueryPair {
+        GLuint totalQuery = 0, passedQuery = 0;
+        uint64_t frame = 0;
+        bool isPending = false;
+    };
+
+    std::vector<QueryPair> _pairs;
+    size_t _currentPair = 0;
+    uint64_t _frame = 0, _lastLatency = 0;
+    bool _isIssued = false;
+};
+
+#endif //SOLARSYSTEM_OCCLUSIONQUERYRING_H
@@ -0,0 +1,52 @@
+#include "RenderQueue.h"
+#include <algorithm>
+#include <tuple>
+
+void RenderQueue::SetLightBlockBinder(LightBlockBinder binder) {
+    _bindLightBlock = std::move(binder);
+}
+
+void RenderQueue::Submit(RenderCommand command) {
+    if (command.state.isBlend)
+        _transparentCommands.push_back(std::move(command));
+    else
+        _opaqueCommands.push_back(std::move(command));
+}
+
+void RenderQueue::FlushOpaque() {
+    std::sort(_opaqueCommands.begin(), _opaqueCommands.end(), [](const RenderCommand& lhs, const RenderCommand& rhs) {
+        return std::tie(lhs.program, lhs.texture, lhs.mesh) < std::tie(rhs.program, rhs.texture, rhs.mesh);
+    });
+
+    Execute(_opaqueCommands);
+}
+
+void RenderQueue::FlushTransparent() {
+    std::stable_sort(_transparentCommands.begin(), _transparentCommands.end(), [](const RenderCommand& lhs, const RenderCommand& rhs) {
+        return lhs.cameraDistance > rhs.cameraDistance;
+    });
+
+    Execute(_transparentCommands);
+}
+
+void RenderQueue::Flush() {
+    FlushOpaque();
+    FlushTransparent();
+}
+
+void RenderQueue::Execute(std::vector<RenderCommand>& commands) {
+    auto& renderState = RenderStateCache::Instance();
+    GLintptr boundLightBlock = -1; // The draws outside the queue may bind other blocks, so nothing is assumed between flushes
+
+    for (const auto& command : commands) {
+        if (command.lightBlockOffset >= 0 && command.lightBlockOffset != boundLightBlock && _bindLightBlock) {
+            _bindLightBlock(command.lightBlockOffset);
+            boundLightBlock = command.lightBlockOffset;
+        }
+
+        renderState.Apply(command.state);
+        command.draw();
+    }
+
+    commands.clear(); // Keeps the capacity for the next pass
+}
@@ -0,0 +1,36 @@
+#ifndef SOLARSYSTEM_RENDERQUEUE_H
+#define SOLARSYSTEM_RENDERQUEUE_H
+#include "RenderStateCache.h"
+#include <functional>
+#include <vector>
+
+struct RenderCommand {
+    RenderState state; // Blended commands are transparent
+    GLuint program = 0, texture = 0; // Sort keys of opaque commands
+    const void* mesh = nullptr;
+    float cameraDistance = 0.0f; // Sort key of transparent commands
+    GLintptr lightBlockOffset = -1; // Of the light block of the drawn component, -1 if the draw needs none
+    std::function<void()> draw; // Binds the program and issues the draw, the state is already applied
+};
+
+// Collects the draws of a pass. Opaque commands are sorted by program, texture and mesh so that the state cache drops most of
+// the transitions between them, transparent ones are sorted back-to-front (stable, so shells at the same distance keep the submission order).
+// Commands of several components can be mixed, the light block of each command is bound before it when it differs from the previous one
+class RenderQueue {
+public:
+    using LightBlockBinder = std::function<void(GLintptr offset)>;
+
+    void SetLightBlockBinder(LightBlockBinder binder);
+    void Submit(RenderCommand command);
+    void FlushOpaque();
+    void FlushTransparent();
+    void Flush();
+
+private:
+    std::vector<RenderCommand> _opaqueCommands, _transparentCommands;
+    LightBlockBinder _bindLightBlock;
+
+    void Execute(std::vector<RenderCommand>& commands);
+};
+
+#endif //SOLARSYSTEM_RENDERQUEUE_H
@@ -0,0 +1,118 @@
+#include "RenderStateCache.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+RenderStateCache& RenderStateCache::Instance() {
+    static RenderStateCache cache;
+    return cache;
+}
+
+void RenderStateCache::Apply(const RenderState& state) {
+    SetCapability(GL_BLEND, state.isBlend);
+    SetCapability(GL_DEPTH_TEST, state.isDepthTest);
+    SetCapability(GL_CULL_FACE, state.isCullFace);
+    SetDepthMask(state.isDepthWrite ? GL_TRUE : GL_FALSE);
+
+    // State which is disabled is left as it is, it does not affect the draw
+    if (state.isBlend)
+        SetBlendFunc(state.blendSource, state.blendDestination);
+    if (state.isDepthTest)
+        SetDepthFunc(state.depthFunc);
+    if (state.isCullFace)
+        SetFrontFace(state.frontFace);
+}
+
+void RenderStateCache::Enable(GLenum capability) {
+    SetCapability(capability, true);
+}
+
+void RenderStateCache::Disable(GLenum capability) {
+    SetCapability(capability, false);
+}
+
+void RenderStateCache::SetDepthMask(GLboolean isDepthWrite) {
+    const Tristate depthMask = isDepthWrite ? Tristate::On : Tristate::Off;
+    if (Transition(_depthMask == depthMask)) {
+        glDepthMask(isDepthWrite);
+        _depthMask = depthMask;
+    }
+}
+
+void RenderStateCache::SetDepthFunc(GLenum func) {
+    if (Transition(_depthFunc == func)) {
+        glDepthFunc(func);
+        _depthFunc = func;
+    }
+}
+
+void RenderStateCache::SetBlendFunc(GLenum source, GLenum destination) {
+    if (Transition(_blendSource == source && _blendDestination == destination)) {
+        glBlendFunc(source, destination);
+        _blendSource = source;
+        _blendDestination = destination;
+    }
+}
+
+void RenderStateCache::SetFrontFace(GLenum mode) {
+    if (Transition(_frontFace == mode)) {
+        glFrontFace(mode);
+        _frontFace = mode;
+    }
+}
+
+void RenderStateCache::SetCullFace(GLenum mode) {
+    if (Transition(_cullFace == mode)) {
+        glCullFace(mode);
+        _cullFace = mode;
+    }
+}
+
+bool RenderStateCache::UseProgram(GLuint program) {
+    if (!Transition(_program == program))
+        return false;
+
+    glUseProgram(program);
+    _program = program;
+    return true;
+}
+
+void RenderStateCache::Invalidate() {
+    _capabilities.fill(Tristate::Unknown);
+    _depthMask = Tristate::Unknown;
+    _depthFunc = _blendSource = _blendDestination = _frontFace = _cullFace = UNKNOWN_ENUM;
+    _program = UNKNOWN_ENUM;
+}
+
+void RenderStateCache::EndFrame() {
+    _lastFrameStatistics = _frameStatistics;
+    _frameStatistics = FrameStatistics();
+}
+
+const RenderStateCache::FrameStatistics& RenderStateCache::GetLastFrameStatistics() const {
+    return _lastFrameStatistics;
+}
+
+void RenderStateCache::SetCapability(GLenum capability, bool isEnabled) {
+    const auto it = std::find(CAPABILITIES.begin(), CAPABILITIES.end(), capability);
+    if (it == CAPABILITIES.end())
+        throw std::runtime_error("Render state cache does not track the capability " + std::to_string(capability));
+
+    Tristate& current = _capabilities[it - CAPABILITIES.begin()];
+    const Tristate required = isEnabled ? Tristate::On : Tristate::Off;
+
+    if (Transition(current == required)) {
+        isEnabled ? glEnable(capability) : glDisable(capability);
+        current = required;
+    }
+}
+
+bool RenderStateCache::Transition(bool isRedundant) {
+    if (isRedundant) {
+        _frameStatistics.redundantChanges++;
+        return false;
+    }
+
+    _frameStatistics.stateChanges++;
+    return true;
+}
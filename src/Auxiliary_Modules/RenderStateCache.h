@@ -0,0 +1,56 @@
+#ifndef SOLARSYSTEM_RENDERSTATECACHE_H
+#define SOLARSYSTEM_RENDERSTATECACHE_H
+#include <GL/glew.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-function state that a draw needs. Defaults are the state of opaque geometry
+struct RenderState {
+    bool isBlend = false, isDepthTest = true, isDepthWrite = true, isCullFace = true;
+    GLenum blendSource = GL_SRC_ALPHA, blendDestination = GL_ONE_MINUS_SRC_ALPHA;
+    GLenum depthFunc = GL_LESS, frontFace = GL_CCW;
+};
+
+// Shadows the GL state of the context and drops transitions to the state which is already set. All state changes of the
+// renderer must go through it, otherwise the shadow copy gets out of sync (Invalidate restores it). Used from the GL thread only
+class RenderStateCache {
+public:
+    struct FrameStatistics {
+        size_t stateChanges = 0, redundantChanges = 0;
+    };
+
+    static RenderStateCache& Instance();
+    void Apply(const RenderState& state);
+    void Enable(GLenum capability);
+    void Disable(GLenum capability);
+    void SetDepthMask(GLboolean isDepthWrite);
+    void SetDepthFunc(GLenum func);
+    void SetBlendFunc(GLenum source, GLenum destination);
+    void SetFrontFace(GLenum mode);
+    void SetCullFace(GLenum mode);
+    bool UseProgram(GLuint program); // Returns false if the program is already in use
+    void Invalidate(); // Forgets the shadowed state, the next transitions are issued unconditionally
+    void EndFrame(); // Stores the counters of the frame and resets them
+    const FrameStatistics& GetLastFrameStatistics() const;
+
+private:
+    enum class Tristate : uint8_t { Unknown, Off, On };
+
+    static constexpr std::array<GLenum, 6> CAPABILITIES = {GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, GL_MULTISAMPLE, GL_TEXTURE_2D,
+                                                           GL_POLYGON_SMOOTH};
+    static constexpr GLenum UNKNOWN_ENUM = 0xFFFFFFFF;
+
+    std::array<Tristate, CAPABILITIES.size()> _capabilities {};
+    Tristate _depthMask = Tristate::Unknown;
+    GLenum _depthFunc = UNKNOWN_ENUM, _blendSource = UNKNOWN_ENUM, _blendDestination = UNKNOWN_ENUM;
+    GLenum _frontFace = UNKNOWN_ENUM, _cullFace = UNKNOWN_ENUM;
+    GLuint _program = UNKNOWN_ENUM;
+    FrameStatistics _frameStatistics, _lastFrameStatistics;
+
+    RenderStateCache() = default;
+    void SetCapability(GLenum capability, bool isEnabled);
+    bool Transition(bool isRedundant); // Counts the transition, returns true if it must be issued
+};
+
+#endif //SOLARSYSTEM_RENDERSTATECACHE_H
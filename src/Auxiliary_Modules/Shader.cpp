@@ -1,191 +1,295 @@
 #include "Shader.h"
-
-Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath) {
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::string geometryCode;
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
-    std::ifstream gShaderFile;
-
-    // Убеждаемся, что объекты ifstream могут выбросить исключение
-    vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    gShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-    try {
-        // Открываем файлы
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
-        std::ostringstream vShaderStream, fShaderStream;
-
-        // Считываем содержимое файловых буферов в потоки
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-
-        // Закрываем файлы
-        vShaderFile.close();
-        fShaderFile.close();
-
-        // Конвертируем данные из потока в строковые переменные
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-
-        if(!geometryPath.empty()) {
-            gShaderFile.open(geometryPath);
-            std::stringstream gShaderStream;
-            gShaderStream << gShaderFile.rdbuf();
-            gShaderFile.close();
-            geometryCode = gShaderStream.str();
-        }
-    }
-
-    catch (const std::ifstream::failure& e) {
-        std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+#include "ShaderCache.h"
+#include "VirtualFileSystem.h"
+#include "StartupProfiler.h"
+#include "RenderStateCache.h"
+#include <algorithm>
+#include <chrono>
+
+Shader::CallStatistics Shader::_callStatistics;
+bool Shader::_isLocationCacheEnabled = true;
+
+Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath, const std::vector<std::string>& defines) :
+    _program(std::make_shared<Program>())
+{
+    ProfileScope profileScope("shader", vertexPath + " + " + fragmentPath);
+    const auto startPoint = std::chrono::steady_clock::now();
+    std::string vertexCode = ReadSourceFile(vertexPath);
+    std::string fragmentCode = ReadSourceFile(fragmentPath);
+    std::string geometryCode = geometryPath.empty() ? "" : ReadSourceFile(geometryPath);
+    InsertDefines(vertexCode, defines);
+    InsertDefines(fragmentCode, defines);
+    InsertDefines(geometryCode, defines);
+
+    auto& cache = ShaderCache::Instance();
+    _program->name = vertexPath + " + " + fragmentPath + (geometryPath.empty() ? "" : " + " + geometryPath);
+    for (const auto& define : defines)
+        _program->name += " [" + define + "]";
+    _program->cacheKey = cache.CalculateKey({vertexCode, fragmentCode, geometryCode});
+    _program->id = cache.Load(_program->cacheKey, _program->name);
+
+    if (_program->id != 0) { // Тёплый старт: компиляция GLSL не нужна
+        _program->isLinked = true;
+        ReadUniformLocations();
+        return;
     }
 
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-
-    // Этап №2: Компилируем шейдеры
-    size_t vertex, fragment;
-
-    // Вершинный шейдер
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, nullptr);
-    glCompileShader(vertex);
-    CheckCompileErrors(vertex, ShaderType::VertexShader, vertexPath);
-
-    // Фрагментный шейдер
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, nullptr);
-    glCompileShader(fragment);
-    CheckCompileErrors(fragment, ShaderType::FragmentShader, fragmentPath);
-
-    // Геометрический шейдер (если есть)
-    size_t geometry;
-    if(!geometryPath.empty()) {
-        const char* gShaderCode = geometryCode.c_str();
-        geometry = glCreateShader(GL_GEOMETRY_SHADER);
-        glShaderSource(geometry, 1, &gShaderCode, nullptr);
-        glCompileShader(geometry);
-        CheckCompileErrors(geometry, ShaderType::GeometryShader, geometryPath);
-    }
+    // Этап №2: Компилируем шейдеры. Статус компиляции не запрашивается, чтобы драйвер мог собирать программы параллельно
+    const auto compileStage = [this](GLenum glType, ShaderType type, const std::string& code, const std::string& path) {
+        const char* shaderCode = code.c_str();
+        const GLuint shader = glCreateShader(glType);
+        glShaderSource(shader, 1, &shaderCode, nullptr);
+        glCompileShader(shader);
+        _program->stages.push_back(StageInfo{shader, type, path});
+    };
+
+    compileStage(GL_VERTEX_SHADER, ShaderType::VertexShader, vertexCode, vertexPath); // Вершинный шейдер
+    compileStage(GL_FRAGMENT_SHADER, ShaderType::FragmentShader, fragmentCode, fragmentPath); // Фрагментный шейдер
+    if (!geometryPath.empty())
+        compileStage(GL_GEOMETRY_SHADER, ShaderType::GeometryShader, geometryCode, geometryPath); // Геометрический шейдер (если есть)
 
     // Шейдерная программа
-    _shaderProgramID = glCreateProgram();
-    glAttachShader(_shaderProgramID, vertex); // Прикрепление вершинного шейдера
-    glAttachShader(_shaderProgramID, fragment); // Прикрепление фрагментного шейдера
-    if (!geometryPath.empty())
-        glAttachShader(_shaderProgramID, geometry); // Прикрепление геометрического шейдера
-    glLinkProgram(_shaderProgramID); // Сборка шейдерной программы из прикреплённых шейдеров
-    CheckCompileErrors(_shaderProgramID, ShaderType::ShaderProgram, fragmentPath);
+    _program->id = glCreateProgram();
+    for (const auto& stage : _program->stages)
+        glAttachShader(_program->id, stage.shaderId); // Прикрепление шейдеров
+    glProgramParameteri(_program->id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(_program->id); // Сборка шейдерной программы из прикреплённых шейдеров
 
-    // Удаление шейдеров
-    glDetachShader(_shaderProgramID, vertex);
-    glDeleteShader(vertex);
-    glDetachShader(_shaderProgramID, fragment);
-    glDeleteShader(fragment);
-    if (!geometryPath.empty()) {
-        glDetachShader(_shaderProgramID, geometry);
-        glDeleteShader(geometry);
-    }
+    _program->compileTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startPoint).count();
 }
 
 void Shader::Use() const {
-    glUseProgram(_shaderProgramID);
+    if (RenderStateCache::Instance().UseProgram(GetProgramId())) // Counts only the calls which reach GL
+        _callStatistics.useProgramCalls++;
 }
 
-void Shader::SetBool(const std::string& name, bool value) const {
-    glUniform1i(glGetUniformLocation(_shaderProgramID, name.c_str()), static_cast<int>(value));
+void Shader::SetBool(std::string_view name, bool value) const {
+    Upload(GetUniformLocation(name), value);
 }
 
-void Shader::SetInt(const std::string& name, int value) const {
-    glUniform1i(glGetUniformLocation(_shaderProgramID, name.c_str()), value);
+void Shader::SetInt(std::string_view name, int value) const {
+    Upload(GetUniformLocation(name), value);
 }
 
-void Shader::SetFloat(const std::string& name, float value) const {
-    glUniform1f(glGetUniformLocation(_shaderProgramID, name.c_str()), value);
+void Shader::SetFloat(std::string_view name, float value) const {
+    Upload(GetUniformLocation(name), value);
 }
 
-void Shader::SetDouble(const std::string &name, double value) const {
-    glUniform1d(glGetUniformLocation(_shaderProgramID, name.c_str()), value);
+void Shader::SetDouble(std::string_view name, double value) const {
+    Upload(GetUniformLocation(name), value);
 }
 
-void Shader::SetVec2(const std::string& name, const glm::vec2& value) const {
-    glUniform2fv(glGetUniformLocation(_shaderProgramID, name.c_str()), 1, &value[0]);
+void Shader::SetVec2(std::string_view name, const glm::vec2& value) const {
+    Upload(GetUniformLocation(name), value);
 }
 
-void Shader::SetVec2(const std::string& name, float x, float y) const {
-    glUniform2f(glGetUniformLocation(_shaderProgramID, name.c_str()), x, y);
+void Shader::SetVec2(std::string_view name, float x, float y) const {
+    Upload(GetUniformLocation(name), glm::vec2(x, y));
 }
 
-void Shader::SetVec3(const std::string& name, const glm::vec3& value) const {
-    glUniform3fv(glGetUniformLocation(_shaderProgramID, name.c_str()), 1, &value[0]);
+void Shader::SetVec3(std::string_view name, const glm::vec3& value) const {
+    Upload(GetUniformLocation(name), value);
 }
 
-void Shader::SetVec3(const std::string& name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(_shaderProgramID, name.c_str()), x, y, z);
+void Shader::SetVec3(std::string_view name, float x, float y, float z) const {
+    Upload(GetUniformLocation(name), glm::vec3(x, y, z));
 }
 
-void Shader::SetVec4(const std::string& name, const glm::vec4& value) const {
-    glUniform4fv(glGetUniformLocation(_shaderProgramID, name.c_str()), 1, &value[0]);
+void Shader::SetVec4(std::string_view name, const glm::vec4& value) const {
+    Upload(GetUniformLocation(name), value);
 }
 
-void Shader::SetVec4(const std::string& name, float x, float y, float z, float w) const {
-    glUniform4f(glGetUniformLocation(_shaderProgramID, name.c_str()), x, y, z, w);
+void Shader::SetVec4(std::string_view name, float x, float y, float z, float w) const {
+    Upload(GetUniformLocation(name), glm::vec4(x, y, z, w));
 }
 
-void Shader::SetMat2(const std::string& name, const glm::mat2& mat) const {
-    glUniformMatrix2fv(glGetUniformLocation(_shaderProgramID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+void Shader::SetMat2(std::string_view name, const glm::mat2& mat) const {
+    Upload(GetUniformLocation(name), mat);
 }
 
-void Shader::SetMat3(const std::string& name, const glm::mat3& mat) const {
-    glUniformMatrix3fv(glGetUniformLocation(_shaderProgramID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+void Shader::SetMat3(std::string_view name, const glm::mat3& mat) const {
+    Upload(GetUniformLocation(name), mat);
 }
 
-void Shader::SetMat4(const std::string& name, const glm::mat4& mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(_shaderProgramID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+void Shader::SetMat4(std::string_view name, const glm::mat4& mat) const {
+    Upload(GetUniformLocation(name), mat);
 }
 
-void Shader::SetVec2Double(const std::string& name, const glm::dvec2& value) const {
-    glUniform2dv(glGetUniformLocation(_shaderProgramID, name.c_str()), 1, &value[0]);
+void Shader::SetVec2Double(std::string_view name, const glm::dvec2& value) const {
+    Upload(GetUniformLocation(name), value);
 }
 
-void Shader::SetVec2Double(const std::string& name, double x, double y) const {
-    glUniform2d(glGetUniformLocation(_shaderProgramID, name.c_str()), x, y);
+void Shader::SetVec2Double(std::string_view name, double x, double y) const {
+    Upload(GetUniformLocation(name), glm::dvec2(x, y));
 }
 
-void Shader::SetVec3Double(const std::string& name, const glm::dvec3& value) const {
-    glUniform3dv(glGetUniformLocation(_shaderProgramID, name.c_str()), 1, &value[0]);
+void Shader::SetVec3Double(std::string_view name, const glm::dvec3& value) const {
+    Upload(GetUniformLocation(name), value);
 }
 
-void Shader::SetVec3Double(const std::string& name, double x, double y, double z) const {
-    glUniform3d(glGetUniformLocation(_shaderProgramID, name.c_str()), x, y, z);
+void Shader::SetVec3Double(std::string_view name, double x, double y, double z) const {
+    Upload(GetUniformLocation(name), glm::dvec3(x, y, z));
 }
 
-void Shader::SetVec4Double(const std::string& name, const glm::dvec4& value) const {
-    glUniform4dv(glGetUniformLocation(_shaderProgramID, name.c_str()), 1, &value[0]);
+void Shader::SetVec4Double(std::string_view name, const glm::dvec4& value) const {
+    Upload(GetUniformLocation(name), value);
 }
 
-void Shader::SetVec4Double(const std::string& name, double x, double y, double z, double w) const {
-    glUniform4d(glGetUniformLocation(_shaderProgramID, name.c_str()), x, y, z, w);
+void Shader::SetVec4Double(std::string_view name, double x, double y, double z, double w) const {
+    Upload(GetUniformLocation(name), glm::dvec4(x, y, z, w));
 }
 
-void Shader::SetMat2Double(const std::string& name, const glm::dmat2& mat) const {
-    glUniformMatrix2dv(glGetUniformLocation(_shaderProgramID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+void Shader::SetMat2Double(std::string_view name, const glm::dmat2& mat) const {
+    Upload(GetUniformLocation(name), mat);
 }
 
-void Shader::SetMat3Double(const std::string& name, const glm::dmat3& mat) const {
-    glUniformMatrix3dv(glGetUniformLocation(_shaderProgramID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+void Shader::SetMat3Double(std::string_view name, const glm::dmat3& mat) const {
+    Upload(GetUniformLocation(name), mat);
 }
 
-void Shader::SetMat4Double(const std::string& name, const glm::dmat4& mat) const {
-    glUniformMatrix4dv(glGetUniformLocation(_shaderProgramID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+void Shader::SetMat4Double(std::string_view name, const glm::dmat4& mat) const {
+    Upload(GetUniformLocation(name), mat);
 }
 
 size_t Shader::GetProgramId() const {
-    return _shaderProgramID;
+    if (!_program->isLinked)
+        FinishLinking();
+
+    return _program->id;
+}
+
+const Shader::CallStatistics& Shader::GetCallStatistics() {
+    return _callStatistics;
+}
+
+void Shader::ResetCallStatistics() {
+    _callStatistics = CallStatistics();
+}
+
+void Shader::SetLocationCacheEnabled(bool isEnabled) {
+    _isLocationCacheEnabled = isEnabled;
+}
+
+GLint Shader::GetUniformLocation(std::string_view name) const {
+    const GLuint programId = GetProgramId();
+
+    if (!_isLocationCacheEnabled) {
+        _callStatistics.getUniformLocationCalls++;
+        return glGetUniformLocation(programId, std::string(name).c_str());
+    }
+
+    const auto& uniforms = _program->uniforms;
+    const auto uniformIt = std::lower_bound(uniforms.cbegin(), uniforms.cend(), name,
+                                            [](const UniformLocation& uniform, std::string_view name) { return uniform.name < name; });
+
+    return uniformIt != uniforms.cend() && uniformIt->name == name ? uniformIt->location : -1;
+}
+
+void Shader::FinishLinking() const {
+    ProfileScope profileScope("shader link", _program->name);
+    const auto startPoint = std::chrono::steady_clock::now();
+
+    GLint isLinked = GL_FALSE;
+    glGetProgramiv(_program->id, GL_LINK_STATUS, &isLinked); // Ждёт окончания сборки
+    if (!isLinked) {
+        for (const auto& stage : _program->stages)
+            CheckCompileErrors(stage.shaderId, stage.type, stage.path);
+        CheckCompileErrors(_program->id, ShaderType::ShaderProgram, _program->name);
+    }
+
+    // Удаление шейдеров
+    for (const auto& stage : _program->stages) {
+        glDetachShader(_program->id, stage.shaderId);
+        glDeleteShader(stage.shaderId);
+    }
+    _program->stages.clear();
+    _program->isLinked = true;
+    ReadUniformLocations();
+
+    _program->compileTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startPoint).count();
+    ShaderCache::Instance().Store(_program->cacheKey, _program->id, _program->name, _program->compileTime);
+}
+
+void Shader::ReadUniformLocations() const {
+    GLint uniformsCount = 0;
+    glGetProgramInterfaceiv(_program->id, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniformsCount);
+
+    auto& uniforms = _program->uniforms;
+    uniforms.clear();
+    std::string name;
+
+    for (GLint i = 0; i < uniformsCount; i++) {
+        const GLenum properties[] = {GL_NAME_LENGTH, GL_LOCATION, GL_ARRAY_SIZE};
+        GLint values[3] = {};
+        glGetProgramResourceiv(_program->id, GL_UNIFORM, i, 3, properties, 3, nullptr, values);
+
+        if (values[1] == -1) // A member of a uniform block
+            continue;
+
+        name.resize(values[0]);
+        glGetProgramResourceName(_program->id, GL_UNIFORM, i, values[0], nullptr, name.data());
+        name.resize(values[0] - 1); // Without the terminating zero
+
+        // Arrays are reported as "name[0]", but they are also set by the name without the index or through the other elements
+        const size_t bracketPosition = name.rfind("[0]");
+        if (bracketPosition != std::string::npos && bracketPosition + 3 == name.size()) {
+            const std::string arrayName = name.substr(0, bracketPosition);
+            uniforms.push_back(UniformLocation{arrayName, values[1]});
+
+            for (GLint element = 0; element < values[2]; element++)
+                uniforms.push_back(UniformLocation{arrayName + "[" + std::to_string(element) + "]", values[1] + element});
+        }
+        else
+            uniforms.push_back(UniformLocation{name, values[1]});
+    }
+
+    std::sort(uniforms.begin(), uniforms.end(), [](const UniformLocation& left, const UniformLocation& right) { return left.name < right.name; });
+}
+
+void Shader::InsertDefines(std::string& source, const std::vector<std::string>& defines) {
+    if (source.empty() || defines.empty())
+        return;
+
+    // #version must stay the first directive of the source
+    const size_t versionLineEnd = source.find('\n', source.find("#version"));
+    if (versionLineEnd == std::string::npos)
+        throw std::runtime_error("ERROR::SHADER::NO_VERSION_DIRECTIVE");
+
+    std::string defineLines;
+    for (const auto& define : defines)
+        defineLines += "#define " + define + "\n";
+
+    source.insert(versionLineEnd + 1, defineLines);
+}
+
+std::string Shader::ReadSourceFile(const std::string& path) {
+    try {
+        std::string source(VirtualFileSystem::Instance().Open(path).GetText());
+
+        // GLSL has no includes, so each #include "file" line is replaced by that file (relative to the including one) before compilation.
+        // Included files are not scanned for includes themselves
+        static constexpr std::string_view includeDirective = "#include \"";
+        const std::string directory = path.substr(0, path.find_last_of('/') + 1);
+
+        for (size_t position = source.find(includeDirective); position != std::string::npos; position = source.find(includeDirective, position)) {
+            const size_t nameBegin = position + includeDirective.size();
+            const size_t nameEnd = source.find('"', nameBegin);
+            if (nameEnd == std::string::npos)
+                throw std::runtime_error("ERROR::SHADER::UNTERMINATED_INCLUDE " + path);
+
+            const std::string includedPath = directory + source.substr(nameBegin, nameEnd - nameBegin);
+            const std::string included(VirtualFileSystem::Instance().Open(includedPath).GetText());
+            source.replace(position, nameEnd + 1 - position, included);
+            position += included.size();
+        }
+
+        return source;
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ " << path << std::endl;
+    }
+
+    return "";
 }
 
 void Shader::CheckCompileErrors(size_t shader, ShaderType type, const std::string& path) {
@@ -207,6 +311,85 @@ void Shader::CheckCompileErrors(size_t shader, ShaderType type, const std::strin
     }
 }
 
+void Shader::Upload(GLint location, bool value) {
+    Upload(location, static_cast<int>(value));
+}
+
+void Shader::Upload(GLint location, int value) {
+    _callStatistics.uniformCalls++;
+    glUniform1i(location, value);
+}
+
+void Shader::Upload(GLint location, float value) {
+    _callStatistics.uniformCalls++;
+    glUniform1f(location, value);
+}
+
+void Shader::Upload(GLint location, double value) {
+    _callStatistics.uniformCalls++;
+    glUniform1d(location, value);
+}
+
+void Shader::Upload(GLint location, const glm::vec2& value) {
+    _callStatistics.uniformCalls++;
+    glUniform2fv(location, 1, &value[0]);
+}
+
+void Shader::Upload(GLint location, const glm::vec3& value) {
+    _callStatistics.uniformCalls++;
+    glUniform3fv(location, 1, &value[0]);
+}
+
+void Shader::Upload(GLint location, const glm::vec4& value) {
+    _callStatistics.uniformCalls++;
+    glUniform4fv(location, 1, &value[0]);
+}
+
+void Shader::Upload(GLint location, const glm::mat2& value) {
+    _callStatistics.uniformCalls++;
+    glUniformMatrix2fv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+void Shader::Upload(GLint location, const glm::mat3& value) {
+    _callStatistics.uniformCalls++;
+    glUniformMatrix3fv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+void Shader::Upload(GLint location, const glm::mat4& value) {
+    _callStatistics.uniformCalls++;
+    glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+void Shader::Upload(GLint location, const glm::dvec2& value) {
+    _callStatistics.uniformCalls++;
+    glUniform2dv(location, 1, &value[0]);
+}
+
+void Shader::Upload(GLint location, const glm::dvec3& value) {
+    _callStatistics.uniformCalls++;
+    glUniform3dv(location, 1, &value[0]);
+}
+
+void Shader::Upload(GLint location, const glm::dvec4& value) {
+    _callStatistics.uniformCalls++;
+    glUniform4dv(location, 1, &value[0]);
+}
+
+void Shader::Upload(GLint location, const glm::dmat2& value) {
+    _callStatistics.uniformCalls++;
+    glUniformMatrix2dv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+void Shader::Upload(GLint location, const glm::dmat3& value) {
+    _callStatistics.uniformCalls++;
+    glUniformMatrix3dv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+void Shader::Upload(GLint location, const glm::dmat4& value) {
+    _callStatistics.uniformCalls++;
+    glUniformMatrix4dv(location, 1, GL_FALSE, &value[0][0]);
+}
+
 std::string Shader::ShaderTypeToString(ShaderType type) {
     switch(type) {
         case ShaderType::VertexShader: return "Vertex Shader";
@@ -2,39 +2,75 @@
 #define SOLARSYSTEM_SHADER_H
 #include <GL/glew.h>
 #include <glm/glm.hpp>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+// Location of a uniform in the program of the shader which returned it. Uploads through it skip the lookup by name
+template<typename T>
+struct UniformHandle {
+    using ValueType = T;
+    GLint location = -1; // -1 for uniforms which are not active in the program, uploads to it are ignored by GL
+    std::string name; // Looked up again on each upload while the location cache is disabled, as every upload did before the handles
+};
+
+// Copies of a shader share one program. With GL_KHR_parallel_shader_compile the driver compiles programs in the background,
+// so the link status is checked on the first use and not in the constructor. Linked programs are kept in ShaderCache.
+// Locations of all active uniforms are read once after linking, so uploads by name do not call glGetUniformLocation
 class Shader {
 public:
-    explicit Shader(const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath = "");
+    // Each of the defines is inserted after the #version line of every stage, so one source can be built in several variants
+    explicit Shader(const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath = "",
+                    const std::vector<std::string>& defines = {});
     void Use() const;
-    void SetBool(const std::string& name, bool value) const;
-    void SetInt(const std::string& name, int value) const;
-    void SetFloat(const std::string& name, float value) const;
-    void SetDouble(const std::string& name, double value) const;
-    void SetVec2(const std::string& name, const glm::vec2& value) const;
-    void SetVec2(const std::string& name, float x, float y) const;
-    void SetVec3(const std::string& name, const glm::vec3& value) const;
-    void SetVec3(const std::string& name, float x, float y, float z) const;
-    void SetVec4(const std::string& name, const glm::vec4& value) const;
-    void SetVec4(const std::string& name, float x, float y, float z, float w) const;
-    void SetMat2(const std::string& name, const glm::mat2& mat) const;
-    void SetMat3(const std::string& name, const glm::mat3& mat) const;
-    void SetMat4(const std::string& name, const glm::mat4& mat) const;
-    void SetVec2Double(const std::string& name, const glm::dvec2& value) const;
-    void SetVec2Double(const std::string& name, double x, double y) const;
-    void SetVec3Double(const std::string& name, const glm::dvec3& value) const;
-    void SetVec3Double(const std::string& name, double x, double y, double z) const;
-    void SetVec4Double(const std::string& name, const glm::dvec4& value) const;
-    void SetVec4Double(const std::string& name, double x, double y, double z, double w) const;
-    void SetMat2Double(const std::string& name, const glm::dmat2& mat) const;
-    void SetMat3Double(const std::string& name, const glm::dmat3& mat) const;
-    void SetMat4Double(const std::string& name, const glm::dmat4& mat) const;
+    void SetBool(std::string_view name, bool value) const;
+    void SetInt(std::string_view name, int value) const;
+    void SetFloat(std::string_view name, float value) const;
+    void SetDouble(std::string_view name, double value) const;
+    void SetVec2(std::string_view name, const glm::vec2& value) const;
+    void SetVec2(std::string_view name, float x, float y) const;
+    void SetVec3(std::string_view name, const glm::vec3& value) const;
+    void SetVec3(std::string_view name, float x, float y, float z) const;
+    void SetVec4(std::string_view name, const glm::vec4& value) const;
+    void SetVec4(std::string_view name, float x, float y, float z, float w) const;
+    void SetMat2(std::string_view name, const glm::mat2& mat) const;
+    void SetMat3(std::string_view name, const glm::mat3& mat) const;
+    void SetMat4(std::string_view name, const glm::mat4& mat) const;
+    void SetVec2Double(std::string_view name, const glm::dvec2& value) const;
+    void SetVec2Double(std::string_view name, double x, double y) const;
+    void SetVec3Double(std::string_view name, const glm::dvec3& value) const;
+    void SetVec3Double(std::string_view name, double x, double y, double z) const;
+    void SetVec4Double(std::string_view name, const glm::dvec4& value) const;
+    void SetVec4Double(std::string_view name, double x, double y, double z, double w) const;
+    void SetMat2Double(std::string_view name, const glm::dmat2& mat) const;
+    void SetMat3Double(std::string_view name, const glm::dmat3& mat) const;
+    void SetMat4Double(std::string_view name, const glm::dmat4& mat) const;
     size_t GetProgramId() const;
 
+    template<typename T>
+    UniformHandle<T> GetUniformHandle(std::string_view name) const {
+        return UniformHandle<T>{GetUniformLocation(name), std::string(name)};
+    }
+
+    template<typename T>
+    void Set(const UniformHandle<T>& handle, const typename UniformHandle<T>::ValueType& value) const {
+        Upload(_isLocationCacheEnabled ? handle.location : GetUniformLocation(handle.name), value);
+    }
+
+    // GL calls made by all shaders, for the uniform benchmark
+    struct CallStatistics {
+        size_t useProgramCalls = 0, uniformCalls = 0, getUniformLocationCalls = 0;
+    };
+
+    static const CallStatistics& GetCallStatistics();
+    static void ResetCallStatistics();
+    // Disabled, each upload by name or through a handle asks the driver, as before the cache and the handles
+    static void SetLocationCacheEnabled(bool isEnabled);
+
 private:
     enum class ShaderType {
         VertexShader,
@@ -43,8 +79,52 @@ private:
         ShaderProgram
     };
 
-    size_t _shaderProgramID = 0;
+    struct StageInfo {
+        GLuint shaderId;
+        ShaderType type;
+        std::string path;
+    };
+
+    struct UniformLocation {
+        std::string name;
+        GLint location;
+    };
+
+    struct Program {
+        GLuint id = 0;
+        bool isLinked = false;
+        uint64_t cacheKey = 0;
+        std::string name; // Paths of the sources for logs and errors
+        std::vector<StageInfo> stages; // Compiled shaders, until the link status is checked
+        double compileTime = 0.0; // ms
+        std::vector<UniformLocation> uniforms; // Sorted by name
+    };
+
+    std::shared_ptr<Program> _program;
+    static CallStatistics _callStatistics;
+    static bool _isLocationCacheEnabled;
 
+    GLint GetUniformLocation(std::string_view name) const;
+    void FinishLinking() const; // Blocks until the driver has linked the program
+    void ReadUniformLocations() const;
+    static void Upload(GLint location, bool value);
+    static void Upload(GLint location, int value);
+    static void Upload(GLint location, float value);
+    static void Upload(GLint location, double value);
+    static void Upload(GLint location, const glm::vec2& value);
+    static void Upload(GLint location, const glm::vec3& value);
+    static void Upload(GLint location, const glm::vec4& value);
+    static void Upload(GLint location, const glm::mat2& value);
+    static void Upload(GLint location, const glm::mat3& value);
+    static void Upload(GLint location, const glm::mat4& value);
+    static void Upload(GLint location, const glm::dvec2& value);
+    static void Upload(GLint location, const glm::dvec3& value);
+    static void Upload(GLint location, const glm::dvec4& value);
+    static void Upload(GLint location, const glm::dmat2& value);
+    static void Upload(GLint location, const glm::dmat3& value);
+    static void Upload(GLint location, const glm::dmat4& value);
+    static std::string ReadSourceFile(const std::string& path);
+    static void InsertDefines(std::string& source, const std::vector<std::string>& defines);
     static void CheckCompileErrors(size_t shader, ShaderType type, const std::string& path = "");
     static std::string ShaderTypeToString(ShaderType type);
 };
@@ -0,0 +1,147 @@
+#include "ShaderCache.h"
+#include "MappedFile.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    constexpr uint32_t programBinaryMagic = 0x42505353; // "SSPB"
+
+    struct ProgramBinaryHeader {
+        uint32_t magic;
+        GLenum format;
+    };
+
+    uint64_t HashBytes(uint64_t hash, const std::string& bytes) {
+        constexpr uint64_t fnvPrime = 1099511628211ull;
+        for (const char byte : bytes)
+            hash = (hash ^ static_cast<uint8_t>(byte)) * fnvPrime;
+
+        return (hash ^ 0xFF) * fnvPrime; // Separator, so that "ab" + "c" and "a" + "bc" differ
+    }
+
+    std::string GetString(GLenum name) {
+        const auto* value = reinterpret_cast<const char*>(glGetString(name));
+        return value != nullptr ? value : "";
+    }
+}
+
+ShaderCache& ShaderCache::Instance() {
+    static ShaderCache cache;
+    return cache;
+}
+
+ShaderCache::ShaderCache() {
+    _driverString = GetString(GL_VENDOR) + "|" + GetString(GL_RENDERER) + "|" + GetString(GL_VERSION);
+
+    GLint formatsCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatsCount);
+    _isSupported = GLEW_ARB_get_program_binary && formatsCount > 0; // Some drivers expose the API without any format
+
+    if (!_isSupported)
+        std::cout << "Shader cache: program binaries are not supported by the driver, every program is compiled" << std::endl;
+}
+
+uint64_t ShaderCache::CalculateKey(const std::vector<std::string>& sources) const {
+    uint64_t hash = HashBytes(14695981039346656037ull, _driverString);
+    for (const auto& source : sources)
+        hash = HashBytes(hash, source);
+
+    return hash;
+}
+
+GLuint ShaderCache::Load(uint64_t key, const std::string& name) {
+    const std::string filePath = MakeFilePath(key);
+    std::error_code error;
+
+    if (!_isSupported || !std::filesystem::exists(filePath, error)) {
+        _misses++;
+        std::cout << "Shader cache: " << name << " miss" << std::endl;
+        return 0;
+    }
+
+    const auto startPoint = std::chrono::steady_clock::now();
+    GLuint programId = 0;
+
+    try {
+        const MappedFile file(filePath);
+        ProgramBinaryHeader header {};
+
+        if (file.GetSize() > sizeof(header)) {
+            std::memcpy(&header, file.GetData(), sizeof(header));
+
+            if (header.magic == programBinaryMagic) {
+                programId = glCreateProgram();
+                glProgramBinary(programId, header.format, file.GetData() + sizeof(header), static_cast<GLsizei>(file.GetSize() - sizeof(header)));
+
+                GLint isLinked = GL_FALSE;
+                glGetProgramiv(programId, GL_LINK_STATUS, &isLinked);
+                if (!isLinked) {
+                    glDeleteProgram(programId);
+                    programId = 0;
+                }
+            }
+        }
+    }
+    catch (const std::runtime_error& err) {
+        std::cout << err.what() << std::endl;
+    }
+
+    if (programId == 0) {
+        // The driver has changed the binary format without changing its version string, or the file is damaged
+        _rejected++;
+        _misses++;
+        std::filesystem::remove(filePath, error);
+        std::cout << "Shader cache: " << name << " miss (binary rejected)" << std::endl;
+        return 0;
+    }
+
+    const double loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startPoint).count();
+    _loadTime += loadTime;
+    _hits++;
+
+    std::cout << std::fixed << std::setprecision(2) << "Shader cache: " << name << " hit (" << loadTime << " ms)" << std::endl;
+    return programId;
+}
+
+void ShaderCache::Store(uint64_t key, GLuint programId, const std::string& name, double compileTime) {
+    _compileTime += compileTime;
+    std::cout << std::fixed << std::setprecision(2) << "Shader cache: " << name << " compiled (" << compileTime << " ms on the main thread)" << std::endl;
+
+    if (!_isSupported)
+        return;
+
+    GLint binaryLength = 0;
+    glGetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0)
+        return;
+
+    std::vector<char> binary(binaryLength);
+    ProgramBinaryHeader header {programBinaryMagic, 0};
+    glGetProgramBinary(programId, binaryLength, nullptr, &header.format, binary.data());
+
+    std::error_code error;
+    std::filesystem::create_directories(_directory, error);
+
+    std::ofstream file(MakeFilePath(key), std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), binary.size());
+
+    if (!file)
+        std::cout << "Shader cache: cannot write " << MakeFilePath(key) << std::endl;
+}
+
+void ShaderCache::PrintStatistics() const {
+    std::cout << std::fixed << std::setprecision(2) << "Shader programs: " << _hits << " from cache (" << _loadTime << " ms), "
+              << _misses << " compiled (" << _compileTime << " ms on the main thread, " << _rejected << " binaries rejected)" << std::endl;
+}
+
+std::string ShaderCache::MakeFilePath(uint64_t key) const {
+    std::ostringstream filePath;
+    filePath << _directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return filePath.str();
+}
@@ -0,0 +1,28 @@
+#ifndef SOLARSYSTEM_SHADERCACHE_H
+#define SOLARSYSTEM_SHADERCACHE_H
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+
+// On-disk cache of linked program binaries (glGetProgramBinary). The key is a hash of the shader sources and of the driver
+// (vendor, renderer, version), so the cache rebuilds itself after shader edits or a driver update. Used from the GL thread only
+class ShaderCache {
+public:
+    static ShaderCache& Instance();
+    uint64_t CalculateKey(const std::vector<std::string>& sources) const;
+    GLuint Load(uint64_t key, const std::string& name); // Linked program or 0 if the binary is missing or rejected by the driver
+    void Store(uint64_t key, GLuint programId, const std::string& name, double compileTime);
+    void PrintStatistics() const;
+
+private:
+    const std::string _directory = "shader_cache";
+    std::string _driverString;
+    bool _isSupported = false;
+    size_t _hits = 0, _misses = 0, _rejected = 0;
+    double _loadTime = 0.0, _compileTime = 0.0; // Main thread time, ms
+
+    ShaderCache();
+    std::string MakeFilePath(uint64_t key) const;
+};
+
+#endif //SOLARSYSTEM_SHADERCACHE_H
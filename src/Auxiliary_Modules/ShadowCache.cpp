@@ -0,0 +1,66 @@
+#include "ShadowCache.h"
+#include <cmath>
+
+ShadowCache::ShadowCache(size_t layersCount, uint16_t layerSize) : _layers(layersCount), _layerSize(layerSize)
+{
+}
+
+bool ShadowCache::Update(size_t layer, const glm::mat4& lightSpaceMatrix, const std::vector<Caster>& casters, uint32_t refreshInterval) {
+    Layer& cachedLayer = _layers.at(layer);
+
+    if (cachedLayer.isValid && (_frame - cachedLayer.refreshFrame < refreshInterval || !IsMoved(cachedLayer, lightSpaceMatrix, casters))) {
+        _frameStatistics.cachedLayers++;
+        return false;
+    }
+
+    cachedLayer.isValid = true;
+    cachedLayer.lightSpaceMatrix = lightSpaceMatrix;
+    cachedLayer.casters = casters;
+    cachedLayer.refreshFrame = _frame;
+    _frameStatistics.refreshedLayers++;
+    return true;
+}
+
+void ShadowCache::EndFrame() {
+    _lastFrameStatistics = _frameStatistics;
+    _frameStatistics = FrameStatistics();
+    _frame++;
+}
+
+const ShadowCache::FrameStatistics& ShadowCache::GetLastFrameStatistics() const {
+    return _lastFrameStatistics;
+}
+
+bool ShadowCache::IsMoved(const Layer& layer, const glm::mat4& lightSpaceMatrix, const std::vector<Caster>& casters) const {
+    if (layer.lightSpaceMatrix != lightSpaceMatrix || layer.casters.size() != casters.size())
+        return true;
+
+    const float maxShift = MAX_SHIFT_IN_TEXELS * 2.0f / static_cast<float>(_layerSize); // Light clip space spans 2 over the layer
+    const float minRotationCosine = std::cos(glm::radians(MAX_ROTATION_DEGREES));
+
+    for (size_t i = 0; i < casters.size(); i++) {
+        const Caster& cached = layer.casters[i];
+        const Caster& current = casters[i];
+
+        if (cached.level != current.level)
+            return true;
+
+        const glm::vec4 cachedCenter = lightSpaceMatrix * cached.model[3];
+        const glm::vec4 currentCenter = lightSpaceMatrix * current.model[3];
+        if (std::abs(currentCenter.x - cachedCenter.x) > maxShift || std::abs(currentCenter.y - cachedCenter.y) > maxShift)
+            return true;
+
+        if (current.isSphere)
+            continue;
+
+        // The cosine of the angle between the axes of the old and the new orientation
+        for (int axis = 0; axis < 3; axis++) {
+            const glm::vec3 cachedAxis = glm::normalize(glm::vec3(cached.model[axis]));
+            const glm::vec3 currentAxis = glm::normalize(glm::vec3(current.model[axis]));
+            if (glm::dot(cachedAxis, currentAxis) < minRotationCosine)
+                return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,49 @@
+#ifndef SOLARSYSTEM_SHADOWCACHE_H
+#define SOLARSYSTEM_SHADOWCACHE_H
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Decides which layers of the shadow map array are rendered again. A layer keeps the depth of its casters from the last rendering
+// and is refreshed only when one of them moved by more than half a texel of the layer or turned by more than MAX_ROTATION_DEGREES.
+// Spheres are not checked for rotation, their shadow does not change. A moved layer waits for its refresh interval, so small
+// components may lag by a few frames, while the large ones are refreshed every frame they move
+class ShadowCache {
+public:
+    static constexpr float MAX_SHIFT_IN_TEXELS = 0.5f;
+    static constexpr float MAX_ROTATION_DEGREES = 0.25f;
+
+    struct Caster {
+        glm::mat4 model;
+        size_t level; // Of detail, the same position with another tessellation is a new shadow
+        bool isSphere;
+    };
+
+    struct FrameStatistics {
+        size_t refreshedLayers = 0, cachedLayers = 0;
+    };
+
+    ShadowCache(size_t layersCount, uint16_t layerSize);
+    // Returns true if the layer must be rendered this frame, the casters are then remembered as its content
+    bool Update(size_t layer, const glm::mat4& lightSpaceMatrix, const std::vector<Caster>& casters, uint32_t refreshInterval);
+    void EndFrame();
+    const FrameStatistics& GetLastFrameStatistics() const;
+
+private:
+    struct Layer {
+        bool isValid = false;
+        glm::mat4 lightSpaceMatrix = glm::mat4(1.0f);
+        std::vector<Caster> casters;
+        uint64_t refreshFrame = 0;
+    };
+
+    std::vector<Layer> _layers;
+    uint16_t _layerSize;
+    uint64_t _frame = 0;
+    FrameStatistics _frameStatistics, _lastFrameStatistics;
+
+    bool IsMoved(const Layer& layer, const glm::mat4& lightSpaceMatrix, const std::vector<Caster>& casters) const;
+};
+
+#endif //SOLARSYSTEM_SHADOWCACHE_H
@@ -1,6 +1,8 @@
 #include "ShadowMapFBO.h"
 
-ShadowMapFBO::ShadowMapFBO(uint16_t shadowMapWidth, uint16_t shadowMapHeight) : _shadowMapWidth(shadowMapWidth), _shadowMapHeight(shadowMapHeight) {
+ShadowMapFBO::ShadowMapFBO(uint16_t shadowMapWidth, uint16_t shadowMapHeight, uint16_t layersCount, ShadowDepthFormat depthFormat) :
+    _shadowMapWidth(shadowMapWidth), _shadowMapHeight(shadowMapHeight), _layersCount(layersCount), _depthFormat(depthFormat)
+{
     InitFBO();
 }
 
@@ -12,30 +14,63 @@ uint16_t ShadowMapFBO::GetShadowMapHeight() const {
     return _shadowMapHeight;
 }
 
+uint16_t ShadowMapFBO::GetLayersCount() const {
+    return _layersCount;
+}
+
 GLuint ShadowMapFBO::GetShadowMap() const {
     return _shadowMap;
 }
 
+GLuint ShadowMapFBO::GetCompareSampler() const {
+    return _compareSampler;
+}
+
 GLuint ShadowMapFBO::GetFBO() const {
     return _frameBuffer;
 }
 
+void ShadowMapFBO::ClearLayer(uint16_t layer) const {
+    constexpr float farDepth = 1.0f;
+    glClearTexSubImage(_shadowMap, 0, 0, 0, layer, _shadowMapWidth, _shadowMapHeight, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &farDepth);
+}
+
 void ShadowMapFBO::InitFBO() {
     glGenFramebuffers(1, &_frameBuffer);
 
     glGenTextures(1, &_shadowMap);
-    glBindTexture(GL_TEXTURE_2D, _shadowMap);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32, _shadowMapWidth, _shadowMapHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, _shadowMap);
+    // The light frusta are fitted to the components, so 16 bits of depth are usually enough and halve the bandwidth of 32
+    GLenum internalFormat = GL_DEPTH_COMPONENT16;
+    if (_depthFormat == ShadowDepthFormat::Depth24)
+        internalFormat = GL_DEPTH_COMPONENT24;
+    else if (_depthFormat == ShadowDepthFormat::Depth32F)
+        internalFormat = GL_DEPTH_COMPONENT32F;
+
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, internalFormat, _shadowMapWidth, _shadowMapHeight, _layersCount);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
 
     constexpr float borderColor[] = {1.0, 1.0, 1.0, 1.0};
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+
+    // With LINEAR filtering the hardware compares 4 texels and blends the results
+    glGenSamplers(1, &_compareSampler);
+    glSamplerParameteri(_compareSampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glSamplerParameteri(_compareSampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glSamplerParameteri(_compareSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glSamplerParameteri(_compareSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glSamplerParameterfv(_compareSampler, GL_TEXTURE_BORDER_COLOR, borderColor);
+    glSamplerParameteri(_compareSampler, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glSamplerParameteri(_compareSampler, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+    for (uint16_t layer = 0; layer < _layersCount; layer++)
+        ClearLayer(layer);
 
     glBindFramebuffer(GL_FRAMEBUFFER, _frameBuffer);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, _shadowMap, 0);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, _shadowMap, 0); // All layers, gl_Layer picks one
     glDrawBuffer(GL_NONE);
     glReadBuffer(GL_NONE);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -3,17 +3,30 @@
 #include <GL/glew.h>
 #include <vector>
 
+enum class ShadowDepthFormat {
+    Depth16,
+    Depth24,
+    Depth32F
+};
+
+// A layered framebuffer over an array of shadow maps, one layer per scene component. The layers are kept between frames
+// and only those of the moved casters are cleared and rendered again (see ShadowCache)
 class ShadowMapFBO {
 public:
-    explicit ShadowMapFBO(uint16_t shadowMapWidth, uint16_t shadowMapHeight);
+    explicit ShadowMapFBO(uint16_t shadowMapWidth, uint16_t shadowMapHeight, uint16_t layersCount, ShadowDepthFormat depthFormat = ShadowDepthFormat::Depth16);
     uint16_t GetShadowMapWidth() const;
     uint16_t GetShadowMapHeight() const;
-    GLuint GetShadowMap() const;
+    uint16_t GetLayersCount() const;
+    GLuint GetShadowMap() const; // GL_TEXTURE_2D_ARRAY
+    // Sampler object with GL_TEXTURE_COMPARE_MODE for sampler2DArrayShadow. The texture itself returns raw depth
+    GLuint GetCompareSampler() const;
     GLuint GetFBO() const;
+    void ClearLayer(uint16_t layer) const; // glClear would clear all layers of the layered framebuffer
 
 private:
-    uint16_t _shadowMapWidth, _shadowMapHeight;
-    GLuint _shadowMap = 0, _frameBuffer = 0;
+    uint16_t _shadowMapWidth, _shadowMapHeight, _layersCount;
+    ShadowDepthFormat _depthFormat;
+    GLuint _shadowMap = 0, _compareSampler = 0, _frameBuffer = 0;
 
     void InitFBO();
 };
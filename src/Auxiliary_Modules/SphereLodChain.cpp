@@ -0,0 +1,169 @@
+#include "SphereLodChain.h"
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+SphereLodChain::SphereLodChain(MeshHolder sphereModel) : _impostorQuad("generated:impostor_quad", MakeQuad)
+{
+    constexpr float maxSilhouetteError = 0.5f; // Pixels
+    constexpr std::array<size_t, 4> levelSegments = {128, 64, 32, 16};
+
+    _uvMapping = EstimateUvMapping(sphereModel.ReadVertices());
+    _levels.push_back({std::move(sphereModel), std::numeric_limits<float>::max()});
+
+    for (const size_t segments : levelSegments) {
+        const size_t rings = segments / 2;
+        const std::string name = "generated:sphere_" + std::to_string(segments) + "x" + std::to_string(rings);
+        const float maxProjectedRadius = maxSilhouetteError / (1.0f - std::cos(glm::pi<float>() / static_cast<float>(segments))); // Sagitta of a segment
+        _levels.push_back({MeshHolder(name, [this, segments, rings] { return Tessellate(segments, rings, _uvMapping); }), maxProjectedRadius});
+    }
+}
+
+bool SphereLodChain::IsSphere(const MeshHolder& model) const {
+    return model.GetMeshModel() == _levels.front().model.GetMeshModel();
+}
+
+size_t SphereLodChain::SelectLevel(float projectedRadius) const {
+    if (projectedRadius < IMPOSTOR_MAX_PROJECTED_RADIUS)
+        return GetImpostorLevel();
+
+    return SelectMeshLevel(projectedRadius);
+}
+
+size_t SphereLodChain::SelectMeshLevel(float projectedRadius) const {
+    for (size_t level = _levels.size() - 1; level > 0; level--) {
+        if (projectedRadius <= _levels[level].maxProjectedRadius)
+            return level;
+    }
+
+    return 0;
+}
+
+size_t SphereLodChain::GetImpostorLevel() const {
+    return _levels.size();
+}
+
+const MeshHolder& SphereLodChain::GetLevel(size_t level) const {
+    return level < _levels.size() ? _levels[level].model : _impostorQuad;
+}
+
+const SphereUvMapping& SphereLodChain::GetUvMapping() const {
+    return _uvMapping;
+}
+
+void SphereLodChain::PrintStatistics() const {
+    std::cout << std::fixed << std::setprecision(3) << "Sphere LODs: u = fract(" << _uvMapping.uSign << " * longitude / 2pi + " << _uvMapping.uOffset
+              << "), v sign " << _uvMapping.vSign << std::endl;
+
+    for (size_t level = 1; level < _levels.size(); level++) {
+        std::cout << "  " << _levels[level].model.GetPath() << " up to " << std::setprecision(0) << _levels[level].maxProjectedRadius << " px"
+                  << std::setprecision(3) << std::endl;
+    }
+
+    std::cout << "  Impostors below " << std::setprecision(0) << IMPOSTOR_MAX_PROJECTED_RADIUS << " px" << std::endl;
+}
+
+float SphereLodChain::CalculateProjectedRadius(float radius, float distance, const glm::mat4& projection, float viewportHeight) {
+    return radius * projection[1][1] * 0.5f * viewportHeight / std::max(distance, radius); // projection[1][1] = 1 / tan(fovy / 2)
+}
+
+SphereUvMapping SphereLodChain::EstimateUvMapping(const std::vector<Vertex>& vertices) {
+    // For the right direction of u, the phase 2pi * u - sign * longitude is the same for all vertices, so its circular mean
+    // is the longest one. The sign of v follows from its correlation with the latitude
+    std::array<glm::dvec2, 2> phaseSums = {glm::dvec2(0.0), glm::dvec2(0.0)};
+    double latitudeCorrelation = 0.0;
+
+    for (const auto& vertex : vertices) {
+        const glm::vec3 direction = glm::normalize(vertex.position);
+        latitudeCorrelation += (0.5 - vertex.textureCoords.y) * std::asin(glm::clamp(direction.y, -1.0f, 1.0f));
+
+        if (std::abs(direction.y) > 0.99f) // The longitude is undefined at the poles
+            continue;
+
+        const double longitude = std::atan2(-direction.z, direction.x);
+        for (size_t i = 0; i < phaseSums.size(); i++) {
+            const double phase = glm::two_pi<double>() * vertex.textureCoords.x - (i == 0 ? longitude : -longitude);
+            phaseSums[i] += glm::dvec2(std::cos(phase), std::sin(phase));
+        }
+    }
+
+    const size_t sign = glm::length(phaseSums[0]) >= glm::length(phaseSums[1]) ? 0 : 1;
+    const double offset = std::atan2(phaseSums[sign].y, phaseSums[sign].x) / glm::two_pi<double>();
+
+    SphereUvMapping uvMapping;
+    uvMapping.uSign = sign == 0 ? 1.0f : -1.0f;
+    uvMapping.uOffset = static_cast<float>(offset - std::floor(offset));
+    uvMapping.vSign = latitudeCorrelation >= 0.0 ? 1.0f : -1.0f;
+    return uvMapping;
+}
+
+MeshData SphereLodChain::Tessellate(size_t segments, size_t rings, const SphereUvMapping& uvMapping) {
+    MeshData meshData;
+    meshData.vertices.reserve((segments + 1) * (rings + 1));
+
+    // The column with u = 1 duplicates the one with u = 0, so the seam has the same texture coordinates as in the model
+    for (size_t ring = 0; ring <= rings; ring++) {
+        const float v = static_cast<float>(ring) / static_cast<float>(rings);
+        const float latitude = uvMapping.vSign * (0.5f - v) * glm::pi<float>();
+
+        for (size_t segment = 0; segment <= segments; segment++) {
+            const float u = static_cast<float>(segment) / static_cast<float>(segments);
+            const float longitude = uvMapping.uSign * (u - uvMapping.uOffset) * glm::two_pi<float>();
+            const glm::vec3 direction(std::cos(latitude) * std::cos(longitude), std::sin(latitude), -std::cos(latitude) * std::sin(longitude));
+
+            Vertex vertex {};
+            vertex.position = direction * SPHERE_MODEL_RADIUS;
+            vertex.normal = direction;
+            vertex.textureCoords = glm::vec2(u, v);
+            vertex.tangent = uvMapping.uSign * glm::vec3(-std::sin(longitude), 0.0f, -std::cos(longitude)); // Along u
+            vertex.bitangent = -uvMapping.vSign * glm::vec3(-std::sin(latitude) * std::cos(longitude), std::cos(latitude),
+                                                            std::sin(latitude) * std::sin(longitude)); // Along v
+            meshData.vertices.push_back(vertex);
+        }
+    }
+
+    const auto addTriangle = [&meshData](uint32_t a, uint32_t b, uint32_t c) {
+        const glm::vec3& pa = meshData.vertices[a].position;
+        const glm::vec3 normal = glm::cross(meshData.vertices[b].position - pa, meshData.vertices[c].position - pa);
+
+        if (glm::dot(normal, normal) < 1e-12f) // Collapsed at a pole
+            return;
+
+        if (glm::dot(normal, pa) < 0.0f) // Counter-clockwise from the outside, whatever the directions of u and v are
+            std::swap(b, c);
+
+        meshData.indices.insert(meshData.indices.end(), {a, b, c});
+    };
+
+    for (size_t ring = 0; ring < rings; ring++) {
+        for (size_t segment = 0; segment < segments; segment++) {
+            const auto topLeft = static_cast<uint32_t>(ring * (segments + 1) + segment);
+            const auto bottomLeft = static_cast<uint32_t>(topLeft + segments + 1);
+            addTriangle(topLeft, bottomLeft, bottomLeft + 1);
+            addTriangle(topLeft, bottomLeft + 1, topLeft + 1);
+        }
+    }
+
+    return meshData;
+}
+
+MeshData SphereLodChain::MakeQuad() {
+    // Corners in xy, the vertex shader of the impostor turns the quad to the camera and sizes it by the sphere
+    MeshData meshData;
+    for (const glm::vec2 corner : {glm::vec2(-1.0f, -1.0f), glm::vec2(1.0f, -1.0f), glm::vec2(1.0f, 1.0f), glm::vec2(-1.0f, 1.0f)}) {
+        Vertex vertex {};
+        vertex.position = glm::vec3(corner, 0.0f);
+        vertex.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+        vertex.textureCoords = corner * 0.5f + 0.5f;
+        vertex.tangent = glm::vec3(1.0f, 0.0f, 0.0f);
+        vertex.bitangent = glm::vec3(0.0f, 1.0f, 0.0f);
+        meshData.vertices.push_back(vertex);
+    }
+
+    meshData.indices = {0, 1, 2, 0, 2, 3};
+    return meshData;
+}
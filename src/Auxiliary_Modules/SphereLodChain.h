@@ -0,0 +1,46 @@
+#ifndef SOLARSYSTEM_SPHERELODCHAIN_H
+#define SOLARSYSTEM_SPHERELODCHAIN_H
+#include "MeshHolder.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+// Texture mapping of a UV sphere: u = fract(uSign * longitude / 2pi + uOffset), v = 0.5 - vSign * latitude / pi,
+// where longitude = atan2(-z, x) and latitude = asin(y) of the direction from the center in model space
+struct SphereUvMapping {
+    float uSign = 1.0f, uOffset = 0.0f, vSign = 1.0f;
+};
+
+// Levels of detail of the sphere model, picked by the projected radius of a body. Level 0 is the model itself, the coarser ones are
+// tessellated with the same texture mapping, so switching between them changes the silhouette by less than half a pixel.
+// Below IMPOSTOR_MAX_PROJECTED_RADIUS a body is a camera facing quad, which is ray traced in planetLighting.fs (IMPOSTOR variant)
+class SphereLodChain {
+public:
+    static constexpr float SPHERE_MODEL_RADIUS = 2.0f; // Radius of the earth 3d model in Blender
+    static constexpr float IMPOSTOR_MAX_PROJECTED_RADIUS = 24.0f; // Pixels
+
+    explicit SphereLodChain(MeshHolder sphereModel);
+    bool IsSphere(const MeshHolder& model) const;
+    size_t SelectLevel(float projectedRadius) const; // GetImpostorLevel() for small bodies
+    size_t SelectMeshLevel(float projectedRadius) const; // Never an impostor, e.g. for shadow casters
+    size_t GetImpostorLevel() const;
+    const MeshHolder& GetLevel(size_t level) const; // The quad for the impostor level
+    const SphereUvMapping& GetUvMapping() const;
+    void PrintStatistics() const;
+    static float CalculateProjectedRadius(float radius, float distance, const glm::mat4& projection, float viewportHeight); // Pixels
+
+private:
+    struct Level {
+        MeshHolder model;
+        float maxProjectedRadius; // Above it the silhouette deviates from the sphere by more than half a pixel
+    };
+
+    std::vector<Level> _levels;
+    MeshHolder _impostorQuad;
+    SphereUvMapping _uvMapping;
+
+    static SphereUvMapping EstimateUvMapping(const std::vector<Vertex>& vertices); // From the texture coordinates of the model
+    static MeshData Tessellate(size_t segments, size_t rings, const SphereUvMapping& uvMapping);
+    static MeshData MakeQuad();
+};
+
+#endif //SOLARSYSTEM_SPHERELODCHAIN_H
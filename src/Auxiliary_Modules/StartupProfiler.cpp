@@ -0,0 +1,203 @@
+#include "StartupProfiler.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr double bytesInMegabyte = 1024.0 * 1024.0;
+
+    std::string EscapeJson(const std::string& text) {
+        std::string escaped;
+        escaped.reserve(text.size());
+
+        for (const char c : text) {
+            if (c == '"' || c == '\\')
+                escaped += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20)
+                escaped += c;
+        }
+
+        return escaped;
+    }
+}
+
+StartupProfiler& StartupProfiler::Instance() {
+    static StartupProfiler profiler;
+    return profiler;
+}
+
+void StartupProfiler::Finish(const std::string& tracePath) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isRecording = false;
+    }
+
+    WriteTrace(tracePath);
+    PrintSummary();
+}
+
+bool StartupProfiler::IsRecording() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _isRecording;
+}
+
+void StartupProfiler::AddEvent(Event event) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_isRecording)
+        _events.push_back(std::move(event));
+}
+
+double StartupProfiler::GetTime() const {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - _startPoint).count();
+}
+
+int64_t StartupProfiler::GetGpuUsedBytes() const {
+    if (std::this_thread::get_id() != _mainThreadId || !GLEW_NVX_gpu_memory_info)
+        return -1;
+
+    GLint totalKilobytes = 0, availableKilobytes = 0;
+    glGetIntegerv(GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX, &totalKilobytes);
+    glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &availableKilobytes);
+    return (static_cast<int64_t>(totalKilobytes) - availableKilobytes) * 1024;
+}
+
+void StartupProfiler::WriteTrace(const std::string& tracePath) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::ofstream trace(tracePath, std::ios::trunc);
+    if (!trace) {
+        std::cout << "Cannot write startup trace " << tracePath << std::endl;
+        return;
+    }
+
+    trace << std::fixed << std::setprecision(3) << "{\"traceEvents\":[\n";
+
+    for (size_t i = 0; i < _events.size(); i++) {
+        const auto& event = _events[i];
+        trace << "{\"name\":\"" << EscapeJson(event.name) << "\",\"cat\":\"" << EscapeJson(event.category) << "\",\"ph\":\"X\",\"ts\":" << event.start
+              << ",\"dur\":" << event.duration << ",\"pid\":1,\"tid\":" << std::hash<std::thread::id>()(event.threadId) % 100000
+              << ",\"args\":{\"rssDeltaKB\":" << event.rssDelta / 1024;
+
+        if (event.gpuDelta >= 0)
+            trace << ",\"gpuKB\":" << event.gpuDelta / 1024;
+
+        trace << "}}" << (i + 1 < _events.size() ? ",\n" : "\n");
+    }
+
+    trace << "],\"displayTimeUnit\":\"ms\"}\n";
+    std::cout << "Startup trace is written to " << tracePath << std::endl;
+}
+
+void StartupProfiler::PrintSummary() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    struct CategoryTotal {
+        size_t count = 0;
+        double duration = 0.0;
+        int64_t rssDelta = 0, gpuDelta = 0;
+    };
+
+    std::map<std::string, CategoryTotal> totals;
+    for (const auto& event : _events) {
+        auto& total = totals[event.category];
+        total.count++;
+        total.duration += event.duration;
+        total.rssDelta += event.rssDelta;
+        total.gpuDelta += std::max<int64_t>(event.gpuDelta, 0);
+    }
+
+    // Stage and system scopes contain the asset scopes, so their rows overlap with the others
+    std::cout << std::fixed << std::setprecision(2) << "Startup: " << GetTime() / 1000.0 << " ms, peak RSS " << GetPeakRss() / bytesInMegabyte << " MB\n"
+              << std::left << std::setw(16) << "Category" << std::right << std::setw(8) << "Count" << std::setw(14) << "Time, ms"
+              << std::setw(14) << "RSS, MB" << std::setw(14) << "GPU, MB" << "\n";
+
+    for (const auto& [category, total] : totals) {
+        std::cout << std::left << std::setw(16) << category << std::right << std::setw(8) << total.count << std::setw(14) << total.duration / 1000.0
+                  << std::setw(14) << total.rssDelta / bytesInMegabyte << std::setw(14) << total.gpuDelta / bytesInMegabyte << "\n";
+    }
+
+    // The slowest single loads are the candidates for the critical path. Nested scopes (e.g. InitScene) are in the trace
+    std::vector<const Event*> slowestEvents;
+    for (const auto& event : _events)
+        slowestEvents.push_back(&event);
+
+    constexpr size_t slowestCount = 15;
+    const size_t shownCount = std::min<size_t>(slowestCount, slowestEvents.size()); // Explicit type, min is a macro in windows.h
+    std::partial_sort(slowestEvents.begin(), slowestEvents.begin() + shownCount, slowestEvents.end(),
+                      [](const Event* left, const Event* right) { return left->duration > right->duration; });
+
+    std::cout << "Slowest scopes:\n";
+    for (size_t i = 0; i < shownCount; i++) {
+        const auto& event = *slowestEvents[i];
+        std::cout << "  " << std::right << std::setw(10) << event.duration / 1000.0 << " ms  RSS " << std::setw(8) << event.rssDelta / bytesInMegabyte
+                  << " MB  " << event.category << " " << event.name << "\n";
+    }
+
+    std::cout << std::flush;
+}
+
+size_t StartupProfiler::GetRss() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters {};
+    return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.WorkingSetSize : 0;
+#else
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages = 0, residentPages = 0;
+    statm >> totalPages >> residentPages;
+    return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+size_t StartupProfiler::GetPeakRss() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters {};
+    return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.PeakWorkingSetSize : 0;
+#else
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+ProfileScope::ProfileScope(std::string category, std::string name) : _isRecording(StartupProfiler::Instance().IsRecording()) {
+    if (!_isRecording)
+        return;
+
+    auto& profiler = StartupProfiler::Instance();
+    _category = std::move(category);
+    _name = std::move(name);
+    _rss = StartupProfiler::GetRss();
+    _gpuUsed = profiler.GetGpuUsedBytes();
+    _start = profiler.GetTime();
+}
+
+ProfileScope::~ProfileScope() {
+    if (!_isRecording)
+        return;
+
+    auto& profiler = StartupProfiler::Instance();
+    const double end = profiler.GetTime();
+    int64_t gpuDelta = _gpuBytes;
+
+    if (gpuDelta < 0 && _gpuUsed >= 0) {
+        const int64_t gpuUsed = profiler.GetGpuUsedBytes();
+        gpuDelta = gpuUsed >= 0 ? std::max<int64_t>(gpuUsed - _gpuUsed, 0) : -1;
+    }
+
+    profiler.AddEvent(StartupProfiler::Event{std::move(_category), std::move(_name), _start, end - _start, std::this_thread::get_id(),
+                                             static_cast<int64_t>(StartupProfiler::GetRss()) - static_cast<int64_t>(_rss), gpuDelta});
+}
+
+void ProfileScope::SetGpuBytes(size_t gpuBytes) {
+    _gpuBytes = static_cast<int64_t>(gpuBytes);
+}
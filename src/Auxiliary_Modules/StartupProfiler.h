@@ -0,0 +1,65 @@
+#ifndef SOLARSYSTEM_STARTUPPROFILER_H
+#define SOLARSYSTEM_STARTUPPROFILER_H
+#include <GL/glew.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Collects timed scopes of the startup (systems, scene, every asset load) with their CPU RSS and GPU memory deltas.
+// Finish() writes a Chrome trace (chrome://tracing or https://ui.perfetto.dev) and prints a summary table. After that
+// scopes are not recorded anymore. Scopes can be opened on any thread, GPU memory is queried on the main thread only,
+// which is the thread of the first Instance() call
+class StartupProfiler {
+public:
+    static StartupProfiler& Instance();
+    void Finish(const std::string& tracePath);
+    bool IsRecording() const;
+
+private:
+    friend class ProfileScope;
+
+    struct Event {
+        std::string category, name;
+        double start, duration; // Microseconds from the start of the profiler
+        std::thread::id threadId;
+        int64_t rssDelta; // Bytes
+        int64_t gpuDelta; // Bytes, -1 if unknown
+    };
+
+    const std::chrono::steady_clock::time_point _startPoint = std::chrono::steady_clock::now();
+    const std::thread::id _mainThreadId = std::this_thread::get_id();
+    mutable std::mutex _mutex;
+    std::vector<Event> _events;
+    bool _isRecording = true;
+
+    StartupProfiler() = default;
+    void AddEvent(Event event);
+    double GetTime() const; // Microseconds from the start of the profiler
+    int64_t GetGpuUsedBytes() const; // -1 if the driver cannot tell (only GL_NVX_gpu_memory_info is supported)
+    void WriteTrace(const std::string& tracePath) const;
+    void PrintSummary() const;
+    static size_t GetRss();
+    static size_t GetPeakRss();
+};
+
+// Records the time between its construction and destruction. GPU allocation comes from the driver, or from SetGpuBytes()
+// if the scope knows what it has uploaded (e.g. size of a texture)
+class ProfileScope {
+public:
+    explicit ProfileScope(std::string category, std::string name);
+    ~ProfileScope();
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+    void SetGpuBytes(size_t gpuBytes);
+
+private:
+    bool _isRecording;
+    std::string _category, _name;
+    double _start = 0.0;
+    size_t _rss = 0;
+    int64_t _gpuUsed = -1, _gpuBytes = -1;
+};
+
+#endif //SOLARSYSTEM_STARTUPPROFILER_H
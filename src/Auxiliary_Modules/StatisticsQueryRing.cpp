@@ -0,0 +1,52 @@
+#include "StatisticsQueryRing.h"
+
+StatisticsQueryRing::StatisticsQueryRing(GLenum target, uint8_t queriesCount) : _target(target), _queries(queriesCount) {
+    for (auto& query : _queries)
+        glGenQueries(1, &query.query);
+}
+
+StatisticsQueryRing::~StatisticsQueryRing() {
+    for (const auto& query : _queries)
+        glDeleteQueries(1, &query.query);
+}
+
+void StatisticsQueryRing::Begin() {
+    glBeginQuery(_target, _queries[_currentQuery].query);
+    _isIssued = true;
+}
+
+void StatisticsQueryRing::End() {
+    glEndQuery(_target);
+}
+
+void StatisticsQueryRing::EndFrame() {
+    if (!_isIssued)
+        return;
+
+    _queries[_currentQuery].isPending = true;
+    _currentQuery = (_currentQuery + 1) % _queries.size();
+    _isIssued = false;
+}
+
+bool StatisticsQueryRing::ReadResult(uint64_t& result) {
+    bool isRead = false;
+
+    for (size_t i = 0; i < _queries.size(); i++) { // From the oldest query to the newest one
+        Query& query = _queries[(_currentQuery + i) % _queries.size()];
+        if (!query.isPending)
+            continue;
+
+        GLuint isAvailable = GL_FALSE;
+        glGetQueryObjectuiv(query.query, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+        if (!isAvailable)
+            break;
+
+        GLuint64 value = 0;
+        glGetQueryObjectui64v(query.query, GL_QUERY_RESULT, &value);
+        result = value;
+        query.isPending = false;
+        isRead = true;
+    }
+
+    return isRead;
+}
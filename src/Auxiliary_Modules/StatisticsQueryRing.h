@@ -0,0 +1,34 @@
+#ifndef SOLARSYSTEM_STATISTICSQUERYRING_H
+#define SOLARSYSTEM_STATISTICSQUERYRING_H
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One counter query per frame in flight (GL_FRAGMENT_SHADER_INVOCATIONS_ARB, GL_TIME_ELAPSED, ...), read back like OcclusionQueryRing
+// only once its result is available. A query can be begun once per frame, so it should enclose one contiguous section of the frame
+class StatisticsQueryRing {
+public:
+    StatisticsQueryRing(GLenum target, uint8_t queriesCount);
+    StatisticsQueryRing(const StatisticsQueryRing&) = delete;
+    StatisticsQueryRing& operator=(const StatisticsQueryRing&) = delete;
+    ~StatisticsQueryRing();
+
+    void Begin();
+    void End();
+    void EndFrame();
+    bool ReadResult(uint64_t& result); // The newest available result, false if none arrived since the last call
+
+private:
+    struct Query {
+        GLuint query = 0;
+        bool isPending = false;
+    };
+
+    GLenum _target;
+    std::vector<Query> _queries;
+    size_t _currentQuery = 0;
+    bool _isIssued = false;
+};
+
+#endif //SOLARSYSTEM_STATISTICSQUERYRING_H
@@ -1,6 +1,9 @@
 #include "TextRenderer.h"
+#include "StartupProfiler.h"
+#include "VirtualFileSystem.h"
 
 TextRenderer::TextRenderer(FT_Library ft, const std::string& fontPath) : _ft(ft){
+    ProfileScope profileScope("font", fontPath);
     LoadFont(fontPath);
     InitBuffers();
 }
@@ -184,8 +187,9 @@ void TextRenderer::ReverseRender(const Shader& shader, const std::deque<std::wst
 }
 
 void TextRenderer::LoadFont(const std::string& fontPath) {
+    const AssetFile fontFile = VirtualFileSystem::Instance().Open(fontPath); // FreeType reads it until FT_Done_Face
     FT_Face face;
-    if (FT_New_Face(_ft, fontPath.c_str(), 0, &face))
+    if (FT_New_Memory_Face(_ft, fontFile.GetData(), static_cast<FT_Long>(fontFile.GetSize()), 0, &face))
         throw std::runtime_error("ERROR::FREETYPE: Failed to load font " + fontPath);
 
     FT_Set_Pixel_Sizes(face, 0, 48);
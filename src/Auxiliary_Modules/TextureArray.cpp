@@ -0,0 +1,189 @@
+#include "TextureArray.h"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+bool TextureArray::Format::operator<(const Format& other) const {
+    return std::tie(width, height, internalFormat, levelsCount) < std::tie(other.width, other.height, other.internalFormat, other.levelsCount);
+}
+
+TextureArray::TextureArray(const Format& format) : _format(format) {
+    Reallocate(4);
+}
+
+TextureArray::~TextureArray() {
+    glDeleteTextures(1, &_texture);
+}
+
+GLint TextureArray::AddLayer(const TextureImage2D& texture) {
+    const Format format = GetFormat(texture);
+    if (format < _format || _format < format)
+        throw std::runtime_error("Texture " + std::to_string(texture.GetTexture()) + " does not match the format of the texture array");
+
+    auto freeLayer = std::find_if(_layers.begin(), _layers.end(), [](const Layer& layer) { return layer.source.GetTexture() == 0; });
+    if (freeLayer == _layers.end()) {
+        _layers.emplace_back();
+        freeLayer = _layers.end() - 1;
+    }
+
+    const auto layerIndex = static_cast<GLint>(freeLayer - _layers.begin());
+    if (_layers.size() > _capacity)
+        Reallocate(_capacity * 2);
+
+    // The levels which the texture has are copied, the more detailed ones which TextureStreamer did not upload yet come from its file
+    auto& layer = _layers[layerIndex];
+    auto& storage = *texture._storage;
+    for (GLint level = storage.residentLevel; level < _format.levelsCount; level++) {
+        const auto width = static_cast<GLsizei>(std::max(_format.width >> level, 1u));
+        const auto height = static_cast<GLsizei>(std::max(_format.height >> level, 1u));
+        glCopyImageSubData(storage.textureID, GL_TEXTURE_2D, level, 0, 0, 0, _texture, GL_TEXTURE_2D_ARRAY, level, 0, 0, layerIndex, width, height, 1);
+    }
+
+    layer.source = texture;
+    layer.topLevel = storage.residentLevel;
+    layer.image = storage.residentLevel > 0 ? storage.source : nullptr;
+    if (_layerBytes == 0)
+        _layerBytes = storage.source ? storage.source->GetPayloadSize() : storage.sizeInBytes;
+
+    ReleaseSource(storage);
+    UpdateBaseLevel();
+    return layerIndex;
+}
+
+void TextureArray::Update() {
+    // One level per frame, like TextureStreamer, so that the upload of a moon system is spread over frames
+    auto pendingLayer = _layers.end();
+    for (auto layerIt = _layers.begin(); layerIt != _layers.end(); ++layerIt) {
+        if (layerIt->image && (pendingLayer == _layers.end() || layerIt->topLevel > pendingLayer->topLevel))
+            pendingLayer = layerIt;
+    }
+
+    if (pendingLayer == _layers.end())
+        return;
+
+    pendingLayer->topLevel--;
+    pendingLayer->image->UploadLayerLevel(_texture, static_cast<GLint>(pendingLayer - _layers.begin()), pendingLayer->topLevel);
+    if (pendingLayer->topLevel == 0)
+        pendingLayer->image.reset();
+
+    UpdateBaseLevel();
+}
+
+std::vector<GLuint> TextureArray::ReleaseUnusedLayers() {
+    std::vector<GLuint> releasedTextures;
+
+    for (auto& layer : _layers) {
+        if (layer.source.GetTexture() != 0 && layer.source._storage.use_count() == 1) {
+            releasedTextures.push_back(layer.source.GetTexture());
+            layer = Layer();
+        }
+    }
+
+    if (!releasedTextures.empty())
+        UpdateBaseLevel();
+
+    return releasedTextures;
+}
+
+GLuint TextureArray::GetTexture() const {
+    return _texture;
+}
+
+size_t TextureArray::GetLayersCount() const {
+    return std::count_if(_layers.begin(), _layers.end(), [](const Layer& layer) { return layer.source.GetTexture() != 0; });
+}
+
+size_t TextureArray::GetSizeInBytes() const {
+    return _capacity * _layerBytes;
+}
+
+TextureArray::Format TextureArray::GetFormat(const TextureImage2D& texture) {
+    const auto& storage = *texture._storage;
+    Format format;
+    format.width = storage.width;
+    format.height = storage.height;
+
+    GLint internalFormat = 0;
+    glGetTextureLevelParameteriv(storage.textureID, storage.residentLevel, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+    format.internalFormat = static_cast<GLenum>(internalFormat);
+
+    // Streamed textures end at the last level of their file, the others at the last level glGenerateMipmap made
+    GLint isImmutable = GL_FALSE;
+    glGetTextureParameteriv(storage.textureID, GL_TEXTURE_IMMUTABLE_FORMAT, &isImmutable);
+    if (isImmutable == GL_TRUE)
+        glGetTextureParameteriv(storage.textureID, GL_TEXTURE_IMMUTABLE_LEVELS, &format.levelsCount);
+    else {
+        GLint maxLevel = 0;
+        glGetTextureParameteriv(storage.textureID, GL_TEXTURE_MAX_LEVEL, &maxLevel);
+        format.levelsCount = std::min(maxLevel, static_cast<GLint>(std::log2(std::max(storage.width, storage.height)))) + 1;
+    }
+
+    return format;
+}
+
+void TextureArray::Reallocate(size_t capacity) {
+    GLuint texture = 0;
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &texture);
+    glTextureStorage3D(texture, _format.levelsCount, _format.internalFormat, static_cast<GLsizei>(_format.width), static_cast<GLsizei>(_format.height),
+                       static_cast<GLsizei>(capacity));
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameterf(texture, GL_TEXTURE_MAX_ANISOTROPY_EXT, 16);
+
+    // The sources of the layers have no levels anymore, so the layers are copied from the previous storage
+    if (_texture != 0) {
+        for (GLint level = 0; level < _format.levelsCount; level++) {
+            const auto width = static_cast<GLsizei>(std::max(_format.width >> level, 1u));
+            const auto height = static_cast<GLsizei>(std::max(_format.height >> level, 1u));
+            glCopyImageSubData(_texture, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, texture, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, width, height,
+                               static_cast<GLsizei>(_capacity));
+        }
+
+        glDeleteTextures(1, &_texture);
+    }
+
+    _texture = texture;
+    _capacity = capacity;
+    _baseLevel = 0;
+    UpdateBaseLevel();
+}
+
+void TextureArray::ReleaseSource(TextureImage2D::Storage& storage) const {
+    // Bodies with texture arrays are drawn only by InstanceBatcher, so nothing samples the texture itself. The name stays, as the layer is found by it
+    GLint boundTexture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+    glBindTexture(GL_TEXTURE_2D, storage.textureID);
+
+    if (storage.source) {
+        for (GLint level = storage.residentLevel; level < _format.levelsCount; level++)
+            storage.source->ReleaseLevel(GL_TEXTURE_2D, level);
+    } else {
+        GLint isCompressed = GL_FALSE;
+        glGetTextureLevelParameteriv(storage.textureID, 0, GL_TEXTURE_COMPRESSED, &isCompressed);
+
+        for (GLint level = 0; level < _format.levelsCount; level++) {
+            if (isCompressed == GL_TRUE)
+                glCompressedTexImage2D(GL_TEXTURE_2D, level, _format.internalFormat, 0, 0, 0, 0, nullptr);
+            else
+                glTexImage2D(GL_TEXTURE_2D, level, static_cast<GLint>(_format.internalFormat), 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, boundTexture);
+    storage.isInArray = true;
+}
+
+void TextureArray::UpdateBaseLevel() {
+    GLint baseLevel = 0;
+    for (const auto& layer : _layers) {
+        if (layer.source.GetTexture() != 0)
+            baseLevel = std::max(baseLevel, layer.topLevel);
+    }
+
+    if (baseLevel != _baseLevel) {
+        glTextureParameteri(_texture, GL_TEXTURE_BASE_LEVEL, baseLevel);
+        _baseLevel = baseLevel;
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef SOLARSYSTEM_TEXTUREARRAY_H
+#define SOLARSYSTEM_TEXTUREARRAY_H
+#include "TextureImage2D.h"
+#include <vector>
+
+// 2D textures with the same size, format and mip chain as layers of one GL_TEXTURE_2D_ARRAY, so that bodies which use them
+// can be drawn with one instanced call. The storage always has the whole chain. A texture is moved into its layer: the levels
+// it has are copied on the GPU and its own memory is freed (TextureStreamer forgets it), the more detailed levels are uploaded
+// by Update from its DDS file. The base level of the array is the least detailed of the top levels of its layers
+class TextureArray {
+public:
+    struct Format {
+        GLuint width = 0, height = 0;
+        GLenum internalFormat = 0;
+        GLint levelsCount = 0;
+
+        bool operator<(const Format& other) const;
+    };
+
+    explicit TextureArray(const Format& format);
+    ~TextureArray();
+    TextureArray(const TextureArray&) = delete;
+    TextureArray& operator=(const TextureArray&) = delete;
+    GLint AddLayer(const TextureImage2D& texture); // The texture must have the format of the array and must not be sampled by itself anymore, returns the layer
+    void Update(); // Uploads one missing level, of the layer with the least detailed top level
+    std::vector<GLuint> ReleaseUnusedLayers(); // Frees the layers whose textures are kept only by the array, returns the released textures
+    GLuint GetTexture() const;
+    size_t GetLayersCount() const;
+    size_t GetSizeInBytes() const;
+    static Format GetFormat(const TextureImage2D& texture);
+
+private:
+    struct Layer {
+        TextureImage2D source; // Empty for a free layer. Has no levels, it is kept to know when the bodies stop using the layer
+        std::shared_ptr<const DDSImage> image; // Of the levels still to upload, released when the layer is complete
+        GLint topLevel = 0; // The most detailed level in the array
+    };
+
+    Format _format;
+    GLuint _texture = 0;
+    GLint _baseLevel = 0;
+    std::vector<Layer> _layers;
+    size_t _capacity = 0, _layerBytes = 0;
+
+    void Reallocate(size_t capacity); // The layers are copied from the previous storage
+    void ReleaseSource(TextureImage2D::Storage& storage) const;
+    void UpdateBaseLevel();
+};
+
+#endif //SOLARSYSTEM_TEXTUREARRAY_H
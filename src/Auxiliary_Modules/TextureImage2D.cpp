@@ -1,41 +1,101 @@
 #include "TextureImage2D.h"
+#include "StartupProfiler.h"
 
 TextureImage2D::TextureImage2D(const std::string& path, GLint wrapParam, GLint minFilter, GLint magFilter) {
     LoadTextureFromFile(path, wrapParam, minFilter, magFilter);
 }
 
+TextureImage2D::TextureImage2D(const DDSImage& image, GLint wrapParam, GLint minFilter, GLint magFilter) {
+    UploadTexture(image, wrapParam, minFilter, magFilter);
+}
+
+TextureImage2D::TextureImage2D(std::shared_ptr<const DDSImage> image, GLint firstLevel, GLint wrapParam, GLint minFilter, GLint magFilter) {
+    UploadTexture(*image, wrapParam, minFilter, magFilter, firstLevel);
+    _storage->source = std::move(image);
+}
+
+TextureImage2D::TextureImage2D(std::shared_ptr<Storage> storage) : _storage(std::move(storage))
+{
+}
+
+TextureImage2D::Storage::~Storage() {
+    glDeleteTextures(1, &textureID);
+}
+
+size_t TextureImage2D::Storage::CalculateResidentBytes() const {
+    if (isInArray)
+        return 0;
+
+    return source ? CalculateBytesFromLevel(residentLevel) : sizeInBytes;
+}
+
+size_t TextureImage2D::Storage::CalculateBytesFromLevel(GLint firstLevel) const {
+    size_t levelsBytes = 0;
+    const auto& mipLevels = source->GetMipLevels();
+    for (size_t i = firstLevel; i < mipLevels.size(); i++)
+        levelsBytes += mipLevels[i].size;
+
+    return levelsBytes;
+}
+
 void TextureImage2D::LoadTextureFromFile(const std::string& path, GLint wrapParam, GLint minFilter, GLint magFilter) {
-    glGenTextures(1, &_textureID);
-    glBindTexture(GL_TEXTURE_2D, _textureID);
+    ProfileScope profileScope("texture", path);
+    std::unique_ptr<DDSImage> image;
 
     try {
-        CDDSImage image;
-        image.load(path, false);
-        image.upload_texture2D();
-        _width = image.get_width();
-        _height = image.get_height();
+        image = std::make_unique<DDSImage>(path);
     }
     catch (const std::runtime_error& error) {
         throw std::runtime_error("Image " + path + " cannot be loaded");
     }
 
-    glGenerateMipmap(GL_TEXTURE_2D);
+    UploadTexture(*image, wrapParam, minFilter, magFilter);
+    profileScope.SetGpuBytes(_storage->sizeInBytes);
+    std::cout << path << " Loaded" << std::endl;
+}
+
+void TextureImage2D::UploadTexture(const DDSImage& image, GLint wrapParam, GLint minFilter, GLint magFilter, GLint firstLevel) {
+    _storage = std::make_shared<Storage>();
+    glGenTextures(1, &_storage->textureID);
+    glBindTexture(GL_TEXTURE_2D, _storage->textureID);
+
+    image.Upload2D(GL_TEXTURE_2D, firstLevel);
+    _storage->width = image.GetWidth();
+    _storage->height = image.GetHeight();
+    _storage->residentLevel = firstLevel;
+    // Mip levels missing in the file are generated below, a full chain is ~4/3 of the base level
+    _storage->sizeInBytes = image.GetMipLevels().size() > 1 ? image.GetPayloadSize() : image.GetPayloadSize() * 4 / 3;
+
+    if (firstLevel > 0) {
+        // More detailed levels are not uploaded yet, the texture is complete without them
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, firstLevel);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(image.GetMipLevels().size()) - 1);
+    }
+    else
+        glGenerateMipmap(GL_TEXTURE_2D);
+
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapParam);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapParam);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, 16);
-    std::cout << path << " Loaded" << std::endl;
 }
 
 GLuint TextureImage2D::GetTexture() const {
-    return _textureID;
+    return _storage ? _storage->textureID : 0;
 }
 
 GLuint TextureImage2D::GetWidth() const {
-    return _width;
+    return _storage ? _storage->width : 0;
 }
 
 GLuint TextureImage2D::GetHeight() const {
-    return _height;
-}
\ No newline at end of file
+    return _storage ? _storage->height : 0;
+}
+
+size_t TextureImage2D::GetSizeInBytes() const {
+    return _storage ? _storage->sizeInBytes : 0;
+}
+size_t TextureImage2D::GetResidentBytes() const {
+    return _storage ? _storage->CalculateResidentBytes() : 0;
+}
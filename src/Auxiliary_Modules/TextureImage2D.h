@@ -1,28 +1,52 @@
 #ifndef SOLARSYSTEM_TEXTUREIMAGE2D_H
 #define SOLARSYSTEM_TEXTUREIMAGE2D_H
-#include "../../src/3rdparty/nv_dds.h"
+#include "DDSImage.h"
 #include <iostream>
 #include <string>
 #include <mutex>
 #include <memory>
 #include <thread>
 
-using namespace nv_dds;
-
+// Shared handle to a GL texture. Copies refer to the same texture, which is deleted when the last copy is destroyed
 class TextureImage2D {
 public:
     TextureImage2D() = default;
     explicit TextureImage2D(const std::string& path, GLint wrapParam = GL_REPEAT, GLint minFilter = GL_LINEAR_MIPMAP_LINEAR, GLint magFilter = GL_LINEAR_MIPMAP_LINEAR);
+    explicit TextureImage2D(const DDSImage& image, GLint wrapParam = GL_REPEAT, GLint minFilter = GL_LINEAR_MIPMAP_LINEAR, GLint magFilter = GL_LINEAR_MIPMAP_LINEAR); // Image is already parsed (e.g. by TextureLoader)
+    // Streamed texture: only mip levels from firstLevel are uploaded, the image is kept so that TextureStreamer can upload the others later
+    explicit TextureImage2D(std::shared_ptr<const DDSImage> image, GLint firstLevel, GLint wrapParam = GL_REPEAT, GLint minFilter = GL_LINEAR_MIPMAP_LINEAR,
+                            GLint magFilter = GL_LINEAR_MIPMAP_LINEAR);
     ~TextureImage2D() = default;
     GLuint GetTexture() const;
     GLuint GetWidth() const;
     GLuint GetHeight() const;
+    size_t GetSizeInBytes() const; // Estimated VRAM size with all mip levels
+    size_t GetResidentBytes() const; // VRAM size of the uploaded mip levels
 
 private:
-    GLuint _textureID = 0;
-    GLuint _width = 0, _height = 0;
+    friend class TextureRegistry;
+    friend class TextureStreamer;
+    friend class TextureArray;
+
+    struct Storage {
+        GLuint textureID = 0;
+        GLuint width = 0, height = 0;
+        size_t sizeInBytes = 0;
+        std::shared_ptr<const DDSImage> source; // Only for streamed textures
+        GLint residentLevel = 0; // The most detailed uploaded level, it is GL_TEXTURE_BASE_LEVEL
+        bool isInArray = false; // The levels were moved into a TextureArray, the texture itself is empty
+
+        size_t CalculateResidentBytes() const;
+        size_t CalculateBytesFromLevel(GLint firstLevel) const; // Size of the levels from firstLevel to the end of the chain
+
+        ~Storage();
+    };
+
+    std::shared_ptr<Storage> _storage;
 
+    explicit TextureImage2D(std::shared_ptr<Storage> storage);
     void LoadTextureFromFile(const std::string& path, GLint wrapParam, GLint minFilter, GLint magFilter);
+    void UploadTexture(const DDSImage& image, GLint wrapParam, GLint minFilter, GLint magFilter, GLint firstLevel = 0);
 };
 
 #endif //SOLARSYSTEM_TEXTUREIMAGE2D_H
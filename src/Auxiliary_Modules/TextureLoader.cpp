@@ -0,0 +1,227 @@
+#include "TextureLoader.h"
+#include "StartupProfiler.h"
+#include <algorithm>
+#include <iomanip>
+
+using namespace std::chrono;
+
+TextureLoader::TextureLoader(TextureStreamer* streamer, size_t threadsCount, size_t maxReadyImages) : _streamer(streamer) {
+    threadsCount = std::max<size_t>(threadsCount, 1); // hardware_concurrency() can return 0
+    _maxReadyImages = maxReadyImages == 0 ? threadsCount * 2 : maxReadyImages;
+
+    _workers.reserve(threadsCount);
+    for (size_t i = 0; i < threadsCount; i++)
+        _workers.emplace_back(&TextureLoader::WorkerLoop, this);
+}
+
+TextureLoader::~TextureLoader() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopped = true;
+    }
+    _jobCondition.notify_all();
+
+    for (auto& worker : _workers)
+        worker.join();
+}
+
+void TextureLoader::Prefetch(const std::vector<std::string>& paths) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_loadedCount == 0 && _pendingPaths.empty() && _inProgressPaths.empty() && _readyImages.empty())
+            _startPoint = steady_clock::now();
+
+        for (const auto& path : paths) {
+            _cancelledPaths.erase(path); // The result of a discarded job is needed again
+            const bool isAlreadyQueued = _readyImages.count(path) || _inProgressPaths.count(path) ||
+                    std::find(_pendingPaths.cbegin(), _pendingPaths.cend(), path) != _pendingPaths.cend();
+
+            if (!isAlreadyQueued) // Duplicates are parsed on demand by Load()
+                _pendingPaths.push_back(path);
+        }
+    }
+    _jobCondition.notify_all();
+}
+
+TextureImage2D TextureLoader::Load(const std::string& path, GLint wrapParam, GLint minFilter, GLint magFilter) {
+    ProfileScope profileScope("texture", path);
+    auto& registry = TextureRegistry::Instance();
+    const std::string canonicalPath = TextureRegistry::MakeCanonicalPath(path);
+
+    if (auto cachedTexture = registry.FindByPath(canonicalPath, wrapParam, minFilter, magFilter)) {
+        DiscardPrefetched(path);
+        std::cout << path << " Taken from cache" << std::endl;
+        profileScope.SetGpuBytes(0);
+        return *cachedTexture;
+    }
+
+    const auto waitStartPoint = steady_clock::now();
+    ParsedImage parsed;
+    bool isParsedHere = false;
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_loadedCount == 0 && _pendingPaths.empty() && _inProgressPaths.empty() && _readyImages.empty())
+            _startPoint = waitStartPoint;
+
+        const auto pendingIt = std::find(_pendingPaths.begin(), _pendingPaths.end(), path);
+
+        if (pendingIt != _pendingPaths.end()) {
+            // No worker has started it yet, so it is faster to parse it here than to wait for the queue
+            _pendingPaths.erase(pendingIt);
+            isParsedHere = true;
+        }
+        else if (_readyImages.count(path) || _inProgressPaths.count(path)) {
+            _cancelledPaths.erase(path);
+            _readyCondition.wait(lock, [&] { return _readyImages.count(path) != 0; });
+            const auto readyIt = _readyImages.find(path);
+            parsed = std::move(readyIt->second);
+            _readyImages.erase(readyIt);
+        }
+        else
+            isParsedHere = true; // Was not prefetched
+    }
+
+    if (isParsedHere) {
+        parsed = ParseImage(path);
+        std::lock_guard<std::mutex> lock(_mutex);
+        _totalParseTime += parsed.parseTime;
+    }
+    else
+        _jobCondition.notify_one(); // There is a free place for one more ready image
+
+    const double waitTime = duration<double, std::milli>(steady_clock::now() - waitStartPoint).count();
+
+    if (!parsed.error.empty())
+        throw std::runtime_error("Image " + path + " cannot be loaded: " + parsed.error);
+
+    const auto content = TextureRegistry::ContentInfo::Of(*parsed.image, parsed.contentHash);
+    if (auto cachedTexture = registry.FindByContent(content, wrapParam, minFilter, magFilter)) { // The same file under another name
+        registry.AddAlias(canonicalPath, wrapParam, minFilter, magFilter, *cachedTexture);
+        std::cout << path << " Taken from cache (same content)" << std::endl;
+        profileScope.SetGpuBytes(0);
+        return *cachedTexture;
+    }
+
+    const auto uploadStartPoint = steady_clock::now();
+    TextureImage2D texture = _streamer != nullptr ? _streamer->Upload(std::move(parsed.image), wrapParam, minFilter, magFilter)
+                                                  : TextureImage2D(*parsed.image, wrapParam, minFilter, magFilter);
+    parsed.image.reset(); // Fully uploaded images are freed right away, streamed ones are owned by their textures and are always mappings
+    const double uploadTime = duration<double, std::milli>(steady_clock::now() - uploadStartPoint).count();
+    registry.Register(canonicalPath, content, wrapParam, minFilter, magFilter, texture);
+    profileScope.SetGpuBytes(texture.GetResidentBytes());
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _totalWaitTime += waitTime;
+        _totalUploadTime += uploadTime;
+        _totalTime = duration<double, std::milli>(steady_clock::now() - _startPoint).count();
+        _loadedCount++;
+    }
+
+    std::cout << std::fixed << std::setprecision(2) << path << " Loaded (parse " << parsed.parseTime << " ms" << (isParsedHere ? " on the main thread" : "")
+              << ", wait " << waitTime << " ms, upload " << uploadTime << " ms)" << std::endl;
+
+    return texture;
+}
+
+bool TextureLoader::IsReady(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _readyImages.count(path) != 0 ||
+           (_inProgressPaths.count(path) == 0 && std::find(_pendingPaths.cbegin(), _pendingPaths.cend(), path) == _pendingPaths.cend());
+}
+
+void TextureLoader::PrintStatistics() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const double sequentialTime = _totalParseTime + _totalUploadTime; // What the same work costs when it is done one file after another
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "Textures loaded: " << _loadedCount << " on " << _workers.size() << " worker threads\n"
+              << "  Parsing (sum over threads): " << _totalParseTime << " ms\n"
+              << "  Main thread waiting: " << _totalWaitTime << " ms\n"
+              << "  Main thread uploading: " << _totalUploadTime << " ms\n"
+              << "  Total: " << _totalTime << " ms (sequential estimate " << sequentialTime << " ms, speedup x"
+              << (_totalTime > 0.0 ? sequentialTime / _totalTime : 1.0) << ")" << std::endl;
+}
+
+void TextureLoader::WorkerLoop() {
+    while (true) {
+        std::string path;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _jobCondition.wait(lock, [this] {
+                return _isStopped || (!_pendingPaths.empty() && _readyImages.size() + _inProgressPaths.size() < _maxReadyImages);
+            });
+
+            if (_isStopped)
+                return;
+
+            path = std::move(_pendingPaths.front());
+            _pendingPaths.pop_front();
+            _inProgressPaths.insert(path);
+        }
+
+        ParsedImage parsed = ParseImage(path);
+        bool isCancelled;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _totalParseTime += parsed.parseTime;
+            _inProgressPaths.erase(path);
+
+            isCancelled = _cancelledPaths.erase(path) != 0;
+            if (!isCancelled) // A cancelled image is unmapped outside the lock, at the end of the iteration
+                _readyImages[path] = std::move(parsed);
+        }
+
+        if (isCancelled)
+            _jobCondition.notify_one(); // Its place is free for the next job
+        else
+            _readyCondition.notify_all();
+    }
+}
+
+void TextureLoader::DiscardPrefetched(const std::string& path) {
+    ParsedImage discarded; // Unmapped after the lock is released
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const auto pendingIt = std::find(_pendingPaths.begin(), _pendingPaths.end(), path);
+        if (pendingIt != _pendingPaths.end()) {
+            _pendingPaths.erase(pendingIt);
+            return;
+        }
+
+        // A worker is parsing it, so it is only marked and the worker drops the result itself
+        if (_inProgressPaths.count(path)) {
+            _cancelledPaths.insert(path);
+            return;
+        }
+
+        const auto readyIt = _readyImages.find(path);
+        if (readyIt == _readyImages.end())
+            return;
+
+        discarded = std::move(readyIt->second);
+        _readyImages.erase(readyIt);
+    }
+    _jobCondition.notify_one();
+}
+
+TextureLoader::ParsedImage TextureLoader::ParseImage(const std::string& path) {
+    ProfileScope profileScope("texture parse", path);
+    const auto parseStartPoint = steady_clock::now();
+    ParsedImage parsed;
+
+    try {
+        parsed.image = std::make_unique<DDSImage>(path);
+        parsed.contentHash = parsed.image->CalculateContentHash(); // Also pages the file in, on the worker and not during the upload
+    }
+    catch (const std::exception& error) {
+        parsed.image.reset();
+        parsed.error = error.what();
+    }
+
+    parsed.parseTime = duration<double, std::milli>(steady_clock::now() - parseStartPoint).count();
+    return parsed;
+}
@@ -0,0 +1,57 @@
+#ifndef SOLARSYSTEM_TEXTURELOADER_H
+#define SOLARSYSTEM_TEXTURELOADER_H
+#include "TextureRegistry.h"
+#include "TextureStreamer.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Reads and parses DDS files on a pool of worker threads. The GL thread takes ready mip chains with Load() and uploads them itself,
+// so all GL calls stay on the main context. Uploaded textures are shared through TextureRegistry
+class TextureLoader {
+public:
+    // With a streamer only the less detailed mip levels are uploaded by Load(), the others are streamed in later
+    explicit TextureLoader(TextureStreamer* streamer = nullptr, size_t threadsCount = std::thread::hardware_concurrency(), size_t maxReadyImages = 0);
+    ~TextureLoader();
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    void Prefetch(const std::vector<std::string>& paths); // Order of paths should match the order of Load() calls
+    TextureImage2D Load(const std::string& path, GLint wrapParam = GL_REPEAT, GLint minFilter = GL_LINEAR_MIPMAP_LINEAR, GLint magFilter = GL_LINEAR_MIPMAP_LINEAR);
+    bool IsReady(const std::string& path) const; // Load() will not wait for the workers: the image is parsed or it was never prefetched
+    void PrintStatistics() const;
+
+private:
+    struct ParsedImage {
+        std::unique_ptr<DDSImage> image; // Released right after the upload unless the texture is streamed from its mapping
+        std::string error;
+        uint64_t contentHash = 0;
+        double parseTime = 0.0; // In ms
+    };
+
+    TextureStreamer* _streamer;
+    std::vector<std::thread> _workers;
+    std::deque<std::string> _pendingPaths;
+    std::unordered_map<std::string, ParsedImage> _readyImages;
+    std::unordered_set<std::string> _inProgressPaths;
+    std::unordered_set<std::string> _cancelledPaths; // In progress, but no longer needed: the worker drops the result
+    mutable std::mutex _mutex;
+    std::condition_variable _jobCondition, _readyCondition;
+    size_t _maxReadyImages; // Back pressure, so that parsed but not uploaded images do not eat all the memory
+    bool _isStopped = false;
+
+    std::chrono::steady_clock::time_point _startPoint;
+    double _totalParseTime = 0.0, _totalWaitTime = 0.0, _totalUploadTime = 0.0, _totalTime = 0.0; // In ms
+    size_t _loadedCount = 0;
+
+    void WorkerLoop();
+    void DiscardPrefetched(const std::string& path); // Never waits for the workers
+    static ParsedImage ParseImage(const std::string& path);
+};
+
+#endif //SOLARSYSTEM_TEXTURELOADER_H
@@ -0,0 +1,81 @@
+#include "TextureRegistry.h"
+#include <filesystem>
+#include <iomanip>
+
+TextureRegistry::ContentInfo TextureRegistry::ContentInfo::Of(const DDSImage& image, uint64_t contentHash) {
+    return ContentInfo{contentHash, image.GetWidth(), image.GetHeight(), image.GetFormat(), image.GetMipLevels().size(), image.GetPayloadSize()};
+}
+
+bool TextureRegistry::ContentInfo::operator==(const ContentInfo& other) const {
+    return std::tie(hash, width, height, format, levelsCount, payloadSize) ==
+           std::tie(other.hash, other.width, other.height, other.format, other.levelsCount, other.payloadSize);
+}
+
+TextureRegistry& TextureRegistry::Instance() {
+    static TextureRegistry registry;
+    return registry;
+}
+
+std::string TextureRegistry::MakeCanonicalPath(const std::string& path) {
+    std::error_code error;
+    const auto canonicalPath = std::filesystem::weakly_canonical(path, error);
+    return error ? path : canonicalPath.generic_string();
+}
+
+std::optional<TextureImage2D> TextureRegistry::FindByPath(const std::string& canonicalPath, GLint wrapParam, GLint minFilter, GLint magFilter) {
+    const auto it = _texturesByPath.find(PathKey(canonicalPath, wrapParam, minFilter, magFilter));
+    if (it == _texturesByPath.end())
+        return std::nullopt;
+
+    auto storage = it->second.lock();
+    if (!storage) { // All users are gone, the texture was deleted
+        _texturesByPath.erase(it);
+        return std::nullopt;
+    }
+
+    return TakeHit(std::move(storage), _pathHits);
+}
+
+std::optional<TextureImage2D> TextureRegistry::FindByContent(const ContentInfo& content, GLint wrapParam, GLint minFilter, GLint magFilter) {
+    const auto it = _texturesByHash.find(HashKey(content.hash, wrapParam, minFilter, magFilter));
+    if (it == _texturesByHash.end())
+        return std::nullopt;
+
+    auto storage = it->second.storage.lock();
+    if (!storage) {
+        _texturesByHash.erase(it);
+        return std::nullopt;
+    }
+
+    if (!(it->second.content == content)) { // The same 64-bit hash of different images, the new one is uploaded on its own
+        _hashCollisions++;
+        return std::nullopt;
+    }
+
+    return TakeHit(std::move(storage), _hashHits);
+}
+
+void TextureRegistry::Register(const std::string& canonicalPath, const ContentInfo& content, GLint wrapParam, GLint minFilter, GLint magFilter, const TextureImage2D& texture) {
+    _texturesByPath[PathKey(canonicalPath, wrapParam, minFilter, magFilter)] = texture._storage;
+    _texturesByHash[HashKey(content.hash, wrapParam, minFilter, magFilter)] = ContentEntry{texture._storage, content};
+    _misses++;
+    _uploadedBytes += texture.GetSizeInBytes();
+}
+
+void TextureRegistry::AddAlias(const std::string& canonicalPath, GLint wrapParam, GLint minFilter, GLint magFilter, const TextureImage2D& texture) {
+    _texturesByPath[PathKey(canonicalPath, wrapParam, minFilter, magFilter)] = texture._storage;
+}
+
+void TextureRegistry::PrintStatistics() const {
+    constexpr double bytesInMegabyte = 1024.0 * 1024.0;
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "Texture cache: " << _pathHits + _hashHits << " hits (" << _pathHits << " by path, " << _hashHits << " by content), " << _misses << " misses, " << _hashCollisions << " hash collisions\n"
+              << "  Uploaded: " << _uploadedBytes / bytesInMegabyte << " MB, VRAM saved: " << _savedBytes / bytesInMegabyte << " MB" << std::endl;
+}
+
+std::optional<TextureImage2D> TextureRegistry::TakeHit(std::shared_ptr<TextureImage2D::Storage> storage, size_t& hitsCounter) {
+    hitsCounter++;
+    _savedBytes += storage->sizeInBytes;
+    return TextureImage2D(std::move(storage));
+}
@@ -0,0 +1,53 @@
+#ifndef SOLARSYSTEM_TEXTUREREGISTRY_H
+#define SOLARSYSTEM_TEXTUREREGISTRY_H
+#include "TextureImage2D.h"
+#include <map>
+#include <optional>
+#include <tuple>
+
+// Process-wide cache of uploaded textures, keyed by canonical path and by content hash (together with the sampling parameters).
+// It holds weak references only, so a texture is still deleted when the last TextureImage2D referring to it is gone.
+// Used from the GL thread only
+class TextureRegistry {
+public:
+    // What is compared besides the hash before a texture is shared under another path, so a hash collision cannot bind a wrong texture
+    struct ContentInfo {
+        uint64_t hash = 0;
+        GLsizei width = 0, height = 0;
+        GLenum format = 0;
+        size_t levelsCount = 0, payloadSize = 0;
+
+        static ContentInfo Of(const DDSImage& image, uint64_t contentHash);
+        bool operator==(const ContentInfo& other) const;
+    };
+
+    static TextureRegistry& Instance();
+    static std::string MakeCanonicalPath(const std::string& path);
+
+    std::optional<TextureImage2D> FindByPath(const std::string& canonicalPath, GLint wrapParam, GLint minFilter, GLint magFilter);
+    std::optional<TextureImage2D> FindByContent(const ContentInfo& content, GLint wrapParam, GLint minFilter, GLint magFilter);
+    // A texture which was just uploaded, counted as a miss
+    void Register(const std::string& canonicalPath, const ContentInfo& content, GLint wrapParam, GLint minFilter, GLint magFilter, const TextureImage2D& texture);
+    // Another path of a texture found by its content, so the next load of the path is a hit by path. No counters are touched
+    void AddAlias(const std::string& canonicalPath, GLint wrapParam, GLint minFilter, GLint magFilter, const TextureImage2D& texture);
+    void PrintStatistics() const;
+
+private:
+    using PathKey = std::tuple<std::string, GLint, GLint, GLint>;
+    using HashKey = std::tuple<uint64_t, GLint, GLint, GLint>;
+
+    struct ContentEntry {
+        std::weak_ptr<TextureImage2D::Storage> storage;
+        ContentInfo content;
+    };
+
+    std::map<PathKey, std::weak_ptr<TextureImage2D::Storage>> _texturesByPath;
+    std::map<HashKey, ContentEntry> _texturesByHash;
+    size_t _pathHits = 0, _hashHits = 0, _misses = 0, _hashCollisions = 0;
+    size_t _savedBytes = 0, _uploadedBytes = 0;
+
+    TextureRegistry() = default;
+    std::optional<TextureImage2D> TakeHit(std::shared_ptr<TextureImage2D::Storage> storage, size_t& hitsCounter);
+};
+
+#endif //SOLARSYSTEM_TEXTUREREGISTRY_H
@@ -0,0 +1,197 @@
+#include "TextureStreamer.h"
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <queue>
+
+TextureStreamer::TextureStreamer(size_t budgetInBytes, GLsizei initialSize, size_t maxUploadBytesPerFrame)
+    : _budgetInBytes(budgetInBytes), _maxUploadBytesPerFrame(maxUploadBytesPerFrame), _initialSize(initialSize)
+{
+}
+
+TextureImage2D TextureStreamer::Upload(std::shared_ptr<const DDSImage> image, GLint wrapParam, GLint minFilter, GLint magFilter) {
+    const auto& mipLevels = image->GetMipLevels();
+    const bool isMipmapped = minFilter != GL_NEAREST && minFilter != GL_LINEAR;
+    GLint firstLevel = 0;
+
+    // Files without a mip chain cannot be streamed, their levels are generated from the most detailed one. Neither are images inflated
+    // from the archive: a streamed texture keeps its image for its whole life, which must be the mapping and not a heap copy of the file
+    while (isMipmapped && image->IsMapped() && static_cast<size_t>(firstLevel) + 1 < mipLevels.size() &&
+           (mipLevels[firstLevel].width > _initialSize || mipLevels[firstLevel].height > _initialSize))
+        firstLevel++;
+
+    if (firstLevel == 0)
+        return TextureImage2D(*image, wrapParam, minFilter, magFilter);
+
+    TextureImage2D texture(std::move(image), firstLevel, wrapParam, minFilter, magFilter);
+    _textures[texture._storage.get()] = StreamedTexture{texture._storage, firstLevel}; // Can replace an expired texture with the same address
+    _residentBytes += texture.GetResidentBytes();
+    _peakResidentBytes = std::max(_peakResidentBytes, _residentBytes);
+    return texture;
+}
+
+void TextureStreamer::Request(const TextureImage2D& texture, float screenSize) {
+    const auto textureIt = _textures.find(texture._storage.get());
+    if (textureIt != _textures.end())
+        textureIt->second.screenSize = std::max({textureIt->second.screenSize, screenSize, 1.0f});
+}
+
+void TextureStreamer::KeepResident(const TextureImage2D& texture) {
+    const auto textureIt = _textures.find(texture._storage.get());
+    if (textureIt != _textures.end())
+        textureIt->second.isKeptResident = true;
+}
+
+void TextureStreamer::Update() {
+    CalculateTargetLevels();
+
+    std::vector<std::pair<float, std::shared_ptr<TextureImage2D::Storage>>> pendingUploads;
+    GLint boundTexture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+
+    for (auto& [key, texture] : _textures) {
+        auto storage = texture.storage.lock();
+
+        while (storage->residentLevel < texture.targetLevel) // Releasing costs nothing, so it is not limited
+            ReleaseLevel(*storage);
+
+        if (storage->residentLevel > texture.targetLevel)
+            pendingUploads.emplace_back(texture.isKeptResident ? std::numeric_limits<float>::max() : texture.screenSize, std::move(storage));
+    }
+
+    // The biggest textures on screen go first. Levels are uploaded from less detailed to more detailed ones,
+    // so that the quality grows gradually and one frame does not upload hundreds of megabytes
+    std::sort(pendingUploads.begin(), pendingUploads.end(), [](const auto& left, const auto& right) { return left.first > right.first; });
+    size_t uploadedBytes = 0;
+
+    for (const auto& [screenSize, storage] : pendingUploads) {
+        const GLint targetLevel = _textures.at(storage.get()).targetLevel;
+
+        while (storage->residentLevel > targetLevel) {
+            const size_t levelSize = storage->source->GetMipLevels()[storage->residentLevel - 1].size;
+            if (uploadedBytes != 0 && uploadedBytes + levelSize > _maxUploadBytesPerFrame)
+                break;
+
+            UploadLevel(*storage);
+            uploadedBytes += levelSize;
+        }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, boundTexture);
+
+    _residentBytes = 0;
+    for (auto& [key, texture] : _textures) {
+        _residentBytes += texture.storage.lock()->CalculateResidentBytes();
+        texture.screenSize = NOT_REQUESTED; // The requests of the next frame are collected anew
+    }
+    _peakResidentBytes = std::max(_peakResidentBytes, _residentBytes);
+}
+
+void TextureStreamer::SetBudget(size_t budgetInBytes) {
+    _budgetInBytes = budgetInBytes;
+}
+
+void TextureStreamer::SetReservedBytes(size_t reservedBytes) {
+    _reservedBytes = reservedBytes;
+}
+
+size_t TextureStreamer::GetResidentBytes() const {
+    return _residentBytes;
+}
+
+size_t TextureStreamer::GetStreamedInBytes() const {
+    return _streamedInBytes;
+}
+
+size_t TextureStreamer::GetEvictedBytes() const {
+    return _evictedBytes;
+}
+
+void TextureStreamer::PrintStatistics() const {
+    constexpr double bytesInMegabyte = 1024.0 * 1024.0;
+
+    std::cout << std::fixed << std::setprecision(2) << "Streamed textures: " << _textures.size() << ", resident " << _residentBytes / bytesInMegabyte
+              << " MB (peak " << _peakResidentBytes / bytesInMegabyte << " MB, budget " << _budgetInBytes / bytesInMegabyte << " MB, reserved "
+              << _reservedBytes / bytesInMegabyte << " MB)\n"
+              << "  Streamed in: " << _streamedInLevels << " levels, " << _streamedInBytes / bytesInMegabyte << " MB\n"
+              << "  Evicted: " << _evictedLevels << " levels, " << _evictedBytes / bytesInMegabyte << " MB" << std::endl;
+}
+
+void TextureStreamer::CalculateTargetLevels() {
+    size_t targetBytes = 0;
+
+    for (auto textureIt = _textures.begin(); textureIt != _textures.end();) {
+        auto& texture = textureIt->second;
+        const auto storage = texture.storage.lock();
+
+        if (!storage || storage->isInArray) { // The last copy of the texture is destroyed or its levels are streamed by TextureArray
+            textureIt = _textures.erase(textureIt);
+            continue;
+        }
+
+        // The most detailed level, which is still not smaller than the texture on screen. Nothing more than the startup levels
+        // is kept for textures which were not requested in this frame, they are off screen or their bodies are not drawn
+        if (texture.isKeptResident)
+            texture.targetLevel = 0;
+        else if (texture.screenSize == NOT_REQUESTED)
+            texture.targetLevel = texture.lowestLevel;
+        else {
+            texture.targetLevel = 0;
+            while (texture.targetLevel < texture.lowestLevel && static_cast<float>(storage->width >> (texture.targetLevel + 1)) >= texture.screenSize)
+                texture.targetLevel++;
+        }
+
+        targetBytes += storage->CalculateBytesFromLevel(texture.targetLevel);
+        ++textureIt;
+    }
+
+    const size_t budgetInBytes = _budgetInBytes > _reservedBytes ? _budgetInBytes - _reservedBytes : 0;
+    if (targetBytes <= budgetInBytes)
+        return;
+
+    // Over the budget the textures with the most texels per pixel on screen lose their most detailed level first
+    using Candidate = std::pair<float, StreamedTexture*>;
+    std::priority_queue<Candidate> candidates;
+    const auto calculateOversampling = [](const StreamedTexture& texture, GLuint width) {
+        return static_cast<float>(width >> texture.targetLevel) / texture.screenSize;
+    };
+
+    for (auto& [key, texture] : _textures) {
+        if (!texture.isKeptResident && texture.targetLevel < texture.lowestLevel) // Not requested ones are already at their lowest level
+            candidates.emplace(calculateOversampling(texture, key->width), &texture);
+    }
+
+    while (targetBytes > budgetInBytes && !candidates.empty()) {
+        StreamedTexture* texture = candidates.top().second;
+        candidates.pop();
+
+        const auto storage = texture->storage.lock();
+        targetBytes -= storage->source->GetMipLevels()[texture->targetLevel].size;
+        texture->targetLevel++;
+
+        if (texture->targetLevel < texture->lowestLevel)
+            candidates.emplace(calculateOversampling(*texture, storage->width), texture);
+    }
+}
+
+void TextureStreamer::UploadLevel(TextureImage2D::Storage& storage) {
+    const GLint level = storage.residentLevel - 1;
+    glBindTexture(GL_TEXTURE_2D, storage.textureID);
+    storage.source->UploadLevel(GL_TEXTURE_2D, level);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+    storage.residentLevel = level;
+
+    _streamedInBytes += storage.source->GetMipLevels()[level].size;
+    _streamedInLevels++;
+}
+
+void TextureStreamer::ReleaseLevel(TextureImage2D::Storage& storage) {
+    const GLint level = storage.residentLevel;
+    glBindTexture(GL_TEXTURE_2D, storage.textureID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level + 1); // The level must be out of use before it is respecified
+    storage.source->ReleaseLevel(GL_TEXTURE_2D, level);
+    storage.residentLevel = level + 1;
+
+    _evictedBytes += storage.source->GetMipLevels()[level].size;
+    _evictedLevels++;
+}
@@ -0,0 +1,48 @@
+#ifndef SOLARSYSTEM_TEXTURESTREAMER_H
+#define SOLARSYSTEM_TEXTURESTREAMER_H
+#include "TextureImage2D.h"
+#include <unordered_map>
+
+// Keeps only the mip levels of textures that are needed for their size on screen. At startup only levels not bigger than
+// initialSize are uploaded, more detailed levels are streamed in from the mapped DDS files when a body comes closer and are
+// released (GL_TEXTURE_BASE_LEVEL is raised and the levels are respecified as empty) when it goes away or the budget is exceeded.
+// Textures loaded from files without a mip chain or inflated from the archive are always fully resident. Used from the GL thread only
+class TextureStreamer {
+public:
+    explicit TextureStreamer(size_t budgetInBytes = 768 * 1024 * 1024, GLsizei initialSize = 512, size_t maxUploadBytesPerFrame = 16 * 1024 * 1024);
+    TextureImage2D Upload(std::shared_ptr<const DDSImage> image, GLint wrapParam, GLint minFilter, GLint magFilter);
+    // Width in pixels, which the texture takes on screen. Requests are collected between two updates and the biggest one is taken,
+    // so a texture shared by several bodies gets the size of the closest one. Textures without requests fall back to their startup levels
+    void Request(const TextureImage2D& texture, float screenSize);
+    void KeepResident(const TextureImage2D& texture); // For textures which are not mapped onto bodies, all their levels are streamed in
+    void Update(); // Once per frame, uploads and releases levels and forgets the requests
+    void SetBudget(size_t budgetInBytes);
+    void SetReservedBytes(size_t reservedBytes); // Levels kept outside (texture arrays), they count against the budget
+    size_t GetResidentBytes() const;
+    size_t GetStreamedInBytes() const;
+    size_t GetEvictedBytes() const;
+    void PrintStatistics() const;
+
+private:
+    struct StreamedTexture {
+        std::weak_ptr<TextureImage2D::Storage> storage;
+        GLint lowestLevel; // Uploaded at startup and never released
+        float screenSize = NOT_REQUESTED;
+        GLint targetLevel = 0;
+        bool isKeptResident = false;
+    };
+
+    static constexpr float NOT_REQUESTED = -1.0f;
+
+    std::unordered_map<const TextureImage2D::Storage*, StreamedTexture> _textures;
+    size_t _budgetInBytes, _maxUploadBytesPerFrame, _reservedBytes = 0;
+    GLsizei _initialSize;
+    size_t _residentBytes = 0, _peakResidentBytes = 0;
+    size_t _streamedInBytes = 0, _evictedBytes = 0, _streamedInLevels = 0, _evictedLevels = 0;
+
+    void CalculateTargetLevels();
+    void UploadLevel(TextureImage2D::Storage& storage);
+    void ReleaseLevel(TextureImage2D::Storage& storage);
+};
+
+#endif //SOLARSYSTEM_TEXTURESTREAMER_H
@@ -0,0 +1,62 @@
+#include "UniformBenchmark.h"
+#include <iomanip>
+
+UniformBenchmark::UniformBenchmark(size_t framesPerRun) : _framesPerRun(framesPerRun) {
+}
+
+void UniformBenchmark::Start() {
+    if (_isRunning)
+        return;
+
+    _isRunning = true;
+    _frame = 0;
+    _results[0] = _results[1] = RunResult();
+    Shader::SetLocationCacheEnabled(false);
+    std::cout << "Uniform benchmark: " << _framesPerRun << " frames without the location cache, then " << _framesPerRun << " with it" << std::endl;
+}
+
+bool UniformBenchmark::IsRunning() const {
+    return _isRunning;
+}
+
+void UniformBenchmark::BeginFrame() {
+    if (!_isRunning)
+        return;
+
+    Shader::ResetCallStatistics();
+    _frameStartPoint = std::chrono::steady_clock::now();
+}
+
+void UniformBenchmark::EndFrame() {
+    if (!_isRunning)
+        return;
+
+    const auto& calls = Shader::GetCallStatistics();
+    RunResult& result = _results[_frame < _framesPerRun ? 0 : 1];
+    result.calls.useProgramCalls += calls.useProgramCalls;
+    result.calls.uniformCalls += calls.uniformCalls;
+    result.calls.getUniformLocationCalls += calls.getUniformLocationCalls;
+    result.cpuTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _frameStartPoint).count();
+
+    if (++_frame == _framesPerRun)
+        Shader::SetLocationCacheEnabled(true);
+    else if (_frame == 2 * _framesPerRun) {
+        _isRunning = false;
+        PrintResults();
+    }
+}
+
+void UniformBenchmark::PrintResults() const {
+    const auto frames = static_cast<double>(_framesPerRun);
+    const auto printRun = [frames](const char* title, const RunResult& result) {
+        const size_t totalCalls = result.calls.useProgramCalls + result.calls.uniformCalls + result.calls.getUniformLocationCalls;
+
+        std::cout << std::fixed << std::setprecision(1) << "  " << title << ": " << totalCalls / frames << " GL calls per frame (glUseProgram "
+                  << result.calls.useProgramCalls / frames << ", glUniform* " << result.calls.uniformCalls / frames << ", glGetUniformLocation "
+                  << result.calls.getUniformLocationCalls / frames << "), CPU " << std::setprecision(3) << result.cpuTime / frames << " ms per frame" << std::endl;
+    };
+
+    std::cout << "Uniform benchmark results:" << std::endl;
+    printRun("Lookup by name on every upload", _results[0]);
+    printRun("Location cache and handles", _results[1]);
+}
@@ -0,0 +1,30 @@
+#ifndef SOLARSYSTEM_UNIFORMBENCHMARK_H
+#define SOLARSYSTEM_UNIFORMBENCHMARK_H
+#include "Shader.h"
+#include <chrono>
+
+// Counts the GL calls which shaders make per frame, first with glGetUniformLocation on each upload by name or through a handle
+// (as it was before the location cache and the handles), then with both. Prints the runs side by side when they are over
+class UniformBenchmark {
+public:
+    explicit UniformBenchmark(size_t framesPerRun = 300);
+    void Start();
+    bool IsRunning() const;
+    void BeginFrame();
+    void EndFrame(); // Before the buffers are swapped, so that waiting for vertical sync is not counted as CPU time
+
+private:
+    struct RunResult {
+        Shader::CallStatistics calls;
+        double cpuTime = 0.0; // ms
+    };
+
+    size_t _framesPerRun, _frame = 0;
+    bool _isRunning = false;
+    RunResult _results[2]; // Without the cache and with it
+    std::chrono::steady_clock::time_point _frameStartPoint;
+
+    void PrintResults() const;
+};
+
+#endif //SOLARSYSTEM_UNIFORMBENCHMARK_H
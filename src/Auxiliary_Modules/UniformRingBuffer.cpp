@@ -0,0 +1,70 @@
+#include "UniformRingBuffer.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+UniformRingBuffer::UniformRingBuffer(GLsizeiptr frameCapacity) {
+    GLint offsetAlignment = 0, storageOffsetAlignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageOffsetAlignment);
+    offsetAlignment = std::max(offsetAlignment, storageOffsetAlignment);
+    _offsetAlignment = offsetAlignment > 0 ? offsetAlignment : 256;
+    _frameCapacity = (frameCapacity + _offsetAlignment - 1) / _offsetAlignment * _offsetAlignment; // So that every region starts aligned
+
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &_buffer);
+    glNamedBufferStorage(_buffer, _frameCapacity * FRAMES_IN_FLIGHT, nullptr, flags);
+    _mappedData = static_cast<uint8_t*>(glMapNamedBufferRange(_buffer, 0, _frameCapacity * FRAMES_IN_FLIGHT, flags));
+
+    if (!_mappedData)
+        throw std::runtime_error("ERROR::UNIFORM_RING_BUFFER::FAILED_TO_MAP_BUFFER");
+}
+
+UniformRingBuffer::~UniformRingBuffer() {
+    for (GLsync fence : _frameFences) {
+        if (fence)
+            glDeleteSync(fence);
+    }
+
+    glUnmapNamedBuffer(_buffer);
+    glDeleteBuffers(1, &_buffer);
+}
+
+void UniformRingBuffer::BeginFrame() {
+    GLsync& fence = _frameFences[_currentFrame];
+
+    if (fence) {
+        // As a rule the fence has long been signaled, since the region was last used FRAMES_IN_FLIGHT frames ago
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000) == GL_TIMEOUT_EXPIRED) {}
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    _frameOffset = 0;
+}
+
+void UniformRingBuffer::EndFrame() {
+    _frameFences[_currentFrame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _currentFrame = (_currentFrame + 1) % FRAMES_IN_FLIGHT;
+}
+
+GLintptr UniformRingBuffer::Write(const void* data, GLsizeiptr size) {
+    if (_frameOffset + size > _frameCapacity) {
+        throw std::runtime_error("ERROR::UNIFORM_RING_BUFFER::FRAME_CAPACITY_EXCEEDED: " + std::to_string(_frameOffset + size) + " of " +
+                                 std::to_string(_frameCapacity) + " bytes");
+    }
+
+    const GLintptr offset = _currentFrame * _frameCapacity + _frameOffset;
+    std::memcpy(_mappedData + offset, data, size); // The mapping is coherent, so no explicit flush is needed
+    _frameOffset += (size + _offsetAlignment - 1) / _offsetAlignment * _offsetAlignment;
+    return offset;
+}
+
+void UniformRingBuffer::Bind(GLuint binding, GLintptr offset, GLsizeiptr size) const {
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, _buffer, offset, size);
+}
+
+void UniformRingBuffer::BindStorage(GLuint binding, GLintptr offset, GLsizeiptr size) const {
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, _buffer, offset, size);
+}
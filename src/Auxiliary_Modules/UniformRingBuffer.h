@@ -0,0 +1,44 @@
+#ifndef SOLARSYSTEM_UNIFORMRINGBUFFER_H
+#define SOLARSYSTEM_UNIFORMRINGBUFFER_H
+#include <GL/glew.h>
+#include <array>
+#include <cstdint>
+
+// A uniform buffer which is mapped once for the whole lifetime and split into regions, one per frame in flight.
+// The CPU writes the blocks of the current frame into its region while the GPU still reads the regions of the previous frames,
+// and a fence per region keeps a region from being overwritten before the GPU has finished with it. Blocks can be bound as storage buffers too
+class UniformRingBuffer {
+public:
+    explicit UniformRingBuffer(GLsizeiptr frameCapacity);
+    UniformRingBuffer(const UniformRingBuffer&) = delete;
+    UniformRingBuffer& operator=(const UniformRingBuffer&) = delete;
+    ~UniformRingBuffer();
+
+    void BeginFrame(); // Waits until the GPU has finished reading the region of this frame
+    void EndFrame();
+    GLintptr Write(const void* data, GLsizeiptr size); // Returns the offset of the written block in the buffer
+    void Bind(GLuint binding, GLintptr offset, GLsizeiptr size) const;
+    void BindStorage(GLuint binding, GLintptr offset, GLsizeiptr size) const;
+
+    template<typename T>
+    GLintptr Write(const T& block) {
+        return Write(&block, sizeof(T));
+    }
+
+    template<typename T>
+    void Bind(GLuint binding, GLintptr offset) const {
+        Bind(binding, offset, sizeof(T));
+    }
+
+private:
+    static constexpr uint8_t FRAMES_IN_FLIGHT = 3;
+
+    GLuint _buffer = 0;
+    GLsizeiptr _frameCapacity = 0;
+    GLintptr _offsetAlignment = 0, _frameOffset = 0; // _frameOffset is relative to the start of the current region
+    uint8_t _currentFrame = 0;
+    uint8_t* _mappedData = nullptr;
+    std::array<GLsync, FRAMES_IN_FLIGHT> _frameFences {};
+};
+
+#endif //SOLARSYSTEM_UNIFORMRINGBUFFER_H
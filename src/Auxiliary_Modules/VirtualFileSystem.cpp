@@ -0,0 +1,54 @@
+#include "VirtualFileSystem.h"
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+
+VirtualFileSystem& VirtualFileSystem::Instance() {
+    static VirtualFileSystem fileSystem;
+    return fileSystem;
+}
+
+void VirtualFileSystem::Mount(const std::string& archivePath) {
+    std::error_code error;
+    if (!std::filesystem::exists(archivePath, error)) {
+        std::cout << archivePath << " is not found, resources are read from loose files (run AssetBaker to pack them)" << std::endl;
+        return;
+    }
+
+    try {
+        _archive = std::make_unique<AssetArchive>(archivePath);
+        std::cout << std::fixed << std::setprecision(2) << archivePath << " Mounted (" << _archive->GetEntriesCount() << " files, "
+                  << _archive->GetSize() / (1024.0 * 1024.0) << " MB)" << std::endl;
+    }
+    catch (const std::runtime_error& err) {
+        std::cout << err.what() << ", resources are read from loose files" << std::endl;
+    }
+}
+
+AssetFile VirtualFileSystem::Open(const std::string& path) const {
+    if (IsPacked(path))
+        return _archive->Read(MakeVirtualPath(path));
+
+    const auto mapping = std::make_shared<const MappedFile>(path);
+    return AssetFile(mapping, 0, mapping->GetSize());
+}
+
+bool VirtualFileSystem::IsPacked(const std::string& path) const {
+    if (!_archive)
+        return false;
+
+    const std::string virtualPath = MakeVirtualPath(path);
+    if (!_archive->Contains(virtualPath))
+        return false;
+
+    const auto looseStamp = FileStamp::Of(path); // Shipped builds have no loose copies, only one failed stat
+    return !looseStamp || *looseStamp == _archive->GetSourceStamp(virtualPath);
+}
+
+std::string VirtualFileSystem::MakeVirtualPath(const std::string& path) {
+    const std::string normalPath = std::filesystem::path(path).lexically_normal().generic_string();
+    const std::string resourceDirectory = "resource/";
+    const size_t resourcePosition = normalPath.rfind(resourceDirectory);
+
+    return resourcePosition == std::string::npos ? normalPath : normalPath.substr(resourcePosition + resourceDirectory.size());
+}
@@ -0,0 +1,24 @@
+#ifndef SOLARSYSTEM_VIRTUALFILESYSTEM_H
+#define SOLARSYSTEM_VIRTUALFILESYSTEM_H
+#include "AssetArchive.h"
+
+// The single way the loaders read resources. When an archive is mounted, "../resource/textures/Mars_Diffuse.dds" is looked up
+// in it as "textures/Mars_Diffuse.dds", and files missing in the archive (or all files without it) are read from disk.
+// A loose file which was changed since the archive was baked (its size or write time differs) wins over its packed copy,
+// so edited shaders and models are used without baking the archive again.
+// Mount() is called before any loading, after that Open() can be used from any thread
+class VirtualFileSystem {
+public:
+    static VirtualFileSystem& Instance();
+    void Mount(const std::string& archivePath); // Without the archive resources stay loose files, e.g. during development
+    AssetFile Open(const std::string& path) const;
+    bool IsPacked(const std::string& path) const; // Open() reads the file from the archive
+    static std::string MakeVirtualPath(const std::string& path);
+
+private:
+    std::unique_ptr<AssetArchive> _archive;
+
+    VirtualFileSystem() = default;
+};
+
+#endif //SOLARSYSTEM_VIRTUALFILESYSTEM_H
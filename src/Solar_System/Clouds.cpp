@@ -3,4 +3,10 @@
 Clouds::Clouds(const CloudsInfo& cloudsInfo, std::shared_ptr<SpaceObject> parent) : OuterShell(cloudsInfo.cloudsModel, cloudsInfo.cloudsShader, std::move(parent),
     cloudsInfo.scaleFactor), _diffuse(cloudsInfo.diffuseMap), _normal(cloudsInfo.normalMap)
 {
+    _materialTextures[DiffuseSlot] = _diffuse;
+    _materialTextures[NormalSlot] = _normal;
+}
+
+std::vector<TextureImage2D> Clouds::GetTextures() const {
+    return {_diffuse, _normal};
 }
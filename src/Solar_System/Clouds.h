@@ -17,6 +17,7 @@ class Clouds : public OuterShell {
 public:
     explicit Clouds(const CloudsInfo& cloudsInfo, std::shared_ptr<SpaceObject> parent);
     void AdjustToParent(bool isRunTime) = 0;
+    std::vector<TextureImage2D> GetTextures() const;
 
 protected:
     TextureImage2D _diffuse, _normal;
@@ -1,8 +1,10 @@
 #include "Earth.h"
 
-Earth::Earth(const PlanetInfo& planetInfo, std::shared_ptr<Star> parentStar) : Planet(planetInfo, std::move(parentStar)), _diffuses(planetInfo.diffuseTextures),
-    _normalMap(planetInfo.normalMap), _specular(planetInfo.specularTexture)
+Earth::Earth(const PlanetInfo& planetInfo, std::shared_ptr<Star> parentStar) : Planet(planetInfo, std::move(parentStar))
 {
+    _materialTextures[CloudSlot] = planetInfo.diffuseTextures.at(1);
+    _materialTextures[NightSlot] = planetInfo.diffuseTextures.at(2);
+    SetMaterial(HasNightTexture | HasSpecularMap | HasSpecular | HasClouds, 0.75f);
     Translate(_parentStar->GetPosition() + glm::vec3(1900.0f, 0.0f, 0.0f)); // Init position for light space matrix
 }
 
@@ -20,27 +22,3 @@ void Earth::AdjustToParent(bool isRunTime) {
     Rotate(rotationAngle, glm::vec3(0.0f, 1.0f, 0.0f));
     UpdateModelMatrix();
 }
-
-void Earth::Render() const {
-    GetShader().SetBool("hasNightTexture", true);
-    GetShader().SetBool("hasSpecularMap", true);
-    GetShader().SetBool("hasSpecular", true);
-    GetShader().SetBool("hasClouds", true);
-    GetShader().SetBool("isUseSphereIntersect", false);
-    GetShader().SetInt("mainDiffuseTexture", 0);
-    GetShader().SetInt("cloudTexture", 1);
-    GetShader().SetInt("nightTexture", 2);
-    GetShader().SetInt("normalMap", 3);
-    GetShader().SetInt("specularMap", 4);
-    GetShader().SetFloat("ambientFactor", 0.75f);
-
-    glBindTextureUnit(0, _diffuses.at(0).GetTexture());
-    glBindTextureUnit(1, _diffuses.at(1).GetTexture());
-    glBindTextureUnit(2, _diffuses.at(2).GetTexture());
-    glBindTextureUnit(3, _normalMap.GetTexture());
-    glBindTextureUnit(4, _specular.GetTexture());
-
-    SpaceObject::Render();
-
-    GetShader().SetBool("hasClouds", false);
-}
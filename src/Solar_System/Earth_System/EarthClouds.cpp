@@ -2,6 +2,7 @@
 
 EarthClouds::EarthClouds(const CloudsInfo& cloudsInfo, std::shared_ptr<SpaceObject> parent) : Clouds(cloudsInfo, std::move(parent))
 {
+    SetMaterial(NoMaterialFlags, 1.0f);
 }
 
 void EarthClouds::AdjustToParent(bool isRunTime) {
@@ -18,14 +19,3 @@ void EarthClouds::AdjustToParent(bool isRunTime) {
     Rotate(rotationAngle, glm::vec3(0.0f, 1.0f, 0.0f));
     UpdateModelMatrix();
 }
-
-void EarthClouds::Render() const {
-    GetShader().SetFloat("ambientFactor", 1.0);
-    GetShader().SetInt("mainDiffuseTexture", 0);
-    GetShader().SetInt("cloudsNormalMap", 1);
-
-    glBindTextureUnit(0, _diffuse.GetTexture());
-    glBindTextureUnit(1, _normal.GetTexture());
-
-    SpaceObject::Render();
-}
@@ -1,8 +1,8 @@
 #include "Moon.h"
 
-Moon::Moon(const SatelliteInfo& satelliteInfo, std::shared_ptr<SpaceObject> parent) : Satellite(satelliteInfo, std::move(parent)),
-    _diffuses(satelliteInfo.diffuseTextures), _normalMap(satelliteInfo.normalMap)
+Moon::Moon(const SatelliteInfo& satelliteInfo, std::shared_ptr<SpaceObject> parent) : Satellite(satelliteInfo, std::move(parent))
 {
+    SetMaterial(UseSphereIntersect, 0.0f);
 }
 
 void Moon::AdjustToParent(bool isRunTime) {
@@ -28,19 +28,3 @@ void Moon::AdjustToParent(bool isRunTime) {
     Rotate(rotationAngle, glm::vec3(0, 1, 0));
     UpdateModelMatrix();
 }
-
-void Moon::Render() const {
-    GetShader().SetBool("hasCloudTexture", false);
-    GetShader().SetBool("hasNightTexture", false);
-    GetShader().SetBool("hasSpecularMap", false);
-    GetShader().SetBool("hasSpecular", false);
-    GetShader().SetBool("isUseSphereIntersect", true);
-    GetShader().SetInt("mainDiffuseTexture", 0);
-    GetShader().SetInt("normalMap", 1);
-    GetShader().SetFloat("ambientFactor", 0.0f);
-
-    glBindTextureUnit(0, _diffuses.at(0).GetTexture());
-    glBindTextureUnit(1, _normalMap.GetTexture());
-
-    SpaceObject::Render();
-}
@@ -1,8 +1,8 @@
 #include "Ganymede.h"
 
-Ganymede::Ganymede(const SatelliteInfo& satelliteInfo, std::shared_ptr<SpaceObject> parent) : Satellite(satelliteInfo, std::move(parent)),
-    _diffuses(satelliteInfo.diffuseTextures), _normalMap(satelliteInfo.normalMap)
+Ganymede::Ganymede(const SatelliteInfo& satelliteInfo, std::shared_ptr<SpaceObject> parent) : Satellite(satelliteInfo, std::move(parent))
 {
+    SetMaterial(HasSpecular | UseSphereIntersect, 0.0f);
 }
 
 void Ganymede::AdjustToParent(bool isRunTime) {
@@ -27,19 +27,3 @@ void Ganymede::AdjustToParent(bool isRunTime) {
     Rotate(rotationAngle, glm::vec3(0, 1, 0));
     UpdateModelMatrix();
 }
-
-void Ganymede::Render() const {
-    GetShader().SetBool("hasNightTexture", false);
-    GetShader().SetBool("hasSpecularMap", false);
-    GetShader().SetBool("hasSpecular", true);
-    GetShader().SetBool("isUseSphereIntersect", true);
-    GetShader().SetInt("mainDiffuseTexture", 0);
-    GetShader().SetInt("normalMap", 1);
-    GetShader().SetFloat("ambientFactor", 0.0f);
-
-    glBindTextureUnit(0, _diffuses.at(0).GetTexture());
-    glBindTextureUnit(1, _normalMap.GetTexture());
-
-    SpaceObject::Render();
-}
-
@@ -1,8 +1,8 @@
 #include "Jupiter.h"
 
-Jupiter::Jupiter(const PlanetInfo& planetInfo, std::shared_ptr<Star> parentStar) : Planet(planetInfo, std::move(parentStar)), _diffuses(planetInfo.diffuseTextures),
-    _normalMap(planetInfo.normalMap)
+Jupiter::Jupiter(const PlanetInfo& planetInfo, std::shared_ptr<Star> parentStar) : Planet(planetInfo, std::move(parentStar))
 {
+    SetMaterial(NoMaterialFlags, 0.0f);
     Translate(_parentStar->GetPosition() + glm::vec3(1350.f, 0.0f, 1737.0f)); // Init position for light space matrix
 }
 
@@ -20,18 +20,3 @@ void Jupiter::AdjustToParent(bool isRunTime) {
     Rotate(rotationAngle, glm::vec3(0.0f, 1.0f, 0.0f));
     UpdateModelMatrix();
 }
-
-void Jupiter::Render() const {
-    GetShader().SetBool("hasNightTexture", false);
-    GetShader().SetBool("hasSpecularMap", false);
-    GetShader().SetBool("hasSpecular", false);
-    GetShader().SetBool("isUseSphereIntersect", false);
-    GetShader().SetInt("mainDiffuseTexture", 0);
-    GetShader().SetInt("normalMap", 1);
-    GetShader().SetFloat("ambientFactor", 0.0f);
-
-    glBindTextureUnit(0, _diffuses.at(0).GetTexture());
-    glBindTextureUnit(1, _normalMap.GetTexture());
-
-    SpaceObject::Render();
-}
@@ -6,11 +6,6 @@ class Jupiter : public Planet {
 public:
     explicit Jupiter(const PlanetInfo& planetInfo, std::shared_ptr<Star> parentStar);
     void AdjustToParent(bool isRunTime) override;
-    void Render() const override;
-
-private:
-    std::vector<TextureImage2D> _diffuses;
-    TextureImage2D _normalMap;
 };
 
 #endif //SOLARSYSTEM_JUPITER_H
@@ -1,8 +1,8 @@
 #include "Mercury.h"
 
-Mercury::Mercury(const PlanetInfo& planetInfo, std::shared_ptr<Star> parentStar) : Planet(planetInfo, std::move(parentStar)), _diffuses(planetInfo.diffuseTextures),
-    _normalMap(planetInfo.normalMap), _specular(planetInfo.specularTexture)
+Mercury::Mercury(const PlanetInfo& planetInfo, std::shared_ptr<Star> parentStar) : Planet(planetInfo, std::move(parentStar))
 {
+    SetMaterial(HasSpecularMap | HasSpecular, 0.0f);
     Translate(_parentStar->GetPosition() + glm::vec3(1500.f, 0.0f, 350.0f)); // Init position for light space matrix
 }
 
@@ -19,21 +19,3 @@ void Mercury::AdjustToParent(bool isRunTime) {
     Rotate(rotationAngle, glm::vec3(0.0f, 1.0f, 0.0f));
     UpdateModelMatrix();
 }
-
-void Mercury::Render() const {
-    GetShader().SetBool("hasNightTexture", false);
-    GetShader().SetBool("hasSpecularMap", true);
-    GetShader().SetBool("hasSpecular", true);
-    GetShader().SetBool("isUseSphereIntersect", false);
-    GetShader().SetInt("mainDiffuseTexture", 0);
-    GetShader().SetInt("normalMap", 1);
-    GetShader().SetInt("specularMap", 2);
-    GetShader().SetFloat("ambientFactor", 0.0f);
-
-    glBindTextureUnit(0, _diffuses.at(0).GetTexture());
-    glBindTextureUnit(1, _normalMap.GetTexture());
-    glBindTextureUnit(2, _specular.GetTexture());
-
-    SpaceObject::Render();
-}
-
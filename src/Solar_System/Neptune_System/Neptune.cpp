@@ -1,8 +1,9 @@
 #include "Neptune.h"
 
-Neptune::Neptune(const PlanetInfo& planetInfo, std::shared_ptr<Star> parentStar) : Planet(planetInfo, std::move(parentStar)), _diffuses(planetInfo.diffuseTextures),
-    _normalMap(planetInfo.normalMap)
+Neptune::Neptune(const PlanetInfo& planetInfo, std::shared_ptr<Star> parentStar) : Planet(planetInfo, std::move(parentStar))
 {
+    _materialTextures[CloudSlot] = planetInfo.diffuseTextures.at(1);
+    SetMaterial(HasClouds, 0.0f);
     Translate(_parentStar->GetPosition() + glm::vec3(-2900.0f, 0.0f, 0.0f)); // Init position for light space matrix
 }
 
@@ -20,23 +21,3 @@ void Neptune::AdjustToParent(bool isRunTime) {
     Rotate(rotationAngle, glm::vec3(0.0f, 1.0f, 0.0f));
     UpdateModelMatrix();
 }
-
-void Neptune::Render() const {
-    GetShader().SetBool("hasNightTexture", false);
-    GetShader().SetBool("hasSpecularMap", false);
-    GetShader().SetBool("hasSpecular", false);
-    GetShader().SetBool("hasClouds", true);
-    GetShader().SetBool("isUseSphereIntersect", false);
-    GetShader().SetInt("mainDiffuseTexture", 0);
-    GetShader().SetInt("cloudTexture", 1);
-    GetShader().SetInt("normalMap", 2);
-    GetShader().SetFloat("ambientFactor", 0.0f);
-
-    glBindTextureUnit(0, _diffuses.at(0).GetTexture());
-    glBindTextureUnit(1, _diffuses.at(1).GetTexture());
-    glBindTextureUnit(2, _normalMap.GetTexture());
-
-    SpaceObject::Render();
-
-    GetShader().SetBool("hasClouds", false);
-}
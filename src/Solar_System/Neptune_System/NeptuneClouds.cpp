@@ -2,6 +2,7 @@
 
 NeptuneClouds::NeptuneClouds(const CloudsInfo& cloudsInfo, std::shared_ptr<SpaceObject> parent) : Clouds(cloudsInfo, std::move(parent))
 {
+    SetMaterial(NoMaterialFlags, 0.0f);
 }
 
 void NeptuneClouds::AdjustToParent(bool isRunTime) {
@@ -18,14 +19,3 @@ void NeptuneClouds::AdjustToParent(bool isRunTime) {
     Rotate(rotationAngle, glm::vec3(0.0f, 1.0f, 0.0f));
     UpdateModelMatrix();
 }
-
-void NeptuneClouds::Render() const {
-    GetShader().SetFloat("ambientFactor", 0.0);
-    GetShader().SetInt("mainDiffuseTexture", 0);
-    GetShader().SetInt("cloudsNormalMap", 1);
-
-    glBindTextureUnit(0, _diffuse.GetTexture());
-    glBindTextureUnit(1, _normal.GetTexture());
-
-    SpaceObject::Render();
-}
@@ -7,7 +7,6 @@ class NeptuneClouds : public Clouds {
 public:
     explicit NeptuneClouds(const CloudsInfo& cloudsInfo, std::shared_ptr<SpaceObject> parent);
     void AdjustToParent(bool isRunTime) override;
-    void Render() const override;
 };
 
 #endif //SOLARSYSTEM_NEPTUNECLOUDS_H
@@ -8,3 +8,7 @@ OuterShell::OuterShell(MeshHolder model, const Shader& shader, std::shared_ptr<S
 std::shared_ptr<SpaceObject> OuterShell::GetParent() const {
     return _parent;
 }
+
+float OuterShell::GetRadius() const {
+    return 2.0f * _scaleFactor; // 2 is a radius of the earth 3d model in Blender
+}
@@ -8,6 +8,7 @@ public:
     explicit OuterShell(MeshHolder model, const Shader& shader, std::shared_ptr<SpaceObject> parent, float earthScaleFactor);
     virtual void AdjustToParent(bool isRunTime) = 0;
     std::shared_ptr<SpaceObject> GetParent() const;
+    float GetRadius() const;
 
 protected:
     std::shared_ptr<SpaceObject> _parent;
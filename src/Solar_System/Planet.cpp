@@ -2,9 +2,15 @@
 
 Planet::Planet(const PlanetInfo& planetInfo, std::shared_ptr<Star> parentStar) :
     SpaceObject(planetInfo.planetModel, planetInfo.planetShader, planetInfo.engName, planetInfo.otherLangName), _parentStar(std::move(parentStar)),
-    _earthSizeCoefficient(planetInfo.earthSizeCoefficient)
+    _earthSizeCoefficient(planetInfo.earthSizeCoefficient), _surfaceTextures(planetInfo.diffuseTextures)
 {
     _radius *= _earthSizeCoefficient;
+    _materialTextures[DiffuseSlot] = planetInfo.diffuseTextures.at(0);
+    _materialTextures[NormalSlot] = planetInfo.normalMap;
+    _materialTextures[SpecularSlot] = planetInfo.specularTexture;
+    _surfaceTextures.push_back(planetInfo.normalMap);
+    if (planetInfo.specularTexture.GetTexture() != 0)
+        _surfaceTextures.push_back(planetInfo.specularTexture);
 }
 
 float Planet::GetRadius() const {
@@ -15,3 +21,6 @@ float Planet::GetEarthSizeCoefficient() const {
     return _earthSizeCoefficient;
 }
 
+const std::vector<TextureImage2D>& Planet::GetSurfaceTextures() const {
+    return _surfaceTextures;
+}
@@ -28,11 +28,13 @@ public:
     virtual void AdjustToParent(bool isRunTime) = 0;
     float GetRadius() const;
     float GetEarthSizeCoefficient() const;
+    const std::vector<TextureImage2D>& GetSurfaceTextures() const; // Diffuse, normal and specular maps
 
 protected:
     std::shared_ptr<Star> _parentStar;
     float _radius = 2.0; // Radius of the earth 3d model in Blender
     float _earthSizeCoefficient;
+    std::vector<TextureImage2D> _surfaceTextures;
 };
 
 #endif //SOLARSYSTEM_PLANET_H
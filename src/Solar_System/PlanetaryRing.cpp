@@ -14,6 +14,10 @@ GLuint PlanetaryRing::GetRingTexture() const {
     return _ringTexture.GetTexture();
 }
 
+std::vector<TextureImage2D> PlanetaryRing::GetTextures() const {
+    return {_ringTexture};
+}
+
 glm::vec3 PlanetaryRing::GetRingNormal() const {
     return _ringNormal;
 }
@@ -22,6 +22,7 @@ public:
     float GetOuterRadius() const;
     glm::vec3 GetRingNormal() const;
     GLuint GetRingTexture() const;
+    std::vector<TextureImage2D> GetTextures() const;
 
 protected:
     TextureImage2D _ringTexture;
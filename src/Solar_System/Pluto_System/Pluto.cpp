@@ -1,8 +1,8 @@
 #include "Pluto.h"
 
-Pluto::Pluto(const PlanetInfo& planetInfo, std::shared_ptr<Star> parentStar) : Planet(planetInfo, std::move(parentStar)), _diffuses(planetInfo.diffuseTextures),
-    _normalMap(planetInfo.normalMap), _specular(planetInfo.specularTexture)
+Pluto::Pluto(const PlanetInfo& planetInfo, std::shared_ptr<Star> parentStar) : Planet(planetInfo, std::move(parentStar))
 {
+    SetMaterial(HasSpecularMap | HasSpecular, 0.0f);
     Translate(_parentStar->GetPosition() + glm::vec3(2800.0f, 0.0f, 1757.73f)); // Init position for light space matrix
 }
 
@@ -19,20 +19,3 @@ void Pluto::AdjustToParent(bool isRunTime) {
     Rotate(rotationAngle, glm::vec3(0.0f, 1.0f, 0.0f));
     UpdateModelMatrix();
 }
-
-void Pluto::Render() const {
-    GetShader().SetBool("hasNightTexture", false);
-    GetShader().SetBool("hasSpecularMap", true);
-    GetShader().SetBool("hasSpecular", true);
-    GetShader().SetBool("isUseSphereIntersect", false);
-    GetShader().SetInt("mainDiffuseTexture", 0);
-    GetShader().SetInt("normalMap", 1);
-    GetShader().SetInt("specularMap", 2);
-    GetShader().SetFloat("ambientFactor", 0.0f);
-
-    glBindTextureUnit(0, _diffuses.at(0).GetTexture());
-    glBindTextureUnit(1, _normalMap.GetTexture());
-    glBindTextureUnit(2, _specular.GetTexture());
-
-    SpaceObject::Render();
-}
@@ -2,9 +2,15 @@
 
 Satellite::Satellite(const SatelliteInfo& satelliteInfo, std::shared_ptr<SpaceObject> parent) :
     SpaceObject(satelliteInfo.satelliteModel, satelliteInfo.satelliteShader, satelliteInfo.engName, satelliteInfo.otherLangName), _parent(std::move(parent)),
-    _earthSizeCoefficient(satelliteInfo.earthSizeCoefficient)
+    _earthSizeCoefficient(satelliteInfo.earthSizeCoefficient), _surfaceTextures(satelliteInfo.diffuseTextures)
 {
     _radius *= _earthSizeCoefficient;
+    _materialTextures[DiffuseSlot] = satelliteInfo.diffuseTextures.at(0);
+    _materialTextures[NormalSlot] = satelliteInfo.normalMap;
+    _materialTextures[SpecularSlot] = satelliteInfo.specularTexture;
+    _surfaceTextures.push_back(satelliteInfo.normalMap);
+    if (satelliteInfo.specularTexture.GetTexture() != 0)
+        _surfaceTextures.push_back(satelliteInfo.specularTexture);
 }
 
 std::shared_ptr<SpaceObject> Satellite::GetParent() const {
@@ -18,3 +24,7 @@ float Satellite::GetRadius() const {
 float Satellite::GetEarthSizeCoefficient() const {
     return _earthSizeCoefficient;
 }
+
+const std::vector<TextureImage2D>& Satellite::GetSurfaceTextures() const {
+    return _surfaceTextures;
+}
@@ -29,12 +29,14 @@ public:
     std::shared_ptr<SpaceObject> GetParent() const;
     float GetRadius() const;
     float GetEarthSizeCoefficient() const;
+    const std::vector<TextureImage2D>& GetSurfaceTextures() const; // Diffuse, normal and specular maps
     virtual void AdjustToParent(bool isRunTime) = 0;
 
 protected:
     std::shared_ptr<SpaceObject> _parent;
     float _radius = 2.0; // Radius of the earth 3d model in Blender
     float _earthSizeCoefficient;
+    std::vector<TextureImage2D> _surfaceTextures;
 };
 
 #endif //SOLARSYSTEM_SATELLITE_H
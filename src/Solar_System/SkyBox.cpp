@@ -1,4 +1,6 @@
 #include "SkyBox.h"
+#include "../Auxiliary_Modules/StartupProfiler.h"
+#include "../Auxiliary_Modules/RenderStateCache.h"
 
 SkyBox::SkyBox(const std::vector<std::string>& faces) {
     InitBuffers();
@@ -6,7 +8,7 @@ SkyBox::SkyBox(const std::vector<std::string>& faces) {
 }
 
 void SkyBox::Render(const Shader& shader) const {
-    glDepthFunc(GL_LEQUAL);
+    RenderStateCache::Instance().SetDepthFunc(GL_LEQUAL);
 
     shader.Use();
     shader.SetInt("skybox", 0);
@@ -18,7 +20,7 @@ void SkyBox::Render(const Shader& shader) const {
     glDrawArrays(GL_TRIANGLES, 0, 36);
     glBindVertexArray(0);
 
-    glDepthFunc(GL_LESS);
+    RenderStateCache::Instance().SetDepthFunc(GL_LESS);
 }
 
 void SkyBox::LoadCubeMap(const std::vector<std::string>& faces) {
@@ -27,10 +29,11 @@ void SkyBox::LoadCubeMap(const std::vector<std::string>& faces) {
 
     for (size_t i = 0; i < faces.size(); i++) {
         try {
-            CDDSImage image;
+            ProfileScope profileScope("texture", faces[i]);
+            const DDSImage image(faces[i]);
             GLenum target = GL_TEXTURE_CUBE_MAP_POSITIVE_X + i;
-            image.load(faces[i], false);
-            image.upload_texture2D(0, target);
+            image.Upload2D(target);
+            profileScope.SetGpuBytes(image.GetPayloadSize());
             std::cout << faces[i] << " Loaded" << std::endl;
         }
         catch (const std::runtime_error& error) {
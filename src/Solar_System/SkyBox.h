@@ -1,11 +1,10 @@
 #ifndef SOLARSYSTEM_SKYBOX_H
 #define SOLARSYSTEM_SKYBOX_H
 #include "../Auxiliary_Modules/Shader.h"
-#include "../../src/3rdparty//nv_dds.h"
+#include "../Auxiliary_Modules/DDSImage.h"
+#include <iostream>
 #include <vector>
 
-using namespace nv_dds;
-
 class SkyBox {
 public:
     explicit SkyBox(const std::vector<std::string>& faces);
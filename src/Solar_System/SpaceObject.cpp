@@ -6,13 +6,38 @@ SpaceObject::SpaceObject(MeshHolder model, const Shader& shader, std::wstring en
 }
 
 void SpaceObject::Render() const {
-    _objectModel.Draw(_shader);
+    RenderModel(_objectModel);
 }
 
-MeshHolder SpaceObject::GetModel() const {
+void SpaceObject::RenderModel(const MeshHolder& model) const {
+    if (_hasMaterial) {
+        std::array<GLuint, MATERIAL_TEXTURE_SLOTS_COUNT> textures {};
+        for (size_t slot = 0; slot < textures.size(); slot++)
+            textures[slot] = _materialTextures[slot].GetTexture();
+
+        glBindTextures(0, static_cast<GLsizei>(textures.size()), textures.data()); // Missing textures unbind their units
+    }
+
+    model.Draw(_shader, _materialIndex);
+}
+
+void SpaceObject::SetMaterial(uint32_t flags, float ambientFactor) {
+    _materialIndex = MaterialTable::Instance().Register(flags, ambientFactor);
+    _hasMaterial = true;
+}
+
+const MeshHolder& SpaceObject::GetModel() const {
     return _objectModel;
 }
 
+const TextureImage2D& SpaceObject::GetMaterialTexture(MaterialTextureSlot slot) const {
+    return _materialTextures[slot];
+}
+
+uint32_t SpaceObject::GetMaterialIndex() const {
+    return _materialIndex;
+}
+
 const std::wstring& SpaceObject::GetEngName() const {
     return _engName;
 }
@@ -1,13 +1,19 @@
 #ifndef SOLARSYSTEM_SPACEOBJECT_H
 #define SOLARSYSTEM_SPACEOBJECT_H
 #include "../Auxiliary_Modules/MeshHolder.h"
+#include "../Auxiliary_Modules/MaterialTable.h"
+#include "../Auxiliary_Modules/TextureImage2D.h"
 #include "Transformable.h"
+#include <array>
 
 class SpaceObject : public Transformable {
 public:
     explicit SpaceObject(MeshHolder model, const Shader& shader, std::wstring engName = L"", std::wstring otherLangName = L"");
     virtual void Render() const;
-    MeshHolder GetModel() const;
+    void RenderModel(const MeshHolder& model) const; // With another model of the same shape, e.g. a level of SphereLodChain
+    const MeshHolder& GetModel() const;
+    const TextureImage2D& GetMaterialTexture(MaterialTextureSlot slot) const;
+    uint32_t GetMaterialIndex() const;
     const std::wstring& GetEngName() const;
     const std::wstring& GetOtherLangName() const;
 
@@ -15,6 +21,13 @@ protected:
     MeshHolder _objectModel;
     std::wstring _engName, _otherLangName;
     glm::mat4 _lightSpaceMatrix = glm::mat4(1.0);
+    std::array<TextureImage2D, MATERIAL_TEXTURE_SLOTS_COUNT> _materialTextures; // Render binds them to the units of their slots
+
+    void SetMaterial(uint32_t flags, float ambientFactor); // For bodies drawn with the planet and clouds shaders
+
+private:
+    uint32_t _materialIndex = 0;
+    bool _hasMaterial = false;
 };
 
 #endif //SOLARSYSTEM_SPACEOBJECT_H
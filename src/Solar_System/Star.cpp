@@ -5,13 +5,11 @@ Star::Star(const StarInfo& starInfo) : SpaceObject(starInfo.starModel, starInfo.
     _glowTintMult(starInfo.glowTintMult)
 {
     InitBuffers();
-    _starOcclusion.fill(0);
     _starTemperatureColorUCoordinate = glm::clamp((_starTemperature - 800.0f) / 29200.f, 0.0f, 1.0f);
     CalculateShiftColor();
 }
 
-void Star::RenderGlow(const glm::mat4& projection, const glm::mat4& view, const glm::vec3& vs, float aspect, float distance,
-                      const std::optional<RingCameraInfo>& ringCameraInfo, float starTemperature)
+void Star::RenderGlow(const glm::vec3& vs, float aspect, float distance, const std::optional<RingCameraInfo>& ringCameraInfo, float starTemperature)
 {
     if (starTemperature != _starTemperature) {
         _starTemperature = starTemperature;
@@ -25,8 +23,6 @@ void Star::RenderGlow(const glm::mat4& projection, const glm::mat4& view, const
     const glm::vec2 glowDimensions(_currentGlowSize, _currentGlowSize * aspect);
 
     _glowShader.Use();
-    _glowShader.SetMat4("projection", projection);
-    _glowShader.SetMat4("view", view);
     _glowShader.SetVec3("center", GetPosition());
     _glowShader.SetVec3("colorMult", _glowTintMult);
     _glowShader.SetVec2("dims", glowDimensions * 0.5f);
@@ -36,9 +32,15 @@ void Star::RenderGlow(const glm::mat4& projection, const glm::mat4& view, const
     _glowShader.SetInt("ringDiffuse", 1);
     glBindTextureUnit(0, _starSpectrumTexture.GetTexture());
 
+    _glowShader.SetBool("isBakedNoise", _noiseVolume != nullptr);
+    if (_noiseVolume) {
+        _glowShader.SetInt("noiseVolume", 2);
+        _glowShader.SetFloat("noisePeriod", _noiseVolume->GetPeriod());
+        glBindTextureUnit(2, _noiseVolume->GetTexture());
+    }
+
     _glowShader.SetBool("isPlanetaryRingInView", ringCameraInfo.has_value());
     if (ringCameraInfo) {
-        _glowShader.SetVec3("cameraPosition", ringCameraInfo->cameraPosition);
         _glowShader.SetVec3("ringCenter", ringCameraInfo->ringCenter);
         _glowShader.SetVec3("ringNormal", ringCameraInfo->ringNormal);
         _glowShader.SetVec2("ringInnerOuterRadiuses", ringCameraInfo->ringInnerOuterRadiuses);
@@ -50,10 +52,25 @@ void Star::RenderGlow(const glm::mat4& projection, const glm::mat4& view, const
     glBindVertexArray(0);
 }
 
+void Star::RenderOcclusionProxy(const Shader& shader, float radius) const {
+    shader.Use();
+    shader.SetVec3("center", GetPosition());
+    shader.SetFloat("radius", radius);
+    shader.SetInt("segments", OCCLUSION_PROXY_SEGMENTS);
+
+    glBindVertexArray(_proxyVao);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, OCCLUSION_PROXY_SEGMENTS + 2); // The center and the closing vertex
+    glBindVertexArray(0);
+}
+
 void Star::SetVisibility(float visibility) {
     _visibility = visibility;
 }
 
+void Star::SetNoiseVolume(const NoiseVolume* noiseVolume) {
+    _noiseVolume = noiseVolume;
+}
+
 float Star::GetStarTemperatureInKelvin() const {
     return _starTemperature;
 }
@@ -86,14 +103,6 @@ glm::vec3 Star::GetGlowTintMult() const {
     return _glowTintMult;
 }
 
-GLuint& Star::GetStarOcclusionValue(size_t index) {
-    return _starOcclusion.at(index);
-}
-
-std::array<GLuint, 2>& Star::GetStarOcclusion() {
-    return _starOcclusion;
-}
-
 void Star::CalculateShiftColor() {
     _starShiftColor = glm::vec3(_starTemperature * (0.0534 / 255.0) - (43.0 / 255.0),
                                 _starTemperature * (0.0628 / 255.0) - (77.0 / 255.0),
@@ -139,4 +148,6 @@ void Star::InitBuffers() {
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
 
     glBindVertexArray(0);
+
+    glGenVertexArrays(1, &_proxyVao);
 }
@@ -2,6 +2,7 @@
 #define SOLARSYSTEM_STAR_H
 #include "SpaceObject.h"
 #include "../Auxiliary_Modules/TextureImage2D.h"
+#include "../Auxiliary_Modules/NoiseVolume.h"
 #include <vector>
 #include <optional>
 
@@ -24,7 +25,6 @@ struct StarInfo {
 };
 
 struct RingCameraInfo {
-    glm::vec3 cameraPosition;
     glm::vec3 ringCenter; // Center of disk in eye space
     glm::vec3 ringNormal; // Disk plane normal in eye space
     glm::vec2 ringInnerOuterRadiuses; // x = Inner, y = Outer
@@ -35,9 +35,10 @@ class Star : public SpaceObject {
 public:
     explicit Star(const StarInfo& starInfo);
     virtual void TakeStarSystemCenter() = 0;
-    void RenderGlow(const glm::mat4& projection, const glm::mat4& view, const glm::vec3& vs, float aspect, float distance,
-                    const std::optional<RingCameraInfo>& ringCameraInfo, float starTemperature = 5778.0f);
+    void RenderGlow(const glm::vec3& vs, float aspect, float distance, const std::optional<RingCameraInfo>& ringCameraInfo, float starTemperature = 5778.0f);
+    void RenderOcclusionProxy(const Shader& shader, float radius) const; // A flat disc over the silhouette, see starOcclusionProxy.vs
     void SetVisibility(float visibility);
+    void SetNoiseVolume(const NoiseVolume* noiseVolume); // The glow samples it instead of evaluating simplex noise, null for the procedural noise
     float GetStarTemperatureInKelvin() const;
     float GetStarRadius() const;
     float GetTemperatureColorUCoordinate() const;
@@ -46,8 +47,6 @@ public:
     GLuint GetStarSpectrumTexture() const;
     glm::vec3 GetShiftColor() const;
     glm::vec3 GetGlowTintMult() const;
-    GLuint& GetStarOcclusionValue(size_t index);
-    std::array<GLuint, 2>& GetStarOcclusion();
 
 private:
     float _starTemperature;
@@ -57,10 +56,13 @@ private:
     float _currentGlowSize = 0.0;
     glm::vec3 _starShiftColor = glm::vec3(), _glowTintMult;
     TextureImage2D _starSpectrumTexture;
-    std::array<GLuint, 2> _starOcclusion;
     GLuint _glowVao = 0, _glowVbo = 0, _glowEbo = 0;
     GLuint _coronaVao = 0, _coronaVbo = 0, _coronaEbo = 0;
+    GLuint _proxyVao = 0; // Empty, the disc is built from gl_VertexID
     Shader _glowShader;
+    const NoiseVolume* _noiseVolume = nullptr;
+
+    static constexpr int OCCLUSION_PROXY_SEGMENTS = 24;
 
     void InitBuffers();
     void CalculateShiftColor();
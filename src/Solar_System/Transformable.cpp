@@ -36,6 +36,10 @@ Shader Transformable::GetShader() const {
     return _shader;
 }
 
+const glm::mat4& Transformable::GetModelMatrix() const {
+    return _matrixModel;
+}
+
 glm::mat4 Transformable::GetRotationMatrix() const {
     return _rotationMatrix;
 }
@@ -14,6 +14,7 @@ public:
     void UpdateModelMatrix();
     void SetShader(const Shader& shader);
     Shader GetShader() const;
+    const glm::mat4& GetModelMatrix() const;
     glm::mat4 GetRotationMatrix() const;
     glm::vec3 GetPosition() const;
     float GetLastRotationAngle() const;
@@ -2,6 +2,7 @@
 
 UranusClouds::UranusClouds(const CloudsInfo& cloudsInfo, std::shared_ptr<SpaceObject> parent) : Clouds(cloudsInfo, std::move(parent))
 {
+    SetMaterial(NoMaterialFlags, 0.0f);
 }
 
 void UranusClouds::AdjustToParent(bool isRunTime) {
@@ -20,14 +21,3 @@ void UranusClouds::AdjustToParent(bool isRunTime) {
     //Rotate(-23.4f, glm::vec3(0, 0, 1));
     UpdateModelMatrix();
 }
-
-void UranusClouds::Render() const {
-    GetShader().SetFloat("ambientFactor", 0.0);
-    GetShader().SetInt("mainDiffuseTexture", 0);
-    GetShader().SetInt("cloudsNormalMap", 1);
-
-    glBindTextureUnit(0, _diffuse.GetTexture());
-    glBindTextureUnit(1, _normal.GetTexture());
-
-    SpaceObject::Render();
-}
@@ -14,6 +14,7 @@
 #include <irrKlang.h>
 using namespace irrklang;
 
+#include <functional>
 #include <memory>
 
 #endif //SOLARSYSTEM_SYSTEMMODULES_H
@@ -0,0 +1,70 @@
+// Packs the resources read by the loaders into one archive, which VirtualFileSystem mounts at startup. Usage:
+//   AssetBaker [resource directory] [archive path]   by default ../resource and resource.pak
+// Sounds and icons stay loose files, irrKlang streams music from disk and SDL_image reads the icon by path.
+// Models are packed as blobs cooked by MeshCooker, the .obj files only when there is no up-to-date blob
+#include "../Auxiliary_Modules/AssetArchive.h"
+#include "../Auxiliary_Modules/CookedMesh.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace {
+    const vector<string> packedDirectories = {"shaders", "fonts", "models", "textures"};
+
+    bool IsPacked(const filesystem::path& path) {
+        const string extension = path.extension().string();
+        if (extension == ".obj")
+            return !CookedMesh::IsUpToDate(CookedMesh::MakeCookedPath(path.generic_string()), path.generic_string());
+
+        return extension != ".mtl";
+    }
+
+    // The archive places the entries by their codec, so the files only keep a stable order between bakes
+    vector<pair<string, string>> CollectFiles(const filesystem::path& resourceDirectory) {
+        vector<pair<string, string>> files;
+
+        for (const auto& directory : packedDirectories) {
+            vector<filesystem::path> paths;
+            for (const auto& entry : filesystem::recursive_directory_iterator(resourceDirectory / directory)) {
+                if (entry.is_regular_file() && IsPacked(entry.path()))
+                    paths.push_back(entry.path());
+            }
+            sort(paths.begin(), paths.end());
+
+            for (const auto& path : paths)
+                files.emplace_back(path.lexically_relative(resourceDirectory).generic_string(), path.generic_string());
+        }
+
+        return files;
+    }
+}
+
+int main(int argc, char** argv) {
+    const filesystem::path resourceDirectory = argc > 1 ? argv[1] : "../resource";
+    const string archivePath = argc > 2 ? argv[2] : "resource.pak";
+
+    try {
+        const auto startPoint = steady_clock::now();
+        const auto files = CollectFiles(resourceDirectory);
+        AssetArchive::Bake(archivePath, files);
+
+        size_t filesSize = 0;
+        for (const auto& [virtualPath, diskPath] : files)
+            filesSize += filesystem::file_size(diskPath);
+
+        constexpr double bytesInMegabyte = 1024.0 * 1024.0;
+        cout << fixed << setprecision(2) << files.size() << " files (" << filesSize / bytesInMegabyte << " MB) -> " << archivePath << " ("
+             << filesystem::file_size(archivePath) / bytesInMegabyte << " MB) in " << duration<double>(steady_clock::now() - startPoint).count() << " s" << endl;
+    }
+    catch (const exception& err) {
+        cerr << err.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
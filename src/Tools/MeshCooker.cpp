@@ -0,0 +1,114 @@
+// Offline cook step for models: converts each model file into a binary blob next to it (e.g. phobos.obj -> phobos.mesh),
+// which MeshRegistry maps and uploads without Assimp. Usage:
+//   MeshCooker [model files...]              cooks the given files or every .obj in ../resource/models
+//   MeshCooker --benchmark [model files...]  compares loading through Assimp with loading of the cooked blobs
+#include "../Auxiliary_Modules/ModelImporter.h"
+#include "../Auxiliary_Modules/CookedMesh.h"
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace {
+    constexpr int benchmarkIterations = 5;
+    constexpr double bytesInKilobyte = 1024.0;
+
+    vector<string> FindModels() {
+        vector<string> paths;
+        for (const auto& entry : filesystem::directory_iterator("../resource/models")) {
+            if (entry.path().extension() == ".obj")
+                paths.push_back(entry.path().generic_string());
+        }
+
+        return paths;
+    }
+
+    void Cook(const string& path) {
+        const auto startPoint = steady_clock::now();
+        const vector<MeshData> meshes = ModelImporter::Import(path);
+        const string cookedPath = CookedMesh::MakeCookedPath(path);
+        const auto modelStamp = FileStamp::Of(path);
+        if (!modelStamp)
+            throw runtime_error("Cannot read " + path);
+        CookedMesh::Write(cookedPath, meshes, *modelStamp);
+
+        cout << fixed << setprecision(2) << path << " -> " << cookedPath << " (" << meshes.size() << " meshes, "
+             << filesystem::file_size(cookedPath) / bytesInKilobyte << " KB, " << duration<double, milli>(steady_clock::now() - startPoint).count()
+             << " ms)" << endl;
+    }
+
+    // Reads every vertex and index, like the upload does, so that the mapped pages are actually loaded
+    uint64_t TouchCookedMesh(const CookedMesh& cookedMesh) {
+        uint64_t checksum = 0;
+        for (const auto& meshView : cookedMesh.GetMeshes()) {
+            for (uint32_t i = 0; i < meshView.verticesCount; i++)
+                checksum += static_cast<uint64_t>(meshView.vertices[i].position.x * 1000.0f);
+            for (uint32_t i = 0; i < meshView.indicesCount; i++)
+                checksum += meshView.indices[i];
+        }
+
+        return checksum;
+    }
+
+    void Benchmark(const string& path) {
+        const string cookedPath = CookedMesh::MakeCookedPath(path);
+        if (!CookedMesh::IsUpToDate(cookedPath, path))
+            Cook(path);
+
+        double importTime = 0.0, cookedTime = 0.0;
+        uint64_t checksum = 0;
+
+        for (int i = 0; i < benchmarkIterations; i++) {
+            auto startPoint = steady_clock::now();
+            checksum += ModelImporter::Import(path).size();
+            importTime += duration<double, milli>(steady_clock::now() - startPoint).count();
+
+            startPoint = steady_clock::now();
+            const CookedMesh cookedMesh(cookedPath);
+            checksum += TouchCookedMesh(cookedMesh);
+            cookedTime += duration<double, milli>(steady_clock::now() - startPoint).count();
+        }
+
+        importTime /= benchmarkIterations;
+        cookedTime /= benchmarkIterations;
+
+        cout << fixed << setprecision(3) << path << " (" << filesystem::file_size(path) / bytesInKilobyte << " KB -> "
+             << filesystem::file_size(cookedPath) / bytesInKilobyte << " KB)\n"
+             << "  Assimp: " << importTime << " ms, cooked: " << cookedTime << " ms, speedup x" << (cookedTime > 0.0 ? importTime / cookedTime : 0.0)
+             << " (checksum " << checksum << ")" << endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    bool isBenchmark = false;
+    vector<string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        const string argument = argv[i];
+        if (argument == "--benchmark")
+            isBenchmark = true;
+        else
+            paths.push_back(argument);
+    }
+
+    try {
+        if (paths.empty())
+            paths = FindModels();
+
+        for (const auto& path : paths) {
+            if (isBenchmark)
+                Benchmark(path);
+            else
+                Cook(path);
+        }
+    }
+    catch (const exception& err) {
+        cerr << err.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}